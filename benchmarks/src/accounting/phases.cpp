@@ -0,0 +1,40 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <accounting.hpp>
+#include <codegen.hpp>
+
+#include <llvm/Support/raw_ostream.h>
+
+using namespace aatbe;
+using namespace aatbe::bench;
+
+// What counting costs when compiling a module, with `-fmem-report` (on) and
+// without (off), and the report of the largest. Linked with interpose.cpp
+// like the driver; compile/off of bench_timing_scope, the same module
+// without it, is the cost of its headers.
+int main() {
+  for (size_t count : {5000, 20000}) {
+    auto source = GenerateModule(count);
+    for (auto on : {false, true}) {
+      Measure("compile/functions=" + std::to_string(count) + "/" +
+                  (on ? "on" : "off"),
+              3, count, [&] {
+                if (on)
+                  accounting::Start();
+                codegen::CompilationSession session("bench");
+                if (!session.AnalyzeSource(source))
+                  abort();
+                DoNotOptimize(session.Codegen(codegen::OptLevel::O1));
+                accounting::Stop();
+              });
+    }
+  }
+
+  fflush(stdout);
+  accounting::Report(llvm::outs());
+  return 0;
+}
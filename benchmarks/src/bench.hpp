@@ -0,0 +1,54 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace aatbe::bench {
+
+// Keeps the optimizer from discarding a value that is only computed to be
+// measured.
+template <typename T> inline void DoNotOptimize(T const &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs `body` once to warm up, then `iterations` times, and prints the
+// average time per iteration together with the derived rate.
+template <typename F>
+double Measure(const std::string &name, size_t iterations, size_t items,
+               F body) {
+  body();
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++)
+    body();
+  auto end = std::chrono::steady_clock::now();
+
+  auto seconds = std::chrono::duration<double>(end - start).count();
+  auto perIteration = seconds / (double)iterations;
+
+  printf("%-40s %12.3f ms/iter %14.0f items/s\n", name.c_str(),
+         perIteration * 1e3, (double)items / perIteration);
+
+  return perIteration;
+}
+
+// A module of `count` functions where every function does some arithmetic,
+// binds locals and calls the previous one, so inference has to thread
+// literal and local types through calls.
+inline std::string GenerateModule(size_t count) {
+  std::string source = "fn f0 (a: int64, b: uint32) -> int64 = a\n";
+  for (size_t i = 1; i < count; i++) {
+    auto n = std::to_string(i);
+    source += "fn f" + n + " (a: int64, b: uint32) -> int64 = { val x = a + " +
+              n + "; val y = b * 2; if y > 3 then x else f" +
+              std::to_string(i - 1) + "(x - 1, y) }\n";
+  }
+  return source;
+}
+
+} // namespace aatbe::bench
@@ -0,0 +1,87 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen/batch.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <thread>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+
+// A project of `count` files of a few functions each, every file calling
+// into the previous one.
+static std::vector<std::string> GenerateProject(const std::string &directory,
+                                                size_t count) {
+  std::vector<std::string> files;
+  for (size_t i = 0; i < count; i++) {
+    auto n = std::to_string(i);
+    std::string source;
+    if (i > 0)
+      source += "fn g" + std::to_string(i - 1) + " (a: int64) -> int64\n";
+    for (size_t j = 0; j < 8; j++) {
+      auto f = "f" + n + "_" + std::to_string(j);
+      source += "fn " + f + " (a: int64, b: uint32) -> int64 = { val x = a + " +
+                std::to_string(j) + "; val y = b * 2; if y > 3 then x else " +
+                (j ? "f" + n + "_" + std::to_string(j - 1) + "(x - 1, y)"
+                   : std::string("x")) +
+                " }\n";
+    }
+    source += "fn g" + n + " (a: int64) -> int64 = f" + n + "_7(a, 1)" +
+              (i > 0 ? " + g" + std::to_string(i - 1) + "(a)" : "") + "\n";
+
+    files.push_back(directory + "/m" + n + ".aat");
+    std::error_code EC;
+    llvm::raw_fd_ostream(files.back(), EC) << source;
+    if (EC)
+      abort();
+  }
+  return files;
+}
+
+// `process/file` compiles every file on its own, with its own type system
+// and target machine, as one `lang build` process per file does once it
+// has started. `batch/jobs=N` is `lang build -c -j N` over the project.
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  const size_t count = 1000;
+
+  llvm::SmallString<128> directory;
+  if (llvm::sys::fs::createUniqueDirectory("aatbe-bench", directory))
+    abort();
+  auto files = GenerateProject(directory.str().str(), count);
+  std::vector<std::string> objects;
+  for (auto &file : files)
+    objects.push_back(file + ".o");
+
+  printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+
+  BatchOptions options;
+  options.Level = OptLevel::O2;
+  auto single = Measure("process/file", 1, count, [&] {
+    for (size_t i = 0; i < count; i++)
+      DoNotOptimize(llvm::cantFail(BatchCompile({files[i]}, {objects[i]},
+                                                options)));
+  });
+
+  for (unsigned jobs : {1, 2, 4, 8, 16, 32}) {
+    options.Jobs = jobs;
+    auto seconds = Measure("batch/jobs=" + std::to_string(jobs), 1, count,
+                           [&] {
+                             DoNotOptimize(llvm::cantFail(
+                                 BatchCompile(files, objects, options)));
+                           });
+    printf("%-40s %12.2fx\n", "", single / seconds);
+  }
+
+  llvm::sys::fs::remove_directories(directory);
+  return 0;
+}
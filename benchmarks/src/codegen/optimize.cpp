@@ -0,0 +1,90 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+#include <jit.hpp>
+
+#include <llvm/Support/TargetSelect.h>
+
+#include <chrono>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+using namespace aatbe::jit;
+
+struct Program {
+  const char *name;
+  const char *source;
+  const char *entry;
+  uint64_t argument;
+};
+
+static const Program Programs[] = {
+    {"fib", R"(
+      fn fib (n: uint64) -> uint64 =
+        if n < 2 then n else fib(n - 1) + fib(n - 2)
+    )",
+     "fib", 32},
+    {"primes", R"(
+      fn prime_from (n: uint64, d: uint64) -> bool =
+        if d * d > n then true else if n % d == 0 then false
+        else prime_from(n, d + 1)
+      fn is_prime (n: uint64) -> bool = if n < 2 then false else prime_from(n, 2)
+      fn bit (b: bool) -> uint64 = if b then 1 else 0
+      fn primes (n: uint64) -> uint64 =
+        if n == 0 then 0 else primes(n - 1) + bit(is_prime(n))
+    )",
+     "primes", 50000},
+};
+
+static const std::pair<const char *, OptLevel> Levels[] = {
+    {"O0", OptLevel::O0}, {"O1", OptLevel::O1}, {"O2", OptLevel::O2},
+    {"O3", OptLevel::O3}, {"Os", OptLevel::Os},
+};
+
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  printf("%-20s %14s %14s %14s\n", "", "compile ms", "run ms", "result");
+
+  for (auto &program : Programs) {
+    for (auto &[levelName, level] : Levels) {
+      auto start = std::chrono::steady_clock::now();
+
+      CompilationSession session(program.name);
+      if (!session.AnalyzeSource(program.source))
+        return 1;
+
+      auto jit = llvm::cantFail(AatbeJit::Create({.Level = level}));
+      llvm::cantFail(jit->addModule(session.Codegen()));
+      auto entry = (uint64_t(*)(uint64_t))llvm::cantFail(
+                       jit->lookup(program.entry))
+                       .getAddress();
+
+      auto compiled = std::chrono::steady_clock::now();
+
+      uint64_t result = 0;
+      const size_t runs = 5;
+      for (size_t i = 0; i < runs; i++) {
+        result = entry(program.argument);
+        DoNotOptimize(result);
+      }
+
+      auto end = std::chrono::steady_clock::now();
+
+      auto name = std::string(program.name) + "/" + levelName;
+      printf("%-20s %14.3f %14.3f %14lu\n", name.c_str(),
+             std::chrono::duration<double>(compiled - start).count() * 1e3,
+             std::chrono::duration<double>(end - compiled).count() * 1e3 /
+                 (double)runs,
+             result);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,37 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+
+#include <thread>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+
+int main() {
+  const size_t count = 20000;
+
+  CompilationSession session("bench");
+  if (!session.AnalyzeSource(GenerateModule(count)))
+    return 1;
+
+  printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+
+  double serial = 0;
+  for (unsigned threads : {1, 2, 4, 8, 16, 32}) {
+    auto seconds = Measure(
+        "codegen/threads=" + std::to_string(threads), 3, count, [&] {
+          auto modules = session.CodegenParallel(threads);
+          DoNotOptimize(modules);
+        });
+
+    if (threads == 1)
+      serial = seconds;
+    printf("%-40s %12.2fx\n", "", serial / seconds);
+  }
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+#include <codegen/emit.hpp>
+#include <jit.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/TargetSelect.h>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+using namespace aatbe::jit;
+
+// Time from "run this program" to main returning: in the JIT that includes
+// analysis, codegen and JIT linking, an executable built ahead of time only
+// pays process startup.
+static const char *Source = R"(
+  fn fib (n: int32) -> int32 = if n < 2 then n else fib(n - 1) + fib(n - 2)
+  fn main (argc: int32, argv: ptr str) -> int32 = fib(20) - 6765
+)";
+
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  Measure("startup/jit", 20, 1, [] {
+    CompilationSession session("startup");
+    if (!session.AnalyzeSource(Source))
+      abort();
+
+    auto jit = llvm::cantFail(AatbeJit::Create({.Level = OptLevel::O2}));
+    llvm::cantFail(jit->addModule(session.Codegen()));
+    auto main = (int (*)(int, char **))llvm::cantFail(jit->lookup("main"))
+                    .getAddress();
+    if (main(0, nullptr) != 0)
+      abort();
+  });
+
+  std::string executable;
+  Measure("build/aot", 5, 1, [&] {
+    CompilationSession session("startup");
+    if (!session.AnalyzeSource(Source))
+      abort();
+
+    std::vector<llvm::orc::ThreadSafeModule> modules;
+    modules.push_back(session.Codegen(OptLevel::O2));
+    auto objects = llvm::cantFail(EmitObjects(modules, OptLevel::O2, "bench"));
+
+    llvm::SmallString<128> path;
+    if (llvm::sys::fs::createTemporaryFile("startup", "out", path))
+      abort();
+    if (!executable.empty())
+      llvm::sys::fs::remove(executable);
+    executable = path.str().str();
+
+    llvm::cantFail(LinkExecutable(objects, executable));
+    for (auto &object : objects)
+      llvm::sys::fs::remove(object);
+  });
+
+  Measure("startup/aot", 20, 1, [&] {
+    if (llvm::sys::ExecuteAndWait(executable, {executable}) != 0)
+      abort();
+  });
+
+  llvm::sys::fs::remove(executable);
+  return 0;
+}
@@ -0,0 +1,60 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <engine.hpp>
+
+#include <llvm/Support/TargetSelect.h>
+
+using namespace aatbe;
+using namespace aatbe::bench;
+
+// Calls a small function many times, the way a host application calls a
+// compiled snippet: through Engine's callable, through a raw function
+// pointer, and looking it up in the JIT on every call.
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  auto engine = llvm::cantFail(
+      Engine::Create({.Level = codegen::OptLevel::O2}));
+  llvm::cantFail(engine->compile("fn step (a: int64) -> int64 = a * 3 + 1"));
+  const size_t calls = 10000000;
+
+  auto step = llvm::cantFail(engine->get<int64_t(int64_t)>("step"));
+  Measure("engine/function", 5, calls, [&] {
+    int64_t value = 0;
+    for (size_t i = 0; i < calls; i++)
+      value = step(value);
+    DoNotOptimize(value);
+  });
+
+  auto raw = step.get();
+  Measure("engine/pointer", 5, calls, [&] {
+    int64_t value = 0;
+    for (size_t i = 0; i < calls; i++)
+      value = raw(value);
+    DoNotOptimize(value);
+  });
+
+  Measure("engine/get-per-call", 5, calls / 100, [&] {
+    int64_t value = 0;
+    for (size_t i = 0; i < calls / 100; i++)
+      value = llvm::cantFail(engine->get<int64_t(int64_t)>("step"))(value);
+    DoNotOptimize(value);
+  });
+
+  Measure("jit/lookup-per-call", 5, calls / 100, [&] {
+    int64_t value = 0;
+    for (size_t i = 0; i < calls / 100; i++)
+      value = ((int64_t(*)(int64_t))llvm::cantFail(
+                   engine->getJit().lookup("step"))
+                   .getAddress())(value);
+    DoNotOptimize(value);
+  });
+
+  return 0;
+}
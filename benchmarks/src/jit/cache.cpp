@@ -0,0 +1,75 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+#include <jit.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/TargetSelect.h>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+using namespace aatbe::jit;
+
+// Same module shape as the lazy benchmark, but main reaches every function.
+static std::string GenerateChain(size_t count) {
+  std::string source = "fn f0 (a: int64) -> int64 = a\n";
+  for (size_t i = 1; i < count; i++) {
+    auto n = std::to_string(i);
+    source += "fn f" + n + " (a: int64) -> int64 = { val x = a + " + n +
+              "; if x > 3 then f" + std::to_string(i - 1) +
+              "(x - 4) else x }\n";
+  }
+  source += "fn main (argc: int32, argv: ptr str) -> int64 = f" +
+            std::to_string(count - 1) + "(5)\n";
+  return source;
+}
+
+// Time to main returning, from source. A warm start still analyzes the
+// source and emits IR, but skips the optimizer and machine codegen.
+static void RunMain(const std::string &source, const std::string &cacheDir,
+                    size_t expectedHits) {
+  CompilationSession session("cache");
+  if (!session.AnalyzeSource(source))
+    abort();
+
+  auto jit = llvm::cantFail(
+      AatbeJit::Create({.Level = OptLevel::O2, .CacheDir = cacheDir}));
+  llvm::cantFail(jit->addModule(session.Codegen()));
+  auto main = (int64_t(*)(int, char **))llvm::cantFail(jit->lookup("main"))
+                  .getAddress();
+  DoNotOptimize(main(1, nullptr));
+
+  if (!cacheDir.empty() && jit->getObjectCache()->Hits() != expectedHits)
+    abort();
+}
+
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  for (size_t count : {10, 100, 500}) {
+    auto source = GenerateChain(count);
+    auto suffix = "/functions=" + std::to_string(count);
+
+    llvm::SmallString<128> directory;
+    if (llvm::sys::fs::createUniqueDirectory("aatbe-cache", directory))
+      abort();
+    auto cacheDir = directory.str().str();
+
+    Measure("nocache" + suffix, 5, count, [&] { RunMain(source, {}, 0); });
+    Measure("cold" + suffix, 5, count, [&] {
+      llvm::sys::fs::remove_directories(cacheDir);
+      RunMain(source, cacheDir, 0);
+    });
+    Measure("warm" + suffix, 5, count, [&] { RunMain(source, cacheDir, 1); });
+
+    llvm::sys::fs::remove_directories(cacheDir);
+  }
+
+  return 0;
+}
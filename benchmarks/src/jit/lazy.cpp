@@ -0,0 +1,58 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+#include <jit.hpp>
+
+#include <llvm/Support/TargetSelect.h>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+using namespace aatbe::jit;
+
+// A module of `count` functions of which main only calls the first few,
+// like a large script that runs one path through its code.
+static std::string GenerateScript(size_t count) {
+  std::string source = "fn f0 (a: int64) -> int64 = a\n";
+  for (size_t i = 1; i < count; i++) {
+    auto n = std::to_string(i);
+    source += "fn f" + n + " (a: int64) -> int64 = { val x = a + " + n +
+              "; if x > 3 then f" + std::to_string(i - 1) +
+              "(x - 4) else x }\n";
+  }
+  source += "fn main (argc: int32, argv: ptr str) -> int64 = f8(5)\n";
+  return source;
+}
+
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  for (size_t count : {100, 1000, 5000}) {
+    CompilationSession session("lazy");
+    if (!session.AnalyzeSource(GenerateScript(count)))
+      abort();
+
+    for (auto mode : {JitMode::Eager, JitMode::Lazy}) {
+      auto name = std::string(mode == JitMode::Eager ? "eager" : "lazy") +
+                  "/functions=" + std::to_string(count);
+
+      // Time to main returning, from an already analyzed module.
+      Measure(name, 5, count, [&] {
+        auto jit = llvm::cantFail(
+            AatbeJit::Create({.Level = OptLevel::O2, .Mode = mode}));
+        llvm::cantFail(jit->addModule(session.Codegen()));
+        auto main = (int64_t(*)(int, char **))llvm::cantFail(
+                        jit->lookup("main"))
+                        .getAddress();
+        DoNotOptimize(main(1, nullptr));
+      });
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+#include <jit.hpp>
+
+#include <llvm/Support/TargetSelect.h>
+
+#include <chrono>
+#include <fstream>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+using namespace aatbe::jit;
+
+// Mappings of the process, one line each in /proc/self/maps.
+static size_t Mappings() {
+  std::ifstream maps("/proc/self/maps");
+  std::string line;
+  size_t count = 0;
+  while (std::getline(maps, line))
+    count++;
+  return count;
+}
+
+// Resident pages of the process.
+static size_t ResidentPages() {
+  std::ifstream statm("/proc/self/statm");
+  size_t size = 0, resident = 0;
+  statm >> size >> resident;
+  return resident;
+}
+
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  const size_t count = 10000;
+  const size_t batch = 100;
+
+  std::vector<std::string> names;
+  for (size_t i = 0; i < count; i++)
+    names.push_back("f" + std::to_string(i));
+
+  printf("%-24s %12s %12s %12s %12s %14s\n", "", "total ms", "mappings",
+         "rss pages", "code pages", "finalize ms");
+
+  for (uint64_t slabBytes : {0ull, 64ull << 20}) {
+    // One small module per function, emitted outside the measurement.
+    std::vector<llvm::orc::ThreadSafeModule> modules;
+    for (size_t first = 0; first < count; first += batch) {
+      std::string source;
+      for (size_t i = first; i < first + batch; i++) {
+        auto n = std::to_string(i);
+        source += "fn f" + n + " (a: int64) -> int64 = a * " + n + " + 1\n";
+      }
+      CompilationSession session("memory");
+      if (!session.AnalyzeSource(source))
+        return 1;
+      for (auto &module : session.CodegenParallel(batch))
+        modules.push_back(std::move(module));
+    }
+
+    auto mappings = Mappings();
+    auto resident = ResidentPages();
+    auto start = std::chrono::steady_clock::now();
+
+    auto jit = llvm::cantFail(AatbeJit::Create({.SlabBytes = slabBytes}));
+    for (auto &module : modules)
+      llvm::cantFail(jit->addModule(std::move(module)));
+    auto symbols = llvm::cantFail(jit->lookup(names));
+    if (symbols.size() != count)
+      abort();
+
+    auto seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+    int64_t result = 0;
+    for (auto &[name, symbol] : symbols)
+      result += ((int64_t(*)(int64_t))symbol.getAddress())(3);
+    DoNotOptimize(result);
+
+    auto name = slabBytes ? "jit/slabs" : "jit/section_memory";
+    printf("%-24s %12.3f %12ld %12ld", name, seconds * 1e3,
+           (long)Mappings() - (long)mappings,
+           (long)ResidentPages() - (long)resident);
+    if (auto *pool = jit->getSlabPool()) {
+      auto stats = pool->Stats();
+      printf(" %12zu %14.3f\n", stats.Pages, stats.FinalizeMs);
+    } else {
+      printf(" %12s %14s\n", "-", "-");
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <jit/repl.hpp>
+
+#include <llvm/Support/TargetSelect.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace aatbe::bench;
+using namespace aatbe::jit;
+
+// Runs `input` and returns how long it took, in milliseconds.
+static double Timed(Repl &repl, const std::string &input) {
+  auto start = std::chrono::steady_clock::now();
+  auto result = repl.Eval(input);
+  auto end = std::chrono::steady_clock::now();
+  if (!result) {
+    fprintf(stderr, "%s\n", llvm::toString(result.takeError()).c_str());
+    abort();
+  }
+  DoNotOptimize(*result);
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void Report(const char *name, std::vector<double> &latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  auto at = [&](double q) {
+    return latencies[(size_t)(q * (double)(latencies.size() - 1))];
+  };
+  printf("%-24s %8zu %10.3f %10.3f %10.3f\n", name, latencies.size(), at(0.5),
+         at(0.99), latencies.back());
+}
+
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  const size_t count = 5000;
+  auto repl = llvm::cantFail(Repl::Create());
+
+  printf("%-24s %8s %10s %10s %10s\n", "", "inputs", "p50 ms", "p99 ms",
+         "max ms");
+
+  // Each definition calls the previous one, so the session's tables grow
+  // with every input.
+  std::vector<double> definitions;
+  Timed(*repl, "fn f0 (a: int64) -> int64 = a");
+  for (size_t i = 1; i < count; i++)
+    definitions.push_back(
+        Timed(*repl, "fn f" + std::to_string(i) + " (a: int64) -> int64 = f" +
+                         std::to_string(i - 1) + "(a) + 1"));
+  Report("repl/define", definitions);
+
+  std::vector<double> expressions;
+  for (size_t i = 0; i < 1000; i++)
+    expressions.push_back(
+        Timed(*repl, "f" + std::to_string(i * 5 % count) + "(1) * 2"));
+  Report("repl/expression", expressions);
+
+  std::vector<double> redefinitions;
+  for (size_t i = 0; i < 1000; i++)
+    redefinitions.push_back(
+        Timed(*repl, "fn f" + std::to_string(i * 5 % count + 1) +
+                         " (a: int64) -> int64 = f" +
+                         std::to_string(i * 5 % count) + "(a) + " +
+                         std::to_string(i)));
+  Report("repl/redefine", redefinitions);
+
+  return 0;
+}
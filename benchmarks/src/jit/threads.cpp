@@ -0,0 +1,75 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+#include <jit.hpp>
+
+#include <llvm/Support/TargetSelect.h>
+
+#include <chrono>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+using namespace aatbe::jit;
+
+// `count` independent functions, so every module can materialize on its own.
+static std::string GenerateIndependent(size_t count) {
+  std::string source;
+  for (size_t i = 0; i < count; i++) {
+    auto n = std::to_string(i);
+    source += "fn f" + n + " (a: int64, b: int64) -> int64 = { val x = a * " +
+              n + "; if x > b then x - b else b - x }\n";
+  }
+  return source;
+}
+
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  const size_t count = 10000;
+  const unsigned shards = 64;
+
+  CompilationSession session("threads");
+  if (!session.AnalyzeSource(GenerateIndependent(count)))
+    return 1;
+
+  std::vector<std::string> names;
+  for (size_t i = 0; i < count; i++)
+    names.push_back("f" + std::to_string(i));
+
+  double baseline = 0;
+  for (unsigned threads : {0, 1, 2, 4, 8}) {
+    // Modules are emitted outside the measurement, which covers optimizing,
+    // compiling and linking all of them.
+    const size_t iterations = 3;
+    double seconds = 0;
+    for (size_t i = 0; i < iterations; i++) {
+      auto modules = session.CodegenParallel(shards);
+
+      auto start = std::chrono::steady_clock::now();
+      auto jit = llvm::cantFail(
+          AatbeJit::Create({.Level = OptLevel::O2, .Threads = threads}));
+      for (auto &module : modules)
+        llvm::cantFail(jit->addModule(std::move(module)));
+      if (llvm::cantFail(jit->lookup(names)).size() != count)
+        abort();
+      seconds += std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+    }
+
+    seconds /= iterations;
+    if (threads == 0)
+      baseline = seconds;
+    printf("%-40s %12.3f ms/iter %14.0f functions/s %6.2fx\n",
+           ("jit/threads=" + std::to_string(threads)).c_str(), seconds * 1e3,
+           (double)count / seconds, baseline / seconds);
+  }
+
+  return 0;
+}
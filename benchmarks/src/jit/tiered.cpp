@@ -0,0 +1,85 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+#include <jit.hpp>
+
+#include <llvm/Support/TargetSelect.h>
+
+#include <chrono>
+
+using namespace aatbe::bench;
+using namespace aatbe::codegen;
+using namespace aatbe::jit;
+
+// A module of `count` functions of which only fib is hot.
+static std::string GenerateHotFib(size_t count) {
+  std::string source = R"(
+    fn fib (n: uint64) -> uint64 =
+      if n < 2 then n else fib(n - 1) + fib(n - 2)
+    fn g0 (a: uint64) -> uint64 = a
+  )";
+  for (size_t i = 1; i < count; i++) {
+    auto n = std::to_string(i);
+    source += "fn g" + n + " (a: uint64) -> uint64 = { val x = a + " + n +
+              "; if x > 3 then g" + std::to_string(i - 1) +
+              "(x - 4) else x }\n";
+  }
+  return source;
+}
+
+struct Mode {
+  const char *name;
+  JitOptions options;
+};
+
+static double Milliseconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  const Mode modes[] = {
+      {"eager O0", {.Level = OptLevel::O0}},
+      {"eager O3", {.Level = OptLevel::O3}},
+      {"tiered", {.Level = OptLevel::O3, .Mode = JitMode::Tiered}},
+  };
+
+  printf("%-20s %12s %12s %12s %12s\n", "", "startup ms", "run 1 ms",
+         "run 5 ms", "recompiles");
+
+  CompilationSession session("tiered");
+  if (!session.AnalyzeSource(GenerateHotFib(200)))
+    return 1;
+
+  for (auto &mode : modes) {
+    auto start = std::chrono::steady_clock::now();
+    auto jit = llvm::cantFail(AatbeJit::Create(mode.options));
+    llvm::cantFail(jit->addModule(session.Codegen()));
+    auto fib = (uint64_t(*)(uint64_t))llvm::cantFail(jit->lookup("fib"))
+                   .getAddress();
+    auto startup = Milliseconds(start);
+
+    // The first run tiers fib up, the optimized code takes over once the
+    // background recompile is done.
+    double runs[5];
+    for (auto &run : runs) {
+      auto begin = std::chrono::steady_clock::now();
+      DoNotOptimize(fib(30));
+      run = Milliseconds(begin);
+    }
+
+    printf("%-20s %12.3f %12.3f %12.3f %12lu\n", mode.name, startup, runs[0],
+           runs[4], jit->getRecompiles());
+  }
+
+  return 0;
+}
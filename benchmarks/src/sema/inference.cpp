@@ -0,0 +1,34 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <lexer/lexer.hpp>
+#include <parser/parser.hpp>
+#include <sema/inference.hpp>
+
+using namespace aatbe::bench;
+using namespace aatbe::lexer;
+using namespace aatbe::parser;
+using namespace aatbe::sema;
+
+int main() {
+  for (size_t count : {1000, 5000, 10000, 20000}) {
+    Lexer lexer(SrcFile::FromString(GenerateModule(count).c_str()));
+    Parser parser(lexer.Lex());
+    auto mod = parser.Parse();
+
+    auto seconds = Measure("infer/functions=" + std::to_string(count), 10,
+                           count, [&] {
+                             aatbe::typesys::TypeSystem ts{};
+                             TypeInference inference(ts);
+                             if (!inference.InferModule(mod.Node()))
+                               abort();
+                           });
+
+    printf("%-40s %12.3f us/function\n", "", seconds * 1e6 / (double)count);
+  }
+
+  return 0;
+}
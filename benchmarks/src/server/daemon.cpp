@@ -0,0 +1,107 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen/prelude.hpp>
+#include <engine.hpp>
+#include <server/daemon.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/TargetSelect.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace aatbe;
+using namespace aatbe::bench;
+
+static const char *Program = R"(
+  fn fib (n: int64) -> int64 = if n < 2 then n else fib(n - 1) + fib(n - 2)
+  fn main () -> int32 = {
+    val x = max(abs(fib(15) - 1000), 3);
+    0
+  }
+)";
+
+// Compiles and runs Program in `engine`, then unloads it, as the daemon
+// does for every request.
+static int RunOnce(Engine &engine) {
+  auto id = llvm::cantFail(engine.compile(Program, "small"));
+  auto status = llvm::cantFail(engine.get<int32_t()>("main"))();
+  llvm::cantFail(engine.unload(id));
+  return status;
+}
+
+static void Report(const char *name, std::vector<double> &latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  auto at = [&](double q) {
+    return latencies[(size_t)(q * (double)(latencies.size() - 1))];
+  };
+  printf("%-24s %8zu %10.3f %10.3f %10.3f\n", name, latencies.size(), at(0.5),
+         at(0.99), latencies.back());
+}
+
+template <typename F> static std::vector<double> Latencies(F request) {
+  std::vector<double> latencies;
+  for (size_t i = 0; i < 200; i++) {
+    auto start = std::chrono::steady_clock::now();
+    DoNotOptimize(request());
+    auto end = std::chrono::steady_clock::now();
+    latencies.push_back(
+        std::chrono::duration<double, std::milli>(end - start).count());
+  }
+  return latencies;
+}
+
+// Per-request latency of a small program. `cold` does everything a `lang`
+// process does after it has started: load the prelude, create the JIT and
+// compile the prelude with the program. `daemon` sends the request over
+// the socket to a daemon that keeps its JIT, as `lang-client` does. Process
+// startup is not included, see the README for whole invocations.
+int main() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  jit::JitOptions options;
+  options.PreludePath = codegen::Prelude::DefaultPath();
+
+  printf("%-24s %8s %10s %10s %10s\n", "", "requests", "p50 ms", "p99 ms",
+         "max ms");
+
+  auto cold = Latencies([&] {
+    return RunOnce(*llvm::cantFail(Engine::Create(options)));
+  });
+  Report("request/cold", cold);
+
+  llvm::SmallString<128> directory;
+  if (llvm::sys::fs::createUniqueDirectory("aatbe-bench", directory))
+    abort();
+  auto path = (directory + "/aatbe.sock").str();
+
+  auto engine = llvm::cantFail(Engine::Create(options));
+  server::Daemon daemon(path, [&](const server::Request &) {
+    return RunOnce(*engine);
+  });
+  llvm::cantFail(daemon.Listen());
+  std::thread serving([&] { daemon.Serve(); });
+
+  auto warm = Latencies([&] {
+    std::string error;
+    auto status = server::Forward(path, {"small.aat"}, error);
+    if (status < 0)
+      abort();
+    return status;
+  });
+  Report("request/daemon", warm);
+
+  daemon.Stop();
+  serving.join();
+  llvm::sys::fs::remove_directories(directory);
+  return 0;
+}
@@ -0,0 +1,49 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <codegen.hpp>
+#include <timing.hpp>
+
+using namespace aatbe;
+using namespace aatbe::bench;
+
+// What a scope costs on its own, and what the scopes of the compiler cost
+// when compiling a module, with `-ftime-report` or `-ftime-trace` (on) and
+// without (off).
+int main() {
+  const size_t scopes = 10000000;
+  Measure("scope/off", 3, scopes, [&] {
+    for (size_t i = 0; i < scopes; i++) {
+      timing::Scope scope("scope", [] { return std::string("detail"); });
+      DoNotOptimize(i);
+    }
+  });
+  timing::Start();
+  Measure("scope/on", 3, scopes / 10, [&] {
+    for (size_t i = 0; i < scopes / 10; i++) {
+      timing::Scope scope("scope", [] { return std::string("detail"); });
+      DoNotOptimize(i);
+    }
+    timing::Start();
+  });
+  timing::Stop();
+
+  const size_t count = 5000;
+  auto source = GenerateModule(count);
+  for (auto on : {false, true}) {
+    Measure(std::string("compile/") + (on ? "on" : "off"), 3, count, [&] {
+      if (on)
+        timing::Start();
+      codegen::CompilationSession session("bench");
+      if (!session.AnalyzeSource(source))
+        abort();
+      DoNotOptimize(session.Codegen(codegen::OptLevel::O1));
+      timing::Stop();
+    });
+  }
+
+  return 0;
+}
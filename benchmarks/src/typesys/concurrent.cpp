@@ -0,0 +1,45 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <typesys/type_system.hpp>
+
+#include <thread>
+
+using namespace aatbe::typesys;
+using namespace aatbe::bench;
+
+// Every thread interns the same family of shapes (pointer and array chains
+// over every integer type) starting at a different offset, so threads mostly
+// hit shapes that another thread already published.
+static void InternShapes(TypeSystem &ts, size_t thread, size_t shapes) {
+  size_t sum = 0;
+  for (size_t i = 0; i < shapes; i++) {
+    auto n = (i + thread * 97) % shapes;
+    auto id = ts.Create<IntType>((IntType::IntSize)(n % 4), n % 2);
+    id = ts.Create<PointerType>(ts.Create<ArrayType>(id, n));
+    sum += id.Resolve<PointerType>()->Type().Value();
+  }
+  DoNotOptimize(sum);
+}
+
+int main() {
+  constexpr size_t shapes = 1 << 15;
+
+  for (size_t threads = 1; threads <= 64; threads *= 2) {
+    Measure("intern/threads=" + std::to_string(threads), 5, shapes * threads,
+            [&] {
+              TypeSystem ts{};
+              std::vector<std::thread> workers;
+              for (size_t t = 0; t < threads; t++)
+                workers.emplace_back(
+                    [&ts, t] { InternShapes(ts, t, shapes); });
+              for (auto &worker : workers)
+                worker.join();
+            });
+  }
+
+  return 0;
+}
@@ -0,0 +1,57 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../bench.hpp"
+
+#include <typesys/type_system.hpp>
+
+#include <random>
+
+using namespace aatbe::typesys;
+using namespace aatbe::bench;
+
+int main() {
+  constexpr size_t count = 1 << 16;
+
+  TypeSystem ts{};
+  std::vector<TypeId> ids;
+  ids.reserve(count);
+
+  auto base = ts.Create<IntType>(IntType::IntSize::Int32);
+  for (size_t i = 0; i < count; i++)
+    ids.push_back(ts.Create<ArrayType>(base, i));
+
+  std::vector<TypeId> shuffled = ids;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64{42});
+
+  Measure("resolve/sequential", 100, count, [&] {
+    size_t sum = 0;
+    for (auto &id : ids)
+      sum += id.Resolve<ArrayType>()->Size();
+    DoNotOptimize(sum);
+  });
+
+  Measure("resolve/random", 100, count, [&] {
+    size_t sum = 0;
+    for (auto &id : shuffled)
+      sum += id.Resolve<ArrayType>()->Size();
+    DoNotOptimize(sum);
+  });
+
+  Measure("resolve/kind-mismatch", 100, count, [&] {
+    size_t misses = 0;
+    for (auto &id : ids)
+      misses += id.Resolve<PointerType>() == nullptr;
+    DoNotOptimize(misses);
+  });
+
+  Measure("intern/existing", 100, count, [&] {
+    size_t sum = 0;
+    for (size_t i = 0; i < count; i++)
+      sum += ts.Create<ArrayType>(base, i).Value();
+    DoNotOptimize(sum);
+  });
+
+  return 0;
+}
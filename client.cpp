@@ -0,0 +1,20 @@
+#include <server/protocol.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// `lang-client ARGS...` runs `lang ARGS...` on the daemon started with
+// `lang --daemon`, at $AATBE_SOCKET or the default socket. It does not link
+// LLVM, so it starts as fast as a process can.
+int main(int argc, char **argv) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string error;
+  auto status = aatbe::server::Forward(aatbe::server::DefaultSocketPath(),
+                                       args, error);
+  if (status < 0) {
+    fprintf(stderr, "lang-client: %s\n", error.c_str());
+    return 1;
+  }
+  return status;
+}
@@ -0,0 +1,145 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aatbe::accounting {
+
+// Memory accounting for `-fmem-report` and Engine::memoryUsage. Every
+// allocation is counted against the phase of the compiler that made it,
+// the phase of its thread, see PhaseScope, and so is its release, whichever
+// phase that happens in.
+//
+// Arenas count their slabs themselves. The heap is counted by the
+// operator new of interpose.cpp, when the program links it in, as the lang
+// driver does; otherwise only arenas are counted.
+enum class Phase : uint8_t {
+  Other,
+  Lexer,
+  Parser,
+  Typesys,
+  Codegen,
+  Jit,
+};
+constexpr size_t PhaseCount = 6;
+
+llvm::StringRef Name(Phase phase);
+
+struct Usage {
+  // Bytes and allocations made since Start.
+  uint64_t Bytes = 0;
+  uint64_t Allocations = 0;
+  // Bytes allocated since Start and not released, and their maximum.
+  uint64_t Live = 0;
+  uint64_t Peak = 0;
+};
+
+namespace detail {
+extern std::atomic<bool> counting;
+extern std::atomic<uint32_t> epoch;
+extern std::atomic<bool> interposed;
+extern thread_local Phase phase;
+} // namespace detail
+
+inline bool Counting() {
+  return detail::counting.load(std::memory_order_relaxed);
+}
+// Start begins a new epoch; releases of what was allocated in an earlier
+// one are not counted.
+inline uint32_t Epoch() {
+  return detail::epoch.load(std::memory_order_relaxed);
+}
+inline Phase Current() { return detail::phase; }
+// Whether operator new is counted, see interpose.cpp.
+inline bool Interposed() {
+  return detail::interposed.load(std::memory_order_relaxed);
+}
+
+// Sets the phase of the calling thread until it is destroyed.
+class PhaseScope {
+public:
+  explicit PhaseScope(Phase phase) : saved(detail::phase) {
+    detail::phase = phase;
+  }
+  PhaseScope(PhaseScope &&) = delete;
+  PhaseScope(PhaseScope const &) = delete;
+  PhaseScope &operator=(PhaseScope const &) = delete;
+  ~PhaseScope() { detail::phase = saved; }
+
+private:
+  Phase saved;
+};
+
+// Starts counting from zero, or stops counting.
+void Start();
+void Stop();
+
+// Counts `bytes` allocated, or released, in `phase`. Only call them while
+// counting, and Released only for bytes allocated in the current epoch.
+void Allocated(Phase phase, uint64_t bytes);
+void Released(Phase phase, uint64_t bytes);
+
+Usage Get(Phase phase);
+// All phases together. Its peak is the peak of their sum, not the sum of
+// their peaks.
+Usage Total();
+
+// Prints the usage of every phase and the total.
+void Report(llvm::raw_ostream &os);
+
+// A bump allocator whose slabs are counted against one phase, whichever
+// phase allocates from it. Objects made in an arena live as long as the
+// arena, which runs their destructors.
+class Arena {
+public:
+  explicit Arena(Phase phase) : phase(phase) {}
+  Arena(Arena &&) = delete;
+  Arena(Arena const &) = delete;
+  Arena &operator=(Arena const &) = delete;
+  ~Arena();
+
+  void *Allocate(size_t size, size_t align);
+
+  template <typename T, typename... Args> T *Make(Args &&...args) {
+    auto object =
+        new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>)
+      destructors.push_back(
+          {object, [](void *object) { static_cast<T *>(object)->~T(); }});
+    return object;
+  }
+
+  // Bytes of all slabs, used or not.
+  size_t Bytes() const { return this->bytes; }
+
+private:
+  struct Slab {
+    char *memory;
+    size_t size;
+    // Counted in this epoch, or not at all.
+    uint32_t epoch;
+    bool counted;
+  };
+
+  Phase phase;
+  std::vector<Slab> slabs{};
+  std::vector<std::pair<void *, void (*)(void *)>> destructors{};
+  char *next = nullptr;
+  char *end = nullptr;
+  size_t bytes = 0;
+};
+
+} // namespace aatbe::accounting
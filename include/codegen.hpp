@@ -1,19 +1,14 @@
 #pragma once
 
-#include <llvm/IR/Module.h>
-#include <llvm/IR/IRBuilder.h>
-
 #include <codegen/context.hpp>
+#include <codegen/session.hpp>
 
 namespace aatbe::codegen {
 
-extern std::unique_ptr<llvm::LLVMContext> LLVMContext;
-extern std::shared_ptr<llvm::IRBuilder<>> Builder;
-extern std::unique_ptr<llvm::Module> Module;
-extern std::shared_ptr<CompilerContext> CompContext;
-
-std::shared_ptr<llvm::IRBuilder<>> GetLLVMBuilder();
-std::shared_ptr<CompilerContext> GetCompilerContext();
+// Declares the structs of an analyzed module and emits the bodies of
+// functions [begin, end) (indexed like sema::Resolver::Functions()) into the
+// context's module.
+void EmitModule(CompilerContext &ctx, parser::ModuleNode *mod, uint32_t begin,
+                uint32_t end);
 
-void compile_file(const std::string &file);
 } // namespace aatbe::codegen
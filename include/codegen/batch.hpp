@@ -0,0 +1,50 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <codegen/optimize.hpp>
+#include <codegen/prelude.hpp>
+
+#include <llvm/Support/Error.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aatbe::codegen {
+
+struct BatchOptions {
+  OptLevel Level = OptLevel::O0;
+  // Worker threads, at most one per file. 0 uses one per hardware thread.
+  unsigned Jobs = 1;
+  bool DebugInfo = false;
+  // The prelude, linked into every object, see
+  // CompilationSession::SetPrelude.
+  std::shared_ptr<const Prelude> Runtime{};
+};
+
+struct BatchResult {
+  std::string File;
+  // Path of the object written, empty when the file failed to compile.
+  std::string Object;
+  std::vector<std::string> Diagnostics;
+};
+
+// Compiles every file of `files` into the object at the same index of
+// `objects`, as many files at once as there are jobs, and returns a result
+// per file in the same order. A file that fails does not stop the others.
+//
+// All files share one TypeSystem. Each worker takes the next file from a
+// shared queue, largest first so a big file does not start last, and keeps
+// one target machine for all the files it compiles; target machines are
+// not safe to share between threads.
+//
+// Fails only if no target machine can be created for the host.
+llvm::Expected<std::vector<BatchResult>>
+BatchCompile(const std::vector<std::string> &files,
+             const std::vector<std::string> &objects,
+             const BatchOptions &options);
+
+} // namespace aatbe::codegen
@@ -9,7 +9,14 @@
 #include <utility>
 #include <vector>
 
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/DIBuilder.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+
+#include <codegen/lowering.hpp>
+#include <sema/resolve.hpp>
 
 namespace aatbe::codegen {
 
@@ -22,11 +29,6 @@ public:
 
   explicit Scope(std::string scopeName) : scopeName(std::move(scopeName)) {}
 
-  auto GetFunction(const std::string &name) { return functions[name]; }
-  auto SetFunction(const std::string &name, llvm::Function *function) {
-    this->functions[name] = function;
-  }
-
   auto GetStruct(const std::string &name) { return structs[name]; }
   auto SetStruct(const std::string &name, llvm::StructType *structType) {
     this->structs[name] = structType;
@@ -36,15 +38,19 @@ public:
 
 private:
   std::string scopeName{};
-  std::unordered_map<std::string, llvm::Function *> functions{};
   std::unordered_map<std::string, llvm::StructType *> structs{};
 };
 
-class TypeSystem;
+class CompilationSession;
 
+// CompilerContext holds the state for emitting one LLVM module from an
+// analyzed CompilationSession: the LLVMContext and Module, the IRBuilder,
+// type lowering, and the functions and locals emitted so far. Contexts of
+// the same session are independent and may be used on different threads.
 class CompilerContext {
 public:
-  CompilerContext() = default;
+  CompilerContext(CompilationSession &session, const std::string &name);
+  ~CompilerContext();
   CompilerContext(CompilerContext &&) = delete;
   CompilerContext(CompilerContext const &) = delete;
   CompilerContext &operator=(CompilerContext const &) = delete;
@@ -58,17 +64,45 @@ public:
   auto CurrentScope() { return scopes[scopes.size() - 1]; }
   auto CurrentScopeName() { return scopes[scopes.size() - 1]->ScopeName(); }
 
-  auto GetFunction(const std::string &name) {
-    llvm::Function *result = nullptr;
-    for (unsigned i = scopes.size(); i-- > 0;) {
-      auto scope = scopes[i];
-      if (auto function = scope->GetFunction(name)) {
-        result = function;
-        break;
-      }
-    }
-
-    return result;
+  auto &Session() const { return this->session; }
+  auto &Context() const { return *this->context; }
+  auto &Module() const { return *this->module; }
+  auto &Builder() { return this->builder; }
+  auto &Lowering() { return *this->lowering; }
+
+  // Declaration of a module function (indexed like
+  // sema::Resolver::Functions()) in this module, created on first use so
+  // that a module only declares the functions it references.
+  llvm::Function *GetFunction(uint32_t index);
+
+  // Hands the module and its context over, e.g. to the JIT. The
+  // CompilerContext cannot be used afterwards.
+  llvm::orc::ThreadSafeModule TakeModule();
+
+  // Attaches a DISubprogram starting at `line` to the function and points
+  // the builder's debug location at it. Does nothing unless the session
+  // emits debug info.
+  void DescribeFunction(llvm::Function *function, unsigned line);
+  // Resolves the debug info built so far, before the module is optimized.
+  void FinalizeDebugInfo();
+
+  // Function whose body is being emitted, with one value per local slot.
+  void EnterFunction(const sema::FunctionInfo *info, llvm::Function *function) {
+    this->function = info;
+    this->llvmFunction = function;
+    this->locals.assign(info->localCount, nullptr);
+  }
+  auto CurrentFunction() const { return this->function; }
+
+  // Value of a parameter or local of the current function.
+  llvm::Value *GetVariable(const sema::Symbol &symbol) {
+    assert(symbol.kind != sema::Symbol::Kind::Function);
+    if (symbol.kind == sema::Symbol::Kind::Parameter)
+      return this->llvmFunction->getArg(symbol.index);
+    return this->locals[symbol.index];
+  }
+  void SetLocal(uint32_t slot, llvm::Value *value) {
+    this->locals[slot] = value;
   }
 
   auto GetStruct(const std::string &name) {
@@ -85,7 +119,22 @@ public:
   }
 
 private:
+  CompilationSession &session;
+  std::unique_ptr<llvm::LLVMContext> context;
+  std::unique_ptr<llvm::Module> module;
+  llvm::IRBuilder<> builder;
+  std::unique_ptr<TypeLowering> lowering;
+
+  // Only set when the session emits debug info.
+  std::unique_ptr<llvm::DIBuilder> debug;
+  llvm::DIFile *debugFile = nullptr;
+
   std::vector<std::shared_ptr<Scope>> scopes{};
+
+  std::vector<llvm::Function *> functions{};
+  const sema::FunctionInfo *function = nullptr;
+  llvm::Function *llvmFunction = nullptr;
+  std::vector<llvm::Value *> locals{};
 };
 
 } // namespace aatbe::codegen
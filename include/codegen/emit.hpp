@@ -0,0 +1,49 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <codegen/optimize.hpp>
+
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aatbe::codegen {
+
+// Target machine for the host: its triple, CPU and CPU features. Code is
+// position independent so objects link into the default PIE executables.
+// Requires the native target to be initialized.
+llvm::Expected<std::unique_ptr<llvm::TargetMachine>>
+CreateHostMachine(OptLevel level = OptLevel::O0);
+
+// Writes `module` to `path` as a native object file.
+llvm::Error EmitObject(llvm::Module &module, llvm::TargetMachine &machine,
+                       const std::string &path);
+
+// Writes every module to its own object file, one thread and target machine
+// per module, and returns the paths. Objects are temporaries named after
+// the file name of `prefix`, which may be the output's path as it is, and
+// should be removed by the caller once linked.
+llvm::Expected<std::vector<std::string>>
+EmitObjects(std::vector<llvm::orc::ThreadSafeModule> &modules,
+            OptLevel level, const std::string &prefix);
+
+// Links `objects` into an executable at `output` with the system C compiler
+// driver, `$CC` when set and `cc` otherwise, which also brings in libc and
+// the C runtime startup files.
+llvm::Error LinkExecutable(const std::vector<std::string> &objects,
+                           const std::string &output);
+
+// Links `objects` into a single relocatable object at `output`, with the
+// same driver, for a build that links the result itself.
+llvm::Error LinkRelocatable(const std::vector<std::string> &objects,
+                            const std::string &output);
+
+} // namespace aatbe::codegen
@@ -8,15 +8,26 @@
 
 #include <optional>
 
+#include <codegen/context.hpp>
 #include <parser/expression.hpp>
 
 using namespace aatbe::parser;
 
 namespace aatbe::codegen {
 
-std::optional<llvm::Value *> CodegenExpression(ExpressionNode *expression);
-std::optional<llvm::Value *> CodegenCall(CallExpression *call);
-std::optional<llvm::Value *> CodegenAtom(AtomExpression *atom);
-std::optional<llvm::Value *> CodegenIf(IfExpression *ifExpr);
+std::optional<llvm::Value *> CodegenExpression(CompilerContext &ctx,
+                                               ExpressionNode *expression);
+std::optional<llvm::Value *> CodegenCall(CompilerContext &ctx,
+                                         CallExpression *call);
+std::optional<llvm::Value *> CodegenAtom(CompilerContext &ctx,
+                                         AtomExpression *atom);
+std::optional<llvm::Value *> CodegenIf(CompilerContext &ctx,
+                                       IfExpression *ifExpr);
+std::optional<llvm::Value *> CodegenUnary(CompilerContext &ctx,
+                                          UnaryExpression *unary);
+std::optional<llvm::Value *> CodegenBinary(CompilerContext &ctx,
+                                           BinaryExpression *binary);
+std::optional<llvm::Value *> CodegenLet(CompilerContext &ctx,
+                                        LetExpression *let);
 
 } // namespace aatbe::codegen
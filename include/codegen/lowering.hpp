@@ -0,0 +1,53 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <typesys/layout.hpp>
+#include <typesys/type_system.hpp>
+
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <vector>
+
+namespace aatbe::codegen {
+
+// TypeLowering maps interned TypeIds of one TypeSystem to LLVM types of one
+// LLVMContext. Every type is lowered once and cached by TypeId, so each
+// struct becomes exactly one named LLVM struct no matter how often it is
+// referenced.
+class TypeLowering {
+public:
+  TypeLowering(typesys::TypeSystem &types, llvm::LLVMContext &context,
+               llvm::DataLayout layout)
+      : types(types), context(context), layouts(types, std::move(layout)) {}
+  TypeLowering(TypeLowering &&) = delete;
+  TypeLowering(TypeLowering const &) = delete;
+  TypeLowering &operator=(TypeLowering const &) = delete;
+
+  llvm::Type *Lower(typesys::TypeId const &id);
+  llvm::FunctionType *LowerFunction(typesys::TypeId const &id) {
+    return llvm::cast<llvm::FunctionType>(Lower(id));
+  }
+
+  // Position of a struct field (by declaration index) in the lowered struct.
+  unsigned FieldIndex(typesys::TypeId const &id, size_t declIndex);
+
+  auto &Types() const { return this->types; }
+  auto &Context() const { return this->context; }
+
+private:
+  llvm::Type *Compute(typesys::TypeId const &id);
+  void LowerStructBody(typesys::TypeId const &id, llvm::StructType *lowered);
+
+  typesys::TypeSystem &types;
+  llvm::LLVMContext &context;
+  typesys::LayoutEngine layouts;
+
+  std::vector<llvm::Type *> cache{};
+};
+
+} // namespace aatbe::codegen
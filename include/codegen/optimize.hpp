@@ -0,0 +1,36 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <optional>
+#include <string_view>
+
+namespace aatbe::codegen {
+
+enum class OptLevel {
+  O0,
+  O1,
+  O2,
+  O3,
+  Os,
+};
+
+// Parses the argument of `-O`: "0", "1", "2", "3" or "s".
+std::optional<OptLevel> ParseOptLevel(std::string_view level);
+// The inverse of ParseOptLevel.
+std::string_view FormatOptLevel(OptLevel level);
+
+// Runs LLVM's default pipeline for `level` over `module`. The target machine
+// is optional; when given, passes see the target's cost model.
+//
+// Pipelines only touch the module they are given, so modules in separate
+// LLVMContexts (e.g. codegen shards) can be optimized on separate threads.
+void OptimizeModule(llvm::Module &module, OptLevel level,
+                    llvm::TargetMachine *machine = nullptr);
+
+} // namespace aatbe::codegen
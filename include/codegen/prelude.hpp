@@ -0,0 +1,68 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <codegen/optimize.hpp>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <memory>
+#include <string>
+
+namespace aatbe::codegen {
+
+class CompilationSession;
+
+// The runtime prelude: functions every program may call without declaring
+// them, from runtime/prelude.aat.
+//
+// It is compiled once, when the compiler is built, into optimized bitcode
+// and an interface next to it, `prelude.aati`, which declares every
+// function of the prelude in Åtbe. A session with a prelude parses only the
+// interface, see CompilationSession::SetPrelude. The JIT loads the bitcode
+// into a JITDylib of its own, see JitOptions::PreludePath, and executables
+// link in the functions they call, see LinkInto.
+class Prelude {
+public:
+  Prelude(std::string path, std::string interface,
+          std::unique_ptr<llvm::MemoryBuffer> bitcode)
+      : path(std::move(path)), interface(std::move(interface)),
+        bitcode(std::move(bitcode)) {}
+  Prelude(Prelude &&) = delete;
+  Prelude(Prelude const &) = delete;
+  Prelude &operator=(Prelude const &) = delete;
+
+  // Reads the bitcode at `path` and the interface next to it.
+  static llvm::Expected<std::shared_ptr<const Prelude>>
+  Load(const std::string &path);
+
+  // Writes the analyzed module of `session`, optimized at `level`, as
+  // bitcode to `path` and its interface next to it.
+  static llvm::Error Write(CompilationSession &session, OptLevel level,
+                           const std::string &path);
+
+  // $AATBE_PRELUDE when set, otherwise the prelude built with the compiler
+  // if it exists, otherwise empty.
+  static std::string DefaultPath();
+  // `path` with the extension replaced by `.aati`.
+  static std::string InterfacePath(const std::string &path);
+
+  auto &Path() const { return this->path; }
+  auto &Interface() const { return this->interface; }
+  llvm::MemoryBufferRef Bitcode() const { return *this->bitcode; }
+
+  // Links the prelude functions `module` calls into it, with internal
+  // linkage, so they are optimized together with their callers.
+  llvm::Error LinkInto(llvm::Module &module) const;
+
+private:
+  std::string path;
+  std::string interface;
+  std::unique_ptr<llvm::MemoryBuffer> bitcode;
+};
+
+} // namespace aatbe::codegen
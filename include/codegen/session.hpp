@@ -0,0 +1,130 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <codegen/context.hpp>
+#include <codegen/optimize.hpp>
+#include <codegen/prelude.hpp>
+#include <parser/ast.hpp>
+#include <sema/inference.hpp>
+#include <sema/resolve.hpp>
+#include <typesys/type_system.hpp>
+
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aatbe::codegen {
+
+// CompilationSession owns everything needed to compile one source module:
+// the AST, the TypeSystem and the results of resolution and inference. There
+// is no global state, so independent sessions can compile different modules
+// concurrently. Sessions may also share a TypeSystem, which is thread-safe,
+// so common types are interned once for a whole batch, see BatchCompile.
+//
+// Analyze runs the front end. Afterwards the session is read-only, and any
+// number of CompilerContexts may emit code from it, see Codegen and
+// CodegenParallel.
+class CompilationSession {
+public:
+  explicit CompilationSession(std::string name)
+      : name(std::move(name)),
+        ownTypes(std::make_unique<typesys::TypeSystem>()), types(*ownTypes) {}
+  // A session whose types live in `types`, which must outlive it.
+  CompilationSession(std::string name, typesys::TypeSystem &types)
+      : name(std::move(name)), types(types) {}
+  CompilationSession(CompilationSession &&) = delete;
+  CompilationSession(CompilationSession const &) = delete;
+  CompilationSession &operator=(CompilationSession const &) = delete;
+
+  // Parses, resolves and type checks. Returns false and records
+  // diagnostics if any phase fails.
+  bool AnalyzeFile(const std::string &file);
+  bool AnalyzeSource(const std::string &source);
+
+  // Incremental analysis, e.g. for a REPL. Adds the statements of `source`
+  // to those analyzed so far, only they are resolved and type checked. A
+  // function may be redefined with the type it had. On errors, records
+  // diagnostics and leaves the session as it was.
+  bool AnalyzeIncrement(const std::string &source);
+  // Adds the expression `source` as a function `name` without parameters
+  // that returns its value, see sema::TypeInference::InferExpression.
+  bool AnalyzeExpression(const std::string &name, const std::string &source);
+  // Forgets the functions added after the first `count`, e.g. an
+  // expression once it has been evaluated.
+  void Truncate(size_t count) { symbols.Truncate(count); }
+
+  auto &Name() const { return this->name; }
+  auto Node() const { return this->mod; }
+  auto &Types() { return this->types; }
+  auto &Symbols() const { return this->symbols; }
+  auto &Inference() const { return this->inference; }
+  auto &Diagnostics() const { return this->diagnostics; }
+
+  // 1-based line of a source offset, e.g. FunctionStatement::Offset().
+  unsigned Line(size_t offset) const;
+
+  // Declares the functions of `prelude` in every module analyzed from now
+  // on, except those the module declares itself. With `link`, every module
+  // emitted also links in the prelude functions it calls before it is
+  // optimized, for executables; the JIT finds them in a JITDylib instead.
+  void SetPrelude(std::shared_ptr<const Prelude> prelude, bool link = false) {
+    this->prelude = std::move(prelude);
+    this->linkPrelude = link;
+  }
+
+  // Emit DWARF for every defined function, with the line it starts on.
+  // Statements carry no positions, so there is no finer line table.
+  void SetDebugInfo(bool enabled) { this->debugInfo = enabled; }
+  auto DebugInfo() const { return this->debugInfo; }
+
+  // Emits the whole module into a single LLVM module, optimized at `level`.
+  llvm::orc::ThreadSafeModule Codegen(OptLevel level = OptLevel::O0);
+
+  // Emits the module into `shards` LLVM modules on as many threads, each
+  // with its own LLVMContext. Every shard defines a contiguous slice of the
+  // functions and declares the ones it references, and is optimized on the
+  // thread that emitted it.
+  std::vector<llvm::orc::ThreadSafeModule>
+  CodegenParallel(unsigned shards, OptLevel level = OptLevel::O0);
+
+  // Emits only functions [begin, end) (indexed like
+  // sema::Resolver::Functions()) into a module of their own, declaring the
+  // ones they reference.
+  llvm::orc::ThreadSafeModule CodegenRange(const std::string &moduleName,
+                                           uint32_t begin, uint32_t end,
+                                           OptLevel level = OptLevel::O0) {
+    return EmitShard(moduleName, begin, end, level);
+  }
+
+private:
+  bool Analyze(const std::string &source, std::vector<lexer::Token *> tokens);
+  // The prelude's declarations followed by the statements of `module`.
+  parser::ModuleNode *WithPrelude(parser::ModuleNode *module);
+  llvm::orc::ThreadSafeModule EmitShard(const std::string &moduleName,
+                                        uint32_t begin, uint32_t end,
+                                        OptLevel level);
+
+  std::string name;
+  parser::ModuleNode *mod = nullptr;
+
+  std::unique_ptr<typesys::TypeSystem> ownTypes{};
+  typesys::TypeSystem &types;
+  sema::Resolver symbols{};
+  sema::TypeInference inference{types};
+
+  std::vector<std::string> diagnostics{};
+
+  // Offset of the first character of every line.
+  std::vector<size_t> lines{};
+  bool debugInfo = false;
+
+  std::shared_ptr<const Prelude> prelude{};
+  bool linkPrelude = false;
+};
+
+} // namespace aatbe::codegen
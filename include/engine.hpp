@@ -0,0 +1,181 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <accounting.hpp>
+#include <codegen/prelude.hpp>
+#include <codegen/session.hpp>
+#include <jit.hpp>
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/Error.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace aatbe {
+
+// The Åtbe spelling of the C++ type `T` in a signature, e.g. `ptr int64` for
+// `int64_t *`. `char *` is `str`, references are `ref`s and `void` is `()`.
+template <typename T> std::string TypeName() {
+  using U = std::remove_cv_t<T>;
+  if constexpr (std::is_void_v<U>)
+    return "()";
+  else if constexpr (std::is_same_v<U, bool>)
+    return "bool";
+  else if constexpr (std::is_same_v<U, char>)
+    return "char";
+  else if constexpr (std::is_integral_v<U>)
+    return (std::is_signed_v<U> ? "int" : "uint") +
+           std::to_string(sizeof(U) * 8);
+  else if constexpr (std::is_same_v<U, float>)
+    return "float32";
+  else if constexpr (std::is_same_v<U, double>)
+    return "float64";
+  else if constexpr (std::is_pointer_v<U> &&
+                     std::is_same_v<std::remove_cv_t<std::remove_pointer_t<U>>,
+                                    char>)
+    return "str";
+  else if constexpr (std::is_pointer_v<U>)
+    return "ptr " + TypeName<std::remove_pointer_t<U>>();
+  else if constexpr (std::is_lvalue_reference_v<U>)
+    return "ref " + TypeName<std::remove_reference_t<U>>();
+  else
+    static_assert(!sizeof(U), "no Åtbe type for this C++ type");
+}
+
+// The Åtbe spelling of the function type `Sig`, e.g. `int64(int64, str)`.
+template <typename Sig> struct Signature;
+template <typename R, typename... Args> struct Signature<R(Args...)> {
+  static std::string Name() {
+    std::string parameters;
+    ((parameters += (parameters.empty() ? "" : ", ") + TypeName<Args>()), ...);
+    return TypeName<R>() + "(" + parameters + ")";
+  }
+};
+
+// A JIT'd function of type `Sig`, see Engine::get. Calling it is a plain
+// indirect call through the function's address. It is valid until the
+// module defining it is unloaded.
+template <typename Sig> class Function;
+template <typename R, typename... Args> class Function<R(Args...)> {
+public:
+  using Pointer = R (*)(Args...);
+
+  Function() = default;
+  explicit Function(Pointer pointer) : pointer(pointer) {}
+
+  R operator()(Args... args) const { return pointer(args...); }
+
+  Pointer get() const { return pointer; }
+  explicit operator bool() const { return pointer != nullptr; }
+
+private:
+  Pointer pointer = nullptr;
+};
+
+// Embeds the compiler into a host application: compiles Åtbe source into an
+// AatbeJit and hands out typed callables for the functions it defines.
+//
+//   auto engine = cantFail(Engine::Create());
+//   cantFail(engine->compile("fn fib (n: int64) -> int64 = ..."));
+//   auto fib = cantFail(engine->get<int64_t(int64_t)>("fib"));
+//   fib(30);
+//
+// get checks the C++ signature against the function's declared types, see
+// Signature, and looks the function up once; its address is cached until
+// the module is unloaded. Every compiled module is added under a
+// ResourceTracker of its own, so unload frees its code. A module may call
+// the functions of modules added before it by declaring them; unloading a
+// module others call leaves them calling freed code.
+//
+// All member functions may be called from any thread.
+class Engine {
+public:
+  using ModuleId = uint64_t;
+
+  explicit Engine(std::unique_ptr<jit::AatbeJit> jit,
+                  std::shared_ptr<const codegen::Prelude> prelude = nullptr)
+      : jit(std::move(jit)), prelude(std::move(prelude)) {}
+  Engine(Engine &&) = delete;
+  Engine(Engine const &) = delete;
+  Engine &operator=(Engine const &) = delete;
+
+  // A JIT created with `options`, with the prelude at its PreludePath
+  // declared in every module.
+  static llvm::Expected<std::unique_ptr<Engine>>
+  Create(const jit::JitOptions &options = {});
+
+  // Analyzes and compiles `source` as a module named `name`. On errors,
+  // returns the diagnostics and adds nothing.
+  llvm::Expected<ModuleId> compile(const std::string &source,
+                                   const std::string &name = "<source>");
+  llvm::Expected<ModuleId> compileFile(const std::string &file);
+
+  // Adds the code `emitted` from `session` as one module. Its functions
+  // with a body may be got from then on. `emitted` may be empty when the
+  // code is added to the JIT otherwise, e.g. by a jit::HotReloader.
+  llvm::Expected<ModuleId>
+  add(codegen::CompilationSession &session,
+      std::vector<llvm::orc::ThreadSafeModule> emitted);
+
+  // Removes the code of module `id` and forgets its functions; callables
+  // got from it must not be called anymore.
+  llvm::Error unload(ModuleId id);
+
+  // The function `name` as a callable of type `Sig`, e.g.
+  // `get<int64_t(int64_t)>("fib")`. Fails when there is no such function or
+  // it has another signature.
+  template <typename Sig>
+  llvm::Expected<Function<Sig>> get(llvm::StringRef name) {
+    auto address = resolve(name, Signature<Sig>::Name());
+    if (!address)
+      return address.takeError();
+    return Function<Sig>((typename Function<Sig>::Pointer)*address);
+  }
+
+  // The signature of the function `name`, spelled like Signature::Name.
+  llvm::Expected<std::string> signature(llvm::StringRef name);
+
+  // The memory allocated by each phase of the compiler since
+  // accounting::Start, indexed by accounting::Phase. It is counted for the
+  // whole process rather than per engine; the heap only when the host links
+  // interpose.cpp in, otherwise only the lexer's arenas.
+  static std::array<accounting::Usage, accounting::PhaseCount> memoryUsage();
+
+  jit::AatbeJit &getJit() { return *this->jit; }
+
+private:
+  struct Module {
+    llvm::orc::ResourceTrackerSP tracker;
+    std::vector<std::string> functions;
+  };
+  struct Symbol {
+    std::string signature;
+    ModuleId module;
+    uint64_t address = 0;
+  };
+
+  // The address of `name` once its signature is checked against
+  // `signature`, compiling it on the first call.
+  llvm::Expected<uint64_t> resolve(llvm::StringRef name,
+                                   const std::string &signature);
+
+  std::unique_ptr<jit::AatbeJit> jit;
+  std::shared_ptr<const codegen::Prelude> prelude;
+
+  std::mutex lock{};
+  std::unordered_map<ModuleId, Module> modules{};
+  std::unordered_map<std::string, Symbol> symbols{};
+  ModuleId next = 1;
+};
+
+} // namespace aatbe
@@ -6,59 +6,251 @@
 
 #include <llvm/ADT/StringRef.h>
 #include <llvm/ExecutionEngine/JITSymbol.h>
+#include <llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h>
 #include <llvm/ExecutionEngine/Orc/CompileUtils.h>
 #include <llvm/ExecutionEngine/Orc/Core.h>
 #include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
 #include <llvm/ExecutionEngine/Orc/ExecutorProcessControl.h>
 #include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
+#include <llvm/ExecutionEngine/Orc/IRTransformLayer.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LazyReexports.h>
+#include <llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h>
 #include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/ThreadPool.h>
+#include <atomic>
 #include <memory>
 
+#include <codegen/optimize.hpp>
+#include <jit/cache.hpp>
+#include <jit/compile.hpp>
+#include <jit/memory.hpp>
+#include <jit/perf.hpp>
+#include <jit/tiered.hpp>
+
 using namespace llvm::orc;
 using namespace llvm;
 
 namespace aatbe::jit {
 
+enum class JitMode {
+  // Every function of a module is compiled when the module is first used.
+  Eager,
+  // Each function is compiled on its first call, through a lazy reexport
+  // stub. Functions that never run are never compiled.
+  Lazy,
+  // Every function is compiled unoptimized first, and recompiled optimized
+  // in the background once it is hot, see TieredCompiler. The optimized
+  // tier uses the JIT's level, or O3 when that is O0.
+  Tiered,
+};
+
+enum class ObjectLinker {
+  // RuntimeDyld, with a SectionMemoryManager.
+  RuntimeDyld,
+  // JITLink's ObjectLinkingLayer, which supports perf maps and debugger
+  // registration.
+  JITLink,
+};
+
+struct JitOptions {
+  codegen::OptLevel Level = codegen::OptLevel::O0;
+  JitMode Mode = JitMode::Eager;
+
+  // When set, compiled objects are cached in this directory across runs,
+  // see DiskObjectCache.
+  std::string CacheDir{};
+  uint64_t CacheBytes = 256 << 20;
+
+  // Calls after which a tiered function is recompiled optimized.
+  uint64_t TierUpThreshold = 1000;
+
+  // Materialize (optimize, compile and link) on a pool of this many
+  // threads, so independent modules and lazy functions compile
+  // concurrently. 0 materializes on the thread that looks a symbol up.
+  unsigned Threads = 0;
+
+  ObjectLinker Linker = ObjectLinker::RuntimeDyld;
+  // JITLink only: append every linked function to this perf map, see
+  // PerfMapPlugin.
+  std::string PerfMapPath{};
+  // JITLink only: register linked objects with GDB's JIT interface, so
+  // debuggers see JIT'd functions in stack traces.
+  bool DebuggerSupport = false;
+
+  // RuntimeDyld only: pack the sections of all objects into shared slabs
+  // of this many bytes instead of mapping pages per object, see SlabPool.
+  // 0 uses a SectionMemoryManager per object.
+  uint64_t SlabBytes = 0;
+
+  // Bitcode of the runtime prelude, see codegen::Prelude. It is loaded
+  // into a JITDylib of its own, which the main one links against, and
+  // compiled when a program first calls into it. With a CacheDir, its
+  // object is cached like any module.
+  std::string PreludePath{};
+};
+
 class AatbeJit {
 public:
   AatbeJit(std::unique_ptr<ExecutionSession> ES, JITTargetMachineBuilder JTMB,
-           const DataLayout &DL)
-      : ES(std::move(ES)), DL(DL), Mangle(*this->ES, this->DL),
-        ObjectLayer(*this->ES,
-                    []() { return std::make_unique<SectionMemoryManager>(); }),
-        CompileLayer(*this->ES, ObjectLayer,
-                     std::make_unique<ConcurrentIRCompiler>(std::move(JTMB))),
+           const DataLayout &DL, const JitOptions &Options = {})
+      : ES(std::move(ES)), TT(JTMB.getTargetTriple()), DL(DL),
+        Level(Options.Level), Mangle(*this->ES, this->DL),
+        Cache(Options.CacheDir.empty()
+                  ? nullptr
+                  : std::make_unique<DiskObjectCache>(
+                        Options.CacheDir, Options.CacheBytes, JTMB)),
+        Slabs(Options.SlabBytes == 0
+                  ? nullptr
+                  : std::make_unique<SlabPool>(Options.SlabBytes)),
+        ObjLayer(createObjectLayer(*this->ES, Options.Linker, Slabs.get())),
+        CompileLayer(*this->ES, *ObjLayer,
+                     std::make_unique<TimedIRCompiler>(JTMB, Cache.get())),
+        OptimizeLayer(*this->ES, CompileLayer,
+                      [JTMB, Level = Options.Level](
+                          ThreadSafeModule TSM,
+                          const MaterializationResponsibility &) {
+                        return optimizeModule(std::move(TSM), JTMB, Level);
+                      }),
+        PreludeLayer(*this->ES, CompileLayer,
+                     [this](ThreadSafeModule TSM,
+                            const MaterializationResponsibility &) {
+                       return materializePrelude(std::move(TSM));
+                     }),
         MainJD(this->ES->createBareJITDylib("<main>")) {
     MainJD.addGenerator(
         cantFail(DynamicLibrarySearchGenerator::GetForCurrentProcess(0)));
+    CompileLayer.setNotifyCompiled(
+        [this](MaterializationResponsibility &, ThreadSafeModule) {
+          this->Compiled++;
+        });
+
+    if (Options.Threads > 0)
+      dispatchToThreads(Options.Threads);
+
+    if (Options.Mode == JitMode::Tiered)
+      Tiered = std::make_unique<TieredCompiler>(
+          *this->ES, MainJD, *ObjLayer, CompileLayer, Mangle, JTMB,
+          Level == codegen::OptLevel::O0 ? codegen::OptLevel::O3 : Level,
+          Options.TierUpThreshold);
   }
 
   ~AatbeJit() {
+    // Stop recompiling and let running materializations finish before the
+    // session goes away.
+    Tiered.reset();
+    if (CompileThreads)
+      CompileThreads->wait();
     if (auto Err = ES->endSession())
       ES->reportError(std::move(Err));
   }
 
-  static Expected<std::unique_ptr<AatbeJit>> Create();
+  static Expected<std::unique_ptr<AatbeJit>>
+  Create(const JitOptions &Options = {});
   Error addModule(ThreadSafeModule TSM, ResourceTrackerSP RT = nullptr);
+  // Both lookups take names as the source spells them and mangle them for
+  // the target, e.g. with a leading `_` on Darwin.
   Expected<JITEvaluatedSymbol> lookup(StringRef Name);
+  // Looks up all of `Names` at once, materializing what they need in
+  // parallel when the JIT has threads. The map is keyed by mangled names.
+  Expected<SymbolMap> lookup(ArrayRef<std::string> Names);
 
+  ExecutionSession &getExecutionSession() { return *ES; }
   const DataLayout &getDataLayout() const { return DL; }
   JITDylib &getMainJITDylib() { return MainJD; }
+  // The dylib of the prelude, if the JIT was created with a PreludePath.
+  JITDylib *getPreludeJITDylib() { return PreludeJD; }
+
+  // Number of modules compiled to machine code so far. In lazy mode every
+  // function is compiled as a module of its own; in tiered mode only tier 1
+  // modules are counted.
+  size_t compiledModules() const { return Compiled; }
+
+  // The object cache, if the JIT was created with a CacheDir.
+  DiskObjectCache *getObjectCache() { return Cache.get(); }
+
+  // The slab pool, if the JIT was created with SlabBytes.
+  SlabPool *getSlabPool() { return Slabs.get(); }
+
+  // The perf map plugin, if the JIT was created with a PerfMapPath.
+  PerfMapPlugin *getPerfMap() { return PerfMap; }
+
+  // Tier of every function added in tiered mode, empty otherwise.
+  std::vector<FunctionTierStats> getTierStats() const {
+    return Tiered ? Tiered->stats() : std::vector<FunctionTierStats>{};
+  }
+  size_t getRecompiles() const { return Tiered ? Tiered->recompiles() : 0; }
+  // Blocks until functions queued for recompilation have been recompiled.
+  void waitForTierUps() {
+    if (Tiered)
+      Tiered->waitForIdle();
+  }
 
 private:
+  static std::unique_ptr<ObjectLayer>
+  createObjectLayer(ExecutionSession &ES, ObjectLinker Linker,
+                    SlabPool *Slabs);
+  // Adds the perf map and debugger plugins to a JITLink object layer.
+  Error addLinkerPlugins(const JitOptions &Options);
+
+  void dispatchToThreads(unsigned Threads);
+
+  // Adds the prelude at `Path` to a new JITDylib, from the object cache
+  // when it has been compiled before.
+  Error loadPrelude(StringRef Path);
+  // The prelude's bitcode is read lazily and was optimized when it was
+  // built, it only has to be read in full before it is compiled.
+  Expected<ThreadSafeModule> materializePrelude(ThreadSafeModule TSM);
+
+  // Puts a CompileOnDemandLayer on top of the optimize layer, partitioned
+  // per function.
+  Error enableLazyCompilation();
+
+  // Runs the -O pipeline on each module as it is materialized, on whichever
+  // thread the session compiles it.
+  static Expected<ThreadSafeModule>
+  optimizeModule(ThreadSafeModule TSM, JITTargetMachineBuilder JTMB,
+                 codegen::OptLevel Level);
+
   std::unique_ptr<ExecutionSession> ES;
 
+  Triple TT;
   DataLayout DL;
+  codegen::OptLevel Level;
   MangleAndInterner Mangle;
 
-  RTDyldObjectLinkingLayer ObjectLayer;
+  std::unique_ptr<DiskObjectCache> Cache;
+  // Outlives the object layer, whose memory managers allocate from it.
+  std::unique_ptr<SlabPool> Slabs;
+
+  std::unique_ptr<ObjectLayer> ObjLayer;
   IRCompileLayer CompileLayer;
+  IRTransformLayer OptimizeLayer;
+  IRTransformLayer PreludeLayer;
+
+  // Only set in lazy mode.
+  std::unique_ptr<LazyCallThroughManager> LCTMgr;
+  std::unique_ptr<CompileOnDemandLayer> CODLayer;
 
   JITDylib &MainJD;
+
+  // Only set with a PreludePath. PreludeKey is its object cache key.
+  JITDylib *PreludeJD = nullptr;
+  std::string PreludeKey{};
+
+  // Only set in tiered mode.
+  std::unique_ptr<TieredCompiler> Tiered;
+
+  // Owned by the object layer, only set with a PerfMapPath.
+  PerfMapPlugin *PerfMap = nullptr;
+
+  // Only set when materializing on threads.
+  std::unique_ptr<ThreadPool> CompileThreads;
+
+  std::atomic<size_t> Compiled{0};
 };
 
 } // namespace aatbe::jit
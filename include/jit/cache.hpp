@@ -0,0 +1,96 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Chrono.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aatbe::jit {
+
+// ObjectCache that keeps compiled objects in a directory, so a program that
+// is run again skips machine code generation.
+//
+// Objects are keyed by a hash of the module's bitcode as it reaches the
+// compiler, the target triple, CPU, CPU features, relocation and code model,
+// the LLVM version and the compiler version. A module can instead carry a
+// key computed before it was optimized, see SetKey, so that a hit can skip
+// the optimizer too.
+//
+// Every hit refreshes an object's modification time, and after each store
+// the least recently used objects are evicted until the directory holds at
+// most `maxBytes` of objects. The object just stored is never evicted.
+//
+// Objects are written to a temporary file and renamed into place, so
+// several processes may share a directory. A cache is safe to use from
+// concurrent compile threads.
+class DiskObjectCache : public llvm::ObjectCache {
+public:
+  DiskObjectCache(std::string directory, uint64_t maxBytes,
+                  const llvm::orc::JITTargetMachineBuilder &JTMB);
+  DiskObjectCache(DiskObjectCache &&) = delete;
+  DiskObjectCache(DiskObjectCache const &) = delete;
+  DiskObjectCache &operator=(DiskObjectCache const &) = delete;
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *M) override;
+  void notifyObjectCompiled(const llvm::Module *M,
+                            llvm::MemoryBufferRef Obj) override;
+
+  // Cache key of a module as compiled for this cache's target. `salt` is
+  // mixed in, e.g. the pipeline the module has yet to go through.
+  std::string Key(const llvm::Module &M, llvm::StringRef salt = {}) const;
+  // Cache key of a module given as bitcode, without reading it.
+  std::string Key(llvm::MemoryBufferRef bitcode,
+                  llvm::StringRef salt = {}) const;
+
+  // Records `key` in the module. Once compiled, its object is stored under
+  // that key instead of the hash of the module the compiler sees.
+  static void SetKey(llvm::Module &M, llvm::StringRef key);
+
+  // Object stored under `key`, or null. Counted as a hit or a miss.
+  std::unique_ptr<llvm::MemoryBuffer> Lookup(const std::string &key);
+
+  auto &Directory() const { return this->directory; }
+  size_t Hits() const { return this->hits; }
+  size_t Misses() const { return this->misses; }
+
+private:
+  struct Entry {
+    std::string path;
+    uint64_t size;
+    llvm::sys::TimePoint<> modified;
+  };
+
+  std::string PathOf(const std::string &key) const;
+  std::vector<Entry> Scan() const;
+  void Evict(const std::string &keep);
+
+  std::string directory;
+  uint64_t maxBytes;
+  std::string target;
+
+  // Keys computed by getObject for modules that missed, to be stored when
+  // they finish compiling.
+  std::mutex pendingMutex{};
+  std::unordered_map<const llvm::Module *, std::string> pending{};
+
+  // Size of the objects in the directory, as of the last scan plus the
+  // objects stored since.
+  std::mutex evictMutex{};
+  std::atomic<uint64_t> bytes{0};
+
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+};
+
+} // namespace aatbe::jit
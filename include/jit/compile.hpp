@@ -0,0 +1,30 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <accounting.hpp>
+#include <timing.hpp>
+
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+
+namespace aatbe::jit {
+
+// ConcurrentIRCompiler with a "JIT compile" timing scope around every
+// module it compiles to an object, see timing::Scope, which it counts
+// against the JIT's phase, see accounting::PhaseScope.
+class TimedIRCompiler : public llvm::orc::ConcurrentIRCompiler {
+public:
+  using ConcurrentIRCompiler::ConcurrentIRCompiler;
+
+  llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>>
+  operator()(llvm::Module &M) override {
+    timing::Scope scope("JIT compile",
+                        [&] { return M.getModuleIdentifier(); });
+    accounting::PhaseScope phase(accounting::Phase::Jit);
+    return ConcurrentIRCompiler::operator()(M);
+  }
+};
+
+} // namespace aatbe::jit
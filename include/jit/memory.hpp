@@ -0,0 +1,100 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
+#include <llvm/Support/Error.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace aatbe::jit {
+
+struct SlabStats {
+  // Regions mapped so far, each one mmap per view.
+  size_t Slabs;
+  // Pages holding at least one live section.
+  size_t Pages;
+  // Bytes of live sections.
+  size_t Bytes;
+  size_t Finalizations;
+  // Total time spent in finalizeMemory.
+  double FinalizeMs;
+};
+
+// Memory for JIT'd sections, shared by every object the JIT links.
+//
+// SectionMemoryManager maps fresh pages for each object and mprotects them
+// when it is finalized, so many small modules each cost a few mappings and
+// permission changes, and never share a page. A SlabPool instead maps large
+// slabs and packs the sections of all objects into them.
+//
+// Code and read-only data slabs are mapped twice from the same memory: a
+// writable view the linker copies sections into, and an executable or
+// read-only view that RuntimeDyld relocates against and the program runs
+// from. Permissions are set once, when a slab is mapped, and finalizing an
+// object changes none. Read-write data lives in ordinary writable slabs.
+//
+// Sections of removed objects are returned to the pool and reused.
+class SlabPool {
+public:
+  enum class Kind { Code, ReadOnly, ReadWrite };
+
+  struct Block {
+    Kind kind;
+    // Where the linker writes the section.
+    uint8_t *write;
+    // Where the section runs from, equal to `write` for read-write data.
+    uint8_t *target;
+    size_t size;
+  };
+
+  explicit SlabPool(size_t slabBytes = 64 << 20);
+  ~SlabPool();
+  SlabPool(SlabPool &&) = delete;
+  SlabPool(SlabPool const &) = delete;
+  SlabPool &operator=(SlabPool const &) = delete;
+
+  llvm::Expected<Block> Allocate(Kind kind, size_t size, unsigned alignment);
+  void Release(const Block &block);
+
+  // A memory manager for one object, to hand to RTDyldObjectLinkingLayer.
+  std::unique_ptr<llvm::RTDyldMemoryManager> CreateMemoryManager();
+
+  void RecordFinalize(double ms);
+  SlabStats Stats() const;
+
+private:
+  struct Slab {
+    Kind kind;
+    uint8_t *write;
+    uint8_t *target;
+    size_t size;
+    // Free ranges, offset to size, coalesced, and the same ranges by size.
+    std::map<size_t, size_t> free;
+    std::multimap<size_t, size_t> bySize;
+
+    void AddFree(size_t offset, size_t size);
+    void RemoveFree(size_t offset, size_t size);
+  };
+
+  llvm::Error Map(Kind kind, size_t size);
+  static std::optional<Block> Carve(Slab &slab, size_t size,
+                                    unsigned alignment);
+
+  size_t slabBytes;
+  size_t pageSize;
+
+  mutable std::mutex mutex{};
+  std::vector<Slab> slabs{};
+
+  size_t finalizations = 0;
+  double finalizeMs = 0;
+};
+
+} // namespace aatbe::jit
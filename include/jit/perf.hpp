@@ -0,0 +1,57 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace aatbe::jit {
+
+// ObjectLinkingLayer plugin that appends every function the JIT links to a
+// perf map, `START SIZE NAME` per line, once its final address is known.
+// perf picks up /tmp/perf-<pid>.map to symbolize samples in JIT'd code.
+//
+// Entries are never removed, perf maps are append only; code that is
+// unloaded and replaced shows up under its latest name.
+class PerfMapPlugin : public llvm::orc::ObjectLinkingLayer::Plugin {
+public:
+  explicit PerfMapPlugin(const std::string &path = DefaultPath());
+  PerfMapPlugin(PerfMapPlugin &&) = delete;
+  PerfMapPlugin(PerfMapPlugin const &) = delete;
+  PerfMapPlugin &operator=(PerfMapPlugin const &) = delete;
+
+  // /tmp/perf-<pid>.map, where perf looks for the map of a process.
+  static std::string DefaultPath();
+
+  void modifyPassConfig(llvm::orc::MaterializationResponsibility &MR,
+                        llvm::jitlink::LinkGraph &G,
+                        llvm::jitlink::PassConfiguration &Config) override;
+
+  llvm::Error
+  notifyFailed(llvm::orc::MaterializationResponsibility &MR) override {
+    return llvm::Error::success();
+  }
+  llvm::Error notifyRemovingResources(llvm::orc::ResourceKey K) override {
+    return llvm::Error::success();
+  }
+  void notifyTransferringResources(llvm::orc::ResourceKey DstKey,
+                                   llvm::orc::ResourceKey SrcKey) override {}
+
+  size_t Entries() const { return this->entries; }
+
+private:
+  llvm::Error Record(llvm::jitlink::LinkGraph &G);
+
+  std::mutex mutex{};
+  std::unique_ptr<llvm::raw_fd_ostream> out{};
+  std::atomic<size_t> entries{0};
+};
+
+} // namespace aatbe::jit
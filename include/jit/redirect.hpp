@@ -0,0 +1,69 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <codegen/session.hpp>
+#include <jit.hpp>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ExecutionEngine/Orc/IndirectionUtils.h>
+#include <llvm/ExecutionEngine/Orc/Mangling.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aatbe::jit {
+
+// Redirectable functions on top of AatbeJit.
+//
+// Each function `name` is an indirect stub in the main JITDylib, and its
+// body is a module of its own defining `name$<n>` under a ResourceTracker of
+// its own. Bodies call other functions, themselves included, through their
+// stubs, so pointing a stub at a new body replaces the function for every
+// caller, including code that is running.
+class Redirects {
+public:
+  explicit Redirects(AatbeJit &jit);
+  Redirects(Redirects &&) = delete;
+  Redirects(Redirects const &) = delete;
+  Redirects &operator=(Redirects const &) = delete;
+
+  struct Body {
+    std::string Name;
+    std::string Symbol;
+    llvm::orc::ThreadSafeModule Module;
+  };
+
+  // Emits function `index` of `session` as the body of its function, see
+  // Body. Its calls, recursive ones too, go through the stubs.
+  Body Emit(codegen::CompilationSession &session, uint32_t index,
+            codegen::OptLevel level = codegen::OptLevel::O0);
+
+  // Compiles and links every body first and only then points their stubs
+  // at them, one after another, so a running program never calls a body
+  // that is not ready. Stubs are created for new functions. Returns the
+  // trackers of the replaced bodies; removing one frees its code, so the
+  // caller has to know that no frame still runs it.
+  llvm::Expected<std::vector<llvm::orc::ResourceTrackerSP>>
+  Install(std::vector<Body> bodies);
+
+  bool Contains(llvm::StringRef name) const {
+    return this->current.count(name) != 0;
+  }
+  // Functions with a body.
+  size_t size() const { return this->current.size(); }
+
+private:
+  AatbeJit &jit;
+  llvm::orc::MangleAndInterner mangle;
+  std::unique_ptr<llvm::orc::IndirectStubsManager> stubs;
+
+  // The tracker of the current body of each function.
+  llvm::StringMap<llvm::orc::ResourceTrackerSP> current{};
+  size_t generation = 0;
+};
+
+} // namespace aatbe::jit
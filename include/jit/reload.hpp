@@ -0,0 +1,84 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <codegen/session.hpp>
+#include <jit.hpp>
+#include <jit/redirect.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace aatbe::jit {
+
+// Hot code reloading of one source module into a running program, for
+// `lang --watch`.
+//
+// Every function is called through a stub, see Redirects. Update analyzes a
+// new version of the source and compares the ModuleNode::Hashes of its
+// items with those of the running version. Only the functions whose hash
+// changed, and new ones, are compiled again; once all of them are linked
+// their stubs are repointed while the program keeps running. A changed
+// struct or function signature may change how callers are compiled, so it
+// recompiles every function.
+//
+// A replaced body may still be running on some thread, so its code is kept
+// until the reloader is destroyed.
+class HotReloader {
+public:
+  HotReloader(AatbeJit &jit, std::string name)
+      : name(std::move(name)), redirects(jit) {}
+  HotReloader(HotReloader &&) = delete;
+  HotReloader(HotReloader const &) = delete;
+  HotReloader &operator=(HotReloader const &) = delete;
+  ~HotReloader() { Stop(); }
+
+  // Declares the prelude's functions in every version, see
+  // CompilationSession::SetPrelude.
+  void SetPrelude(std::shared_ptr<const codegen::Prelude> prelude) {
+    this->prelude = std::move(prelude);
+  }
+
+  // Compiles the functions of `source` that differ from the running
+  // version and returns their names, all of them on the first call. On
+  // errors, returns the diagnostics and keeps the running version.
+  llvm::Expected<std::vector<std::string>> Update(const std::string &source);
+
+  // Checks the modification time of `file` every `interval` on a thread of
+  // its own and passes the result of updating to `report` when it changed.
+  void Watch(std::string file, std::chrono::milliseconds interval,
+             std::function<void(llvm::Expected<std::vector<std::string>>)>
+                 report);
+  void Stop();
+
+  // Functions with a body.
+  size_t Functions() const { return this->redirects.size(); }
+
+private:
+  std::string name;
+  Redirects redirects;
+  std::shared_ptr<const codegen::Prelude> prelude{};
+
+  // Serializes Update calls from the watcher and other threads.
+  std::mutex updating{};
+  // Hash of every item of the running version, by kind and name.
+  std::unordered_map<std::string, size_t> hashes{};
+  std::unordered_map<std::string, std::string> signatures{};
+  std::vector<llvm::orc::ResourceTrackerSP> retired{};
+
+  std::thread watcher{};
+  std::mutex stopping{};
+  std::condition_variable stopped{};
+  bool stop = false;
+};
+
+} // namespace aatbe::jit
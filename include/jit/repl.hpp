@@ -0,0 +1,66 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <codegen/session.hpp>
+#include <jit.hpp>
+#include <jit/redirect.hpp>
+
+#include <memory>
+#include <string>
+
+namespace aatbe::jit {
+
+// Incremental compilation on top of AatbeJit, for `lang repl`.
+//
+// One CompilationSession holds everything defined so far, and each input is
+// analyzed against it without analyzing earlier inputs again. Every function
+// an input defines is compiled as a module of its own, with its own
+// ResourceTracker, and is called through an indirect stub, see Redirects.
+// Redefining a function compiles the new body, points the stub at it and
+// removes the old body, so functions compiled earlier call the new body from
+// then on.
+//
+// An expression is compiled as a function without parameters, called once
+// and removed again.
+class Repl {
+public:
+  explicit Repl(std::unique_ptr<AatbeJit> jit);
+  Repl(Repl &&) = delete;
+  Repl(Repl const &) = delete;
+  Repl &operator=(Repl const &) = delete;
+
+  static llvm::Expected<std::unique_ptr<Repl>>
+  Create(const JitOptions &options = {});
+
+  // Compiles one input, either definitions (`fn`, `extern fn`, `struct`) or
+  // an expression. Returns the value of an expression formatted for
+  // printing, nothing for definitions and unit values, and the diagnostics
+  // as the error. A failed input leaves the functions as they were, the
+  // struct types it declared stay declared.
+  llvm::Expected<std::string> Eval(const std::string &input);
+
+  // Whether `input` has unclosed brackets or ends in `=`, `->` or `,`, so
+  // the next line continues it.
+  static bool IsIncomplete(const std::string &input);
+
+  // Functions with a compiled body.
+  size_t Functions() const { return this->redirects.size(); }
+  AatbeJit &Jit() { return *this->jit; }
+
+private:
+  llvm::Expected<std::string> Define(const std::string &input);
+  llvm::Expected<std::string> Evaluate(const std::string &input);
+  // The diagnostics recorded since the last call, as an error.
+  llvm::Error Diagnostics();
+
+  std::unique_ptr<AatbeJit> jit;
+  codegen::CompilationSession session{"repl"};
+  Redirects redirects;
+  size_t expressions = 0;
+  size_t diagnostics = 0;
+};
+
+} // namespace aatbe::jit
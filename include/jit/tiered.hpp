@@ -0,0 +1,117 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
+#include <llvm/ExecutionEngine/Orc/IndirectionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/Mangling.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+
+#include <codegen/optimize.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aatbe::jit {
+
+struct FunctionTierStats {
+  std::string Name;
+  // 0 while running baseline code, 1 once recompiled optimized.
+  unsigned Tier;
+  // Entries counted while at tier 0.
+  uint64_t Calls;
+  // Time spent recompiling at tier 1, 0 until then.
+  double RecompileMs;
+};
+
+// Two tier compilation for AatbeJit.
+//
+// Every function is compiled right away without optimization and with
+// FastISel, and is called through an indirect stub that its symbol resolves
+// to. The baseline code counts its entries, and once a function has been
+// entered `Threshold` times it is queued to be recompiled at `TopLevel` on a
+// background thread. When that finishes, the stub is pointed at the
+// optimized code; calls that are already running finish in the baseline.
+//
+// The tier 1 module of a function holds only that function, calls to other
+// functions still go through their stubs so they tier up independently.
+class TieredCompiler {
+public:
+  TieredCompiler(llvm::orc::ExecutionSession &ES, llvm::orc::JITDylib &JD,
+                 llvm::orc::ObjectLayer &ObjLayer,
+                 llvm::orc::IRLayer &CompileLayer,
+                 llvm::orc::MangleAndInterner &Mangle,
+                 llvm::orc::JITTargetMachineBuilder JTMB,
+                 codegen::OptLevel TopLevel, uint64_t Threshold);
+  ~TieredCompiler();
+  TieredCompiler(TieredCompiler &&) = delete;
+  TieredCompiler(TieredCompiler const &) = delete;
+  TieredCompiler &operator=(TieredCompiler const &) = delete;
+
+  // Defines the stubs of the module's functions in the JITDylib and
+  // compiles the module at tier 0.
+  llvm::Error addModule(llvm::orc::ThreadSafeModule TSM,
+                        llvm::orc::ResourceTrackerSP RT);
+
+  std::vector<FunctionTierStats> stats() const;
+  size_t recompiles() const { return Recompiles; }
+
+  // Blocks until every function queued for tier 1 has been recompiled.
+  void waitForIdle();
+
+private:
+  struct FunctionRecord {
+    TieredCompiler *Owner;
+    std::string Name;
+    // The module the function was added in, before instrumentation.
+    std::shared_ptr<llvm::orc::ThreadSafeModule> Source;
+    // Incremented by the baseline code with an atomicrmw.
+    std::atomic<uint64_t> Calls{0};
+    std::atomic<unsigned> Tier{0};
+    std::atomic<double> RecompileMs{0};
+  };
+
+  // Called from baseline code when a counter reaches the threshold.
+  static void tierUp(FunctionRecord *Record);
+
+  void instrument(llvm::Function &F, FunctionRecord &Record,
+                  llvm::FunctionCallee TierUp);
+  llvm::Error recompile(FunctionRecord &Record);
+  void run();
+
+  llvm::orc::ExecutionSession &ES;
+  llvm::orc::JITDylib &JD;
+  llvm::orc::MangleAndInterner &Mangle;
+  llvm::orc::JITTargetMachineBuilder JTMB;
+  codegen::OptLevel TopLevel;
+  uint64_t Threshold;
+
+  llvm::orc::IRCompileLayer BaselineLayer;
+  // Compiles tier 1 modules, which are optimized already.
+  llvm::orc::IRLayer &CompileLayer;
+  std::unique_ptr<llvm::orc::IndirectStubsManager> Stubs;
+
+  mutable std::mutex RecordsMutex{};
+  std::deque<FunctionRecord> Records{};
+
+  std::mutex QueueMutex{};
+  std::condition_variable QueueChanged{};
+  std::deque<FunctionRecord *> Queue{};
+  bool Busy = false;
+  bool Stopping = false;
+  std::atomic<size_t> Recompiles{0};
+  std::thread Worker;
+};
+
+} // namespace aatbe::jit
@@ -9,6 +9,7 @@
 #include <vector>
 #include <variant>
 
+#include <accounting.hpp>
 #include <lexer/token.hpp>
 #include <vector>
 #include <source/source_file.hpp>
@@ -17,6 +18,8 @@ namespace aatbe::lexer {
 
 using namespace aatbe::source;
 
+// Tokens live in the lexer's arena, as long as the lexer; the parser copies
+// what the tree keeps of them.
 class Lexer {
 public:
   Lexer(std::shared_ptr<SrcFile> file);
@@ -37,6 +40,7 @@ private:
                    uint64_t valueI);
 
   std::shared_ptr<SrcFile> file;
+  accounting::Arena arena{accounting::Phase::Lexer};
 
   size_t index;
   size_t last_index;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -9,7 +11,7 @@
 #include <parser/expression.hpp>
 #include <parser/type.hpp>
 
-#include <codegen.hpp>
+#include <typesys/type_system.hpp>
 
 namespace aatbe::parser {
 
@@ -23,6 +25,29 @@ struct ModuleStatement {
 
   virtual ModuleStatementKind Kind() const = 0;
   virtual std::string Format() const = 0;
+
+  // Attributes written before the statement, e.g. `@reorder struct ...`.
+  auto &Attributes() const { return this->attributes; }
+  bool HasAttribute(const std::string &name) const {
+    return std::find(attributes.begin(), attributes.end(), name) !=
+           attributes.end();
+  }
+  void SetAttributes(std::vector<std::string> attrs) {
+    this->attributes = std::move(attrs);
+  }
+
+  // Hash of the statement's content, attributes included. Positions,
+  // whitespace and comments are not part of it, so only a change to what
+  // the statement means changes the hash.
+  size_t Hash() const {
+    auto content = Format();
+    for (auto &attribute : attributes)
+      content += "@" + attribute;
+    return std::hash<std::string>{}(content);
+  }
+
+private:
+  std::vector<std::string> attributes{};
 };
 
 struct FunctionStatement : ModuleStatement {
@@ -41,25 +66,31 @@ struct FunctionStatement : ModuleStatement {
   auto IsExtern() const { return this->isExtern; }
   auto IsVariadic() const { return this->isVariadic; }
 
+  // Offset of the function's first token in the source.
+  auto Offset() const { return this->offset; }
+  void SetOffset(size_t at) { this->offset = at; }
+
   auto Value() const { return std::make_tuple(name, parameters, returnType); }
 
   ModuleStatementKind Kind() const override {
     return ModuleStatementKind::Function;
   }
 
-  llvm::FunctionType *Type() {
-    std::vector<llvm::Type *> paramTypes;
-    for (auto &param : parameters->Bindings()) {
-      paramTypes.push_back(param->Type()->LLVMType());
-    }
-    return llvm::FunctionType::get(returnType->LLVMType(), paramTypes, false);
-  }
+  // Interned signature, assigned by semantic analysis.
+  auto Id() const { return this->id; }
+  void SetId(typesys::TypeId typeId) { this->id = std::move(typeId); }
 
-  std::string Format() const override {
+  // The statement without the body, e.g. to tell whether a redefinition
+  // keeps the type.
+  std::string Signature() const {
     std::string ext = isExtern ? "Extern" : "";
     auto variadic = isVariadic ? "Variadic" : "";
-    auto res = ext + variadic + "Function(" + name + ", args " +
-               parameters->Format() + ", ret " + returnType->Format() + ")";
+    return ext + variadic + "Function(" + name + ", args " +
+           parameters->Format() + ", ret " + returnType->Format() + ")";
+  }
+
+  std::string Format() const override {
+    auto res = Signature();
 
     if (body.has_value()) {
       res += " = " + body.value()->Format();
@@ -75,6 +106,8 @@ private:
   TypeNode *returnType;
   std::optional<ExpressionNode *> body;
   bool isVariadic;
+  size_t offset = 0;
+  typesys::TypeId id{};
 };
 
 struct StructStatement : ModuleStatement {
@@ -96,17 +129,17 @@ struct StructStatement : ModuleStatement {
     return "Struct(" + name + ", " + members->Format() + ")";
   }
 
-  llvm::StructType *LLVMType() {
-    std::vector<llvm::Type *> memberTypes;
-    for (auto &member : members->Bindings()) {
-      memberTypes.push_back(member->Type()->LLVMType());
-    }
-    return llvm::StructType::create(*LLVMContext, memberTypes, this->name);
-  }
+  // Whether members may be reordered to minimize padding (`@reorder`).
+  bool Reorder() const { return HasAttribute("reorder"); }
+
+  // Interned struct type, assigned by semantic analysis.
+  auto Id() const { return this->id; }
+  void SetId(typesys::TypeId typeId) { this->id = std::move(typeId); }
 
 private:
   std::string name;
   MemberList *members;
+  typesys::TypeId id{};
 };
 
 struct ModuleStatementNode {
@@ -134,6 +167,17 @@ public:
 
   auto Value() const { return this->statements; }
   auto Kind() const { return ModuleStatementKind::Module; }
+  void Append(const std::vector<ModuleStatementNode *> &more) {
+    statements.insert(statements.end(), more.begin(), more.end());
+  }
+  // ModuleStatement::Hash of every statement, in order.
+  std::vector<size_t> Hashes() const {
+    std::vector<size_t> hashes;
+    hashes.reserve(statements.size());
+    for (auto statement : statements)
+      hashes.push_back(statement->Value()->Hash());
+    return hashes;
+  }
   std::string Format() const {
     std::string res = "Module(";
 
@@ -20,6 +20,7 @@ enum ExpressionKind : int {
   If,
   Loop,
   Accessor,
+  Let,
 };
 
 struct Expression {
@@ -54,6 +55,7 @@ struct BlockExpression;
 struct IfExpression;
 struct LoopExpression;
 struct AccessorExpression;
+struct LetExpression;
 
 struct ExpressionNode {
   ExpressionNode() = delete;
@@ -82,6 +84,8 @@ struct ExpressionNode {
 
   auto AsAccessor() { return (AccessorExpression *)value; }
 
+  auto AsLet() { return (LetExpression *)value; }
+
   auto Node() const { return this; }
 
 private:
@@ -152,8 +156,8 @@ struct BinaryExpression : public Expression {
 
   BinaryExpression() = delete;
   BinaryExpression(std::shared_ptr<ExpressionNode> left,
-                   std::shared_ptr<ExpressionNode> right)
-      : left(std::move(left)), right(std::move(right)) {}
+                   std::shared_ptr<ExpressionNode> right, BinaryKind opKind)
+      : opKind(opKind), left(std::move(left)), right(std::move(right)) {}
 
   std::string Format() const override {
     switch (opKind) {
@@ -336,4 +340,33 @@ private:
   std::string accessor;
 };
 
+struct LetExpression : public Expression {
+  LetExpression() = delete;
+  LetExpression(std::string name, TypeNode *type, ExpressionNode *value,
+                bool isMutable)
+      : name(std::move(name)), type(type), value(value), isMutable(isMutable) {
+  }
+
+  std::string Format() const override {
+    auto res = std::string(isMutable ? "Var(" : "Val(") + name;
+    if (type)
+      res += " : " + type->Format();
+    return res + " = " + value->Format() + ")";
+  }
+
+  auto Name() const { return this->name; }
+  // Declared type, nullptr when it is left to inference.
+  auto Type() const { return this->type; }
+  auto Value() const { return this->value; }
+  auto IsMutable() const { return this->isMutable; }
+
+  ExpressionKind Kind() const override { return ExpressionKind::Let; }
+
+private:
+  std::string name;
+  TypeNode *type;
+  ExpressionNode *value;
+  bool isMutable;
+};
+
 } // namespace aatbe::parser
@@ -244,11 +244,14 @@ private:
 ParseResult<FunctionStatement *> ParseFunction(Parser &parser);
 ParseResult<ModuleStatementNode *> ParseModuleStatement(Parser &parser);
 ParseResult<TypeNode *> ParseType(Parser &parser);
+ParseResult<TypeNode *> ParseNumericType(Parser &parser);
 ParseResult<TerminalNode *> ParseTerminal(Parser &parser);
 ParseResult<ExpressionNode *> ParseExpression(Parser &tokens);
+ParseResult<ExpressionNode *> ParsePrimary(Parser &parser);
 ParseResult<ParameterBinding *> ParseParameter(Parser &parser);
 ParseResult<MemberList *> ParseMemberList(Parser &parser);
 ParseResult<StructStatement *> ParseStruct(Parser &parser);
 ParseResult<IdentifierTerm *> ParseIdentifier(Parser &parser);
+std::vector<std::string> ParseAttributes(Parser &parser);
 
 } // namespace aatbe::parser
\ No newline at end of file
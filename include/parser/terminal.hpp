@@ -48,12 +48,16 @@ private:
 };
 
 struct IntegerTerm : public Terminal {
-  explicit IntegerTerm(uint64_t value, TypeNode *type)
-      : kind(TerminalKind::Integer), value(value), type(type) {}
+  explicit IntegerTerm(uint64_t value, TypeNode *type, bool isImplicit = false)
+      : kind(TerminalKind::Integer), value(value), type(type),
+        isImplicit(isImplicit) {}
 
   uint64_t Value() const { return value; }
   TerminalKind Kind() const override { return this->kind; }
   TypeNode *Type() const { return type; }
+  // Whether the literal had no type suffix, its type is then inferred.
+  bool IsImplicit() const { return isImplicit; }
+  void SetType(TypeNode *inferred) { this->type = inferred; }
 
   std::string Format() const override { return std::to_string(value); }
 
@@ -61,6 +65,7 @@ private:
   TerminalKind kind;
   uint64_t value;
   TypeNode *type;
+  bool isImplicit;
 };
 
 struct CharTerm : public Terminal {
@@ -8,10 +8,7 @@
 #include <vector>
 #include <cassert>
 
-#include <llvm/IR/Type.h>
-#include <codegen.hpp>
-
-using namespace aatbe::codegen;
+#include <typesys/type_system.hpp>
 
 namespace aatbe::parser {
 
@@ -50,8 +47,6 @@ struct Type {
   virtual TypeKind Kind() const = 0;
   virtual TypeKind Value() const { return Kind(); }
   virtual std::string Format() const = 0;
-
-  virtual llvm::Type *LLVMType() = 0;
 };
 
 struct SIntType : public Type {
@@ -77,21 +72,6 @@ struct SIntType : public Type {
     }
   }
 
-  llvm::Type *LLVMType() override {
-    switch (kind) {
-    case TypeKind::Int8:
-      return llvm::Type::getInt8Ty(*LLVMContext);
-    case TypeKind::Int16:
-      return llvm::Type::getInt16Ty(*LLVMContext);
-    case TypeKind::Int32:
-      return llvm::Type::getInt32Ty(*LLVMContext);
-    case TypeKind::Int64:
-      return llvm::Type::getInt64Ty(*LLVMContext);
-    default:
-      return llvm::Type::getInt64Ty(*LLVMContext);
-    }
-  }
-
 private:
   TypeKind kind;
 };
@@ -119,21 +99,6 @@ struct UIntType : public Type {
     }
   }
 
-  llvm::Type *LLVMType() override {
-    switch (kind) {
-    case TypeKind::UInt8:
-      return llvm::Type::getInt8Ty(*LLVMContext);
-    case TypeKind::UInt16:
-      return llvm::Type::getInt16Ty(*LLVMContext);
-    case TypeKind::UInt32:
-      return llvm::Type::getInt32Ty(*LLVMContext);
-    case TypeKind::UInt64:
-      return llvm::Type::getInt64Ty(*LLVMContext);
-    default:
-      return llvm::Type::getInt64Ty(*LLVMContext);
-    }
-  }
-
 private:
   TypeKind kind;
 };
@@ -156,17 +121,6 @@ struct FloatType : public Type {
     }
   }
 
-  llvm::Type *LLVMType() override {
-    switch (kind) {
-    case TypeKind::Float32:
-      return llvm::Type::getFloatTy(*LLVMContext);
-    case TypeKind::Float64:
-      return llvm::Type::getDoubleTy(*LLVMContext);
-    default:
-      return llvm::Type::getFloatTy(*LLVMContext);
-    }
-  }
-
 private:
   TypeKind kind;
 };
@@ -179,8 +133,6 @@ struct TypenameType : public Type {
 
   std::string Format() const override { return name; }
 
-  llvm::Type *LLVMType() override { return GetCompilerContext()->GetStruct(this->name); }
-
 private:
   std::string name;
 };
@@ -191,10 +143,6 @@ struct BoolType : public Type {
   TypeKind Kind() const override { return TypeKind::Bool; }
 
   std::string Format() const override { return "bool"; }
-
-  llvm::Type *LLVMType() override {
-    return llvm::Type::getInt1Ty(*LLVMContext);
-  }
 };
 
 struct CharType : public Type {
@@ -204,9 +152,6 @@ struct CharType : public Type {
 
   std::string Format() const override { return "char"; }
 
-  llvm::Type *LLVMType() override {
-    return llvm::Type::getInt8Ty(*LLVMContext);
-  }
 };
 
 struct StrType : public Type {
@@ -216,9 +161,6 @@ struct StrType : public Type {
 
   std::string Format() const override { return "str"; }
 
-  llvm::Type *LLVMType() override {
-    return llvm::Type::getInt8PtrTy(*LLVMContext);
-  }
 };
 
 struct UnitType : public Type {
@@ -228,9 +170,6 @@ struct UnitType : public Type {
 
   std::string Format() const override { return "()"; }
 
-  llvm::Type *LLVMType() override {
-    return llvm::Type::getVoidTy(*LLVMContext);
-  }
 };
 
 struct SliceType;
@@ -247,8 +186,13 @@ public:
   TypeKind Kind() const { return value->Kind(); }
   auto Value() const { return value; }
   auto Format() const { return "Type(" + value->Format() + ")"; }
+  // The type as it is written in source, e.g. `ptr int64`.
+  std::string Source() const;
 
-  llvm::Type *LLVMType() { return value->LLVMType(); }
+  // Interned type this node denotes, assigned by semantic analysis.
+  auto Id() const { return this->id; }
+  bool HasId() const { return this->id.System() != nullptr; }
+  void SetId(typesys::TypeId typeId) { this->id = std::move(typeId); }
 
   auto AsSInt() const { return (SIntType *)value; }
 
@@ -276,10 +220,11 @@ public:
 
 private:
   Type *value;
+  typesys::TypeId id{};
 };
 
 struct SliceType : public Type {
-  explicit SliceType(const TypeNode *type) : type(type) {}
+  explicit SliceType(TypeNode *type) : type(type) {}
 
   TypeKind Kind() const override { return TypeKind::Slice; }
   auto Inner() const { return this->type; }
@@ -288,16 +233,12 @@ struct SliceType : public Type {
     return "[" + this->type->Format() + "]";
   }
 
-  llvm::Type *LLVMType() override {
-    return llvm::Type::getVoidTy(*LLVMContext);
-  }
-
 private:
-  const TypeNode *type;
+  TypeNode *type;
 };
 
 struct ArrayType : public Type {
-  ArrayType(const TypeNode *type, uint64_t size) : type(type), size(size) {}
+  ArrayType(TypeNode *type, uint64_t size) : type(type), size(size) {}
 
   TypeKind Kind() const override { return TypeKind::Array; }
   auto Inner() const { return this->type; }
@@ -307,29 +248,21 @@ struct ArrayType : public Type {
     return "[" + this->type->Format() + "; " + std::to_string(this->size) + "]";
   }
 
-  llvm::Type *LLVMType() override {
-    return llvm::Type::getVoidTy(*LLVMContext);
-  }
-
 private:
-  const TypeNode *type;
+  TypeNode *type;
   uint64_t size;
 };
 
 struct RefType : public Type {
-  explicit RefType(const TypeNode *type) : type(type) {}
+  explicit RefType(TypeNode *type) : type(type) {}
 
   TypeKind Kind() const override { return TypeKind::Ref; }
   auto Inner() const { return this->type; }
 
   std::string Format() const override { return "ref " + this->type->Format(); }
 
-  llvm::Type *LLVMType() override {
-    return llvm::Type::getVoidTy(*LLVMContext);
-  }
-
 private:
-  const TypeNode *type;
+  TypeNode *type;
 };
 
 struct PointerType : public Type {
@@ -340,10 +273,6 @@ struct PointerType : public Type {
 
   std::string Format() const override { return "ptr " + this->type->Format(); }
 
-  llvm::Type *LLVMType() override {
-    return llvm::PointerType::get(this->type->LLVMType(), 0);
-  }
-
 private:
   TypeNode *type;
 };
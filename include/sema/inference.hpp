@@ -0,0 +1,111 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <parser/ast.hpp>
+#include <typesys/type_system.hpp>
+#include <typesys/unify.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aatbe::sema {
+
+using namespace aatbe::parser;
+using namespace aatbe::typesys;
+
+struct TypeError {
+  std::string function;
+  std::string message;
+
+  std::string Format() const {
+    return function.empty() ? message : "in " + function + ": " + message;
+  }
+};
+
+// TypeInference is a Hindley-Milner style pass without generalization: every
+// expression gets a type, unknown types are fresh variables and constraints
+// are solved on the fly by a typesys::Unifier. It infers the width of
+// untyped integer literals and the types of `val`/`var` bindings.
+//
+// After InferModule the inferred types of implicit integer literals are
+// written back into the AST so code generation sees concrete types.
+class TypeInference {
+public:
+  explicit TypeInference(TypeSystem &types) : types(types), unifier(types) {}
+  TypeInference(TypeInference &&) = delete;
+  TypeInference(TypeInference const &) = delete;
+  TypeInference &operator=(TypeInference const &) = delete;
+
+  bool InferModule(ModuleNode *mod);
+
+  // Infers `statements` after everything inferred so far, e.g. the input of
+  // a REPL. A function may be redefined with the type it had, a struct may
+  // not be redefined. On errors the statements' declarations are forgotten.
+  bool InferStatements(const std::vector<ModuleStatementNode *> &statements);
+
+  // Infers a function without parameters whose return type is the type of
+  // its body, e.g. an expression typed into a REPL, and records that
+  // signature on the declaration. The function is not declared by name.
+  bool InferExpression(FunctionStatement *decl);
+
+  // Resolved type of an expression visited by InferModule.
+  TypeId TypeOf(const ExpressionNode *expr) const;
+  // Resolved type of a `val`/`var` binding.
+  TypeId TypeOf(const LetExpression *let) const;
+
+  // Interns a type annotation and records the TypeId on the node.
+  TypeId LowerType(TypeNode *type);
+
+  const std::vector<TypeError> &Errors() const { return errors; }
+
+private:
+  TypeId InternType(const TypeNode *type);
+
+  void DeclareStruct(StructStatement *decl);
+  void DeclareFunction(FunctionStatement *decl);
+  void InferFunction(FunctionStatement *decl);
+
+  TypeId Infer(ExpressionNode *expr);
+  TypeId InferAtom(AtomExpression *atom);
+  TypeId InferUnary(UnaryExpression *unary);
+  TypeId InferBinary(BinaryExpression *binary);
+  TypeId InferCall(CallExpression *call);
+  TypeId InferIf(IfExpression *ifExpr);
+  TypeId InferBlock(BlockExpression *block);
+  TypeId InferLet(LetExpression *let);
+
+  void Expect(TypeId const &actual, TypeId const &expected,
+              const std::string &what);
+  void Error(std::string message);
+  std::string Describe(TypeId const &id);
+
+  std::optional<TypeId> Lookup(const std::string &name);
+
+  void WriteBackLiterals();
+  // Writes back literals and substitutes the types inferred since the last
+  // call.
+  void Finish();
+
+  TypeSystem &types;
+  Unifier unifier;
+
+  std::unordered_map<std::string, TypeId> structs{};
+  std::unordered_map<std::string, TypeId> functions{};
+  std::vector<std::unordered_map<std::string, TypeId>> scopes{};
+
+  std::unordered_map<const ExpressionNode *, TypeId> exprTypes{};
+  std::unordered_map<const LetExpression *, TypeId> letTypes{};
+  std::vector<std::pair<IntegerTerm *, TypeId>> literals{};
+  // Expressions and bindings typed since the last Finish.
+  std::vector<const ExpressionNode *> pendingExprs{};
+  std::vector<const LetExpression *> pendingLets{};
+
+  std::string currentFunction{};
+  std::vector<TypeError> errors{};
+};
+
+} // namespace aatbe::sema
@@ -0,0 +1,100 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <parser/ast.hpp>
+#include <sema/inference.hpp>
+
+#include <llvm/ADT/DenseMap.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aatbe::sema {
+
+using namespace aatbe::parser;
+
+// What an identifier refers to. `index` is the position of the function in
+// the module, the parameter number, or the local slot of a `val`/`var`.
+struct Symbol {
+  enum class Kind : uint8_t {
+    Function,
+    Parameter,
+    Local,
+  };
+
+  Kind kind;
+  uint32_t index;
+};
+
+// Side tables for one function body. They are keyed by node, so codegen can
+// look up what an identifier or call site refers to without any name lookup.
+struct FunctionInfo {
+  FunctionStatement *decl;
+  // Identifier atoms, including callees of direct calls.
+  llvm::DenseMap<const ExpressionNode *, Symbol> uses{};
+  // Local slot defined by each `val`/`var`.
+  llvm::DenseMap<const LetExpression *, uint32_t> locals{};
+  uint32_t localCount = 0;
+
+  std::vector<TypeError> errors{};
+
+  const Symbol &Use(const ExpressionNode *node) const {
+    auto it = uses.find(node);
+    assert(it != uses.end() && "identifier was not resolved");
+    return it->second;
+  }
+};
+
+// Resolver binds every identifier in a module to a Symbol. Module level
+// functions are collected first; function bodies only read that table and
+// write their own FunctionInfo, so they are resolved independently and, with
+// `threads > 1`, in parallel.
+class Resolver {
+public:
+  Resolver() = default;
+  Resolver(Resolver &&) = delete;
+  Resolver(Resolver const &) = delete;
+  Resolver &operator=(Resolver const &) = delete;
+
+  bool ResolveModule(ModuleNode *mod, unsigned threads = 1);
+
+  // Resolves `statements` after everything resolved so far, e.g. the input
+  // of a REPL. With `redefine`, a function may replace an earlier one of the
+  // same name: later lookups see the new function, bodies resolved before
+  // keep the index they were resolved to. On errors nothing is added.
+  bool ResolveStatements(const std::vector<ModuleStatementNode *> &statements,
+                         bool redefine = false);
+
+  // Forgets the functions added after the first `count`, restoring the
+  // functions they replaced.
+  void Truncate(size_t count);
+
+  // Functions in module order, indexed by Symbol::index.
+  auto &Functions() const { return this->functions; }
+  std::optional<uint32_t> FunctionIndex(const std::string &name) const;
+
+  const FunctionInfo &Info(uint32_t function) const {
+    return *this->infos[function];
+  }
+
+  std::vector<TypeError> Errors() const;
+
+private:
+  void ResolveFunction(FunctionInfo &info) const;
+  void Declare(const std::vector<ModuleStatementNode *> &statements,
+               bool redefine);
+
+  std::vector<FunctionStatement *> functions{};
+  std::unordered_map<std::string, uint32_t> functionIndex{};
+  // For each function, the index its name referred to before, if any.
+  std::vector<std::optional<uint32_t>> replaced{};
+  std::vector<std::unique_ptr<FunctionInfo>> infos{};
+  std::vector<TypeError> errors{};
+};
+
+} // namespace aatbe::sema
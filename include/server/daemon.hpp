@@ -0,0 +1,58 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <server/protocol.hpp>
+
+#include <llvm/Support/Error.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+
+namespace aatbe::server {
+
+// The server of `lang --daemon`: accepts requests on a Unix domain socket
+// and passes them to a handler, which keeps whatever it likes warm between
+// requests, see Request for the protocol.
+//
+// A request runs as if it were its own `lang` process: while the handler
+// runs, the client's descriptors are the daemon's stdin, stdout and stderr,
+// and its directory the working directory. Both belong to the whole
+// process, so requests are served one at a time.
+class Daemon {
+public:
+  using Handler = std::function<int(const Request &)>;
+
+  Daemon(std::string path, Handler handler)
+      : path(std::move(path)), handler(std::move(handler)) {}
+  Daemon(Daemon &&) = delete;
+  Daemon(Daemon const &) = delete;
+  Daemon &operator=(Daemon const &) = delete;
+  ~Daemon();
+
+  // Binds the socket. A socket left behind by a daemon that is gone is
+  // replaced, one another daemon listens on is an error.
+  llvm::Error Listen();
+
+  // Serves requests until Stop is called, from a handler or any thread.
+  // Connections from other users are closed unanswered.
+  void Serve();
+  void Stop();
+
+  auto &Path() const { return this->path; }
+  size_t Served() const { return this->served; }
+
+private:
+  void Handle(int client);
+
+  std::string path;
+  Handler handler;
+  int listener = -1;
+  std::atomic<bool> stopping = false;
+  std::atomic<size_t> served = 0;
+};
+
+} // namespace aatbe::server
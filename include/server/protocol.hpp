@@ -0,0 +1,51 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace aatbe::server {
+
+// A request to `lang --daemon`: the arguments `lang` would have been run
+// with, without the program name, the client's working directory and its
+// stdin, stdout and stderr.
+//
+// On the socket, a request is its size as a 32-bit integer followed by the
+// number of strings and every string, arguments first and the directory
+// last, each prefixed with its size. The descriptors travel as SCM_RIGHTS
+// with the first message. The daemon answers with the exit status as a
+// 32-bit integer once the request is done.
+struct Request {
+  std::vector<std::string> Args{};
+  std::string Directory{};
+  std::array<int, 3> Descriptors{-1, -1, -1};
+};
+
+// $AATBE_SOCKET when set, otherwise aatbe.sock in $XDG_RUNTIME_DIR,
+// otherwise /tmp/aatbe-<uid>.sock.
+std::string DefaultSocketPath();
+
+// Whether the process at the other end of the connected socket `fd` runs
+// as this user. The daemon runs whatever it is sent with the user's rights,
+// and the client hands it its stdio, so both check before a request.
+bool SameUser(int fd);
+
+// Send and receive over the connected socket `fd`. They return false on
+// errors, with errno set. Received descriptors belong to the caller.
+bool SendRequest(int fd, const Request &request);
+bool ReceiveRequest(int fd, Request &request);
+bool SendStatus(int fd, int status);
+bool ReceiveStatus(int fd, int &status);
+
+// Runs `args` on the daemon listening at `path`, with this process's
+// working directory, stdin, stdout and stderr, and returns the exit status.
+// Returns -1 and describes the failure in `error` when the daemon cannot be
+// reached or goes away.
+int Forward(const std::string &path, const std::vector<std::string> &args,
+            std::string &error);
+
+} // namespace aatbe::server
@@ -15,9 +15,11 @@ public:
 
   static std::unique_ptr<SrcFile> FromString(std::string &content);
   static std::unique_ptr<SrcFile> FromString(const char *content);
+  // Null when the file cannot be opened.
   static std::unique_ptr<SrcFile> FromFile(const std::string &path);
 
   char Char(size_t at);
+  const std::string &Content() const { return *content; }
 
   bool Contains(size_t at, const char *str);
   bool Contains(size_t at, std::string str);
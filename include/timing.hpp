@@ -0,0 +1,76 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <llvm/ADT/STLFunctionalExtras.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <atomic>
+#include <string>
+
+namespace aatbe::timing {
+
+// Where compile time goes, for `-ftime-report` and `-ftime-trace`. Phases
+// of the compiler are wrapped in a Scope; while recording, every thread
+// keeps a log of the scopes it ran, which Report sums up by name and
+// WriteTrace writes as a Chrome trace.
+//
+// While not recording, a Scope is a relaxed load and a branch.
+
+namespace detail {
+extern std::atomic<bool> recording;
+} // namespace detail
+
+inline bool Recording() {
+  return detail::recording.load(std::memory_order_relaxed);
+}
+
+// Starts recording, dropping whatever was recorded before.
+void Start();
+// Stops recording. Scopes still open are not recorded.
+void Stop();
+
+// Opens and closes a scope on the calling thread; scopes nest. Only call
+// them while recording, End matches the Begin it follows on its thread.
+void Begin(llvm::StringRef name, std::string detail = {});
+void End();
+
+class Scope {
+public:
+  explicit Scope(llvm::StringRef name) : open(Recording()) {
+    if (open)
+      Begin(name);
+  }
+  // `detail`, e.g. the name of a function, is only computed while
+  // recording.
+  Scope(llvm::StringRef name, llvm::function_ref<std::string()> detail)
+      : open(Recording()) {
+    if (open)
+      Begin(name, detail());
+  }
+  Scope(Scope &&) = delete;
+  Scope(Scope const &) = delete;
+  Scope &operator=(Scope const &) = delete;
+  ~Scope() {
+    if (open)
+      End();
+  }
+
+private:
+  bool open;
+};
+
+// Prints, for every scope name, the time spent in it over all threads and
+// how often it ran, longest first. The time of a scope includes the scopes
+// nested in it.
+void Report(llvm::raw_ostream &os);
+
+// Writes every scope recorded as a complete event of a Chrome trace, for
+// chrome://tracing or Perfetto, with a track per thread.
+llvm::Error WriteTrace(const std::string &path);
+
+} // namespace aatbe::timing
@@ -0,0 +1,88 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <typesys/type_system.hpp>
+
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace aatbe::typesys {
+
+struct FieldLayout {
+  // Index of the field in declaration order.
+  size_t index;
+  uint64_t offset;
+  uint64_t size;
+};
+
+// Size, alignment and (for structs) field placement of a type. Fields are
+// listed in memory order, which only differs from declaration order for
+// `@reorder` structs.
+struct TypeLayout {
+  uint64_t size;
+  uint64_t align;
+  std::vector<FieldLayout> fields{};
+
+  // Bytes lost to inter-field and tail padding.
+  uint64_t Padding() const {
+    uint64_t used = 0;
+    for (auto &field : fields)
+      used += field.size;
+    return fields.empty() ? 0 : size - used;
+  }
+
+  const FieldLayout &Field(size_t declIndex) const {
+    for (auto &field : fields)
+      if (field.index == declIndex)
+        return field;
+    assert(false && "no such field");
+    return fields[0];
+  }
+};
+
+// Returns the order in which fields of the given sizes and alignments should
+// be placed to minimize padding: decreasing alignment, then decreasing size,
+// keeping declaration order among equals.
+std::vector<size_t>
+PackedFieldOrder(std::vector<std::pair<uint64_t, uint64_t>> const &sizeAlign);
+
+// LayoutEngine computes type layouts for a target DataLayout and caches them
+// by TypeId. Struct layouts are computed on first request, so all fields must
+// have been added to a struct before its layout is queried.
+class LayoutEngine {
+public:
+  LayoutEngine(TypeSystem &types, llvm::DataLayout layout)
+      : types(types), layout(std::move(layout)) {}
+  LayoutEngine(LayoutEngine &&) = delete;
+  LayoutEngine(LayoutEngine const &) = delete;
+  LayoutEngine &operator=(LayoutEngine const &) = delete;
+
+  const TypeLayout &Get(TypeId const &id);
+
+  uint64_t SizeOf(TypeId const &id) { return Get(id).size; }
+  uint64_t AlignOf(TypeId const &id) { return Get(id).align; }
+
+  const llvm::DataLayout &DataLayout() const { return layout; }
+
+private:
+  TypeLayout Compute(TypeId const &id);
+  TypeLayout ComputeStruct(StructType *type);
+  TypeLayout Primitive(llvm::Type *type) const;
+
+  TypeSystem &types;
+  llvm::DataLayout layout;
+  // Only used to ask the DataLayout about primitive LLVM types.
+  llvm::LLVMContext context{};
+
+  std::vector<std::unique_ptr<TypeLayout>> cache{};
+  std::vector<bool> inProgress{};
+};
+
+} // namespace aatbe::typesys
@@ -11,6 +11,14 @@
 #include <utility>
 #include <unordered_map>
 #include <functional>
+#include <concepts>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
 
 namespace aatbe::typesys {
 
@@ -20,6 +28,9 @@ concept Derived = std::is_base_of<U, T>::value;
 class BaseType;
 class TypeSystem;
 
+// TypeId is an index into the type table of the TypeSystem that created it.
+// Ids are dense and local to their system: the first type added to a system
+// is 0, the next is 1 and so on.
 struct TypeId {
   size_t value;
 
@@ -27,15 +38,14 @@ struct TypeId {
 
   TypeId(TypeId &&tid) = default;
   TypeId(TypeId const &) = default;
-  TypeId &operator=(TypeId const &) = delete;
+  TypeId &operator=(TypeId const &) = default;
 
-  TypeId() : value(0) {}
+  TypeId() : value(0), type_system(nullptr) {}
   TypeId(TypeSystem *type_system, size_t value)
       : value(value), type_system(type_system) {}
 
-  static TypeId GetNext(TypeSystem *ts);
-
   auto Value() const { return value; }
+  auto System() const { return type_system; }
 
   template <Derived<BaseType> T> T *Resolve() const;
 
@@ -47,11 +57,24 @@ private:
   TypeSystem *type_system;
 };
 
-bool operator==(const TypeId &lhs, const TypeId &rhs) {
+inline bool operator==(const TypeId &lhs, const TypeId &rhs) {
   return lhs.value == rhs.value;
 }
 
-}
+// TypeKey is the structural identity of an interned type: its kind plus the
+// operands that distinguish it from other types of the same kind (widths,
+// signedness, element types, ...). Two types with equal keys are the same
+// type and share a single TypeId.
+struct TypeKey {
+  int kind;
+  std::vector<size_t> operands;
+
+  bool operator==(TypeKey const &rhs) const {
+    return kind == rhs.kind && operands == rhs.operands;
+  }
+};
+
+} // namespace aatbe::typesys
 
 namespace std {
 
@@ -60,7 +83,17 @@ template <> struct hash<aatbe::typesys::TypeId> {
     return std::hash<size_t>{}(tid.value);
   }
 };
-}
+
+template <> struct hash<aatbe::typesys::TypeKey> {
+  std::size_t operator()(aatbe::typesys::TypeKey const &key) const noexcept {
+    auto seed = std::hash<int>{}(key.kind);
+    for (auto operand : key.operands)
+      seed ^= std::hash<size_t>{}(operand) + 0x9e3779b9 + (seed << 6) +
+              (seed >> 2);
+    return seed;
+  }
+};
+} // namespace std
 
 namespace aatbe::typesys {
 
@@ -72,10 +105,10 @@ enum TypeKind {
   TyChar,
   TyUnit,
   TyArray,
-  // TODO: function type
   TyFunction,
   TyPointer,
   TyVoid,
+  TyVar,
   TyUnknown
 };
 
@@ -91,23 +124,29 @@ public:
   virtual TypeKind Kind() const = 0;
 };
 
+// Type is the compact record stored in a TypeSystem's type table. The kind
+// tag is cached next to the owning pointer so that As<T> can check it without
+// touching the type itself or going through RTTI.
 class Type {
 public:
   Type() = delete;
-  Type(Type &&) = delete;
+  Type(Type &&) = default;
   Type(Type const &) = delete;
+  Type &operator=(Type &&) = default;
   Type &operator=(Type const &) = delete;
 
   template <Derived<BaseType> T>
-  explicit Type(T *type) : type(std::move(type)) {}
+  explicit Type(T *type) : kind(type->Kind()), type(type) {}
 
-  TypeKind Kind() const { return this->type->Kind(); }
+  TypeKind Kind() const { return this->kind; }
 
   template <Derived<BaseType> T> T *As() {
-    return dynamic_cast<T *>(this->type.get());
+    return this->kind == T::StaticKind ? static_cast<T *>(this->type.get())
+                                       : nullptr;
   }
 
 private:
+  TypeKind kind;
   std::unique_ptr<BaseType> type;
 };
 
@@ -118,22 +157,38 @@ public:
   StructType(StructType const &) = delete;
   StructType &operator=(StructType const &) = delete;
 
-  explicit StructType(std::string name) : name(std::move(name)) {}
+  explicit StructType(std::string name, bool reorder = false)
+      : name(std::move(name)), reorder(reorder) {}
 
   std::string Name() const { return this->name; }
   size_t Size() const { return this->fields.size(); }
+  // Fields in declaration order.
   auto &Fields() const { return this->fields; }
 
+  // When set, the layout engine is free to reorder fields to minimize
+  // padding instead of keeping declaration order (`@reorder`).
+  bool Reorder() const { return this->reorder; }
+  void SetReorder(bool value) { this->reorder = value; }
+
   void AddField(std::string &&name, TypeId type) {
-    this->fields.emplace(std::move(name), type);
+    this->index.emplace(name, this->fields.size());
+    this->fields.emplace_back(std::move(name), type);
+  }
+  auto GetField(std::string const &name) const {
+    return this->fields[this->index.at(name)].second;
+  }
+  auto FieldIndex(std::string const &name) const {
+    return this->index.at(name);
   }
-  auto GetField(std::string const &name) const { return this->fields.at(name); }
 
-  TypeKind Kind() const override { return TypeKind::TyStruct; }
+  static constexpr TypeKind StaticKind = TypeKind::TyStruct;
+  TypeKind Kind() const override { return StaticKind; }
 
 private:
   std::string name;
-  std::unordered_map<std::string, TypeId> fields;
+  bool reorder;
+  std::vector<std::pair<std::string, TypeId>> fields;
+  std::unordered_map<std::string, size_t> index;
 };
 
 class IntType : public BaseType {
@@ -152,10 +207,15 @@ public:
 
   IntType(IntSize size, bool sign = true) : size(size), sign(sign) {}
 
+  static TypeKey Key(IntSize size, bool sign = true) {
+    return {TypeKind::TyInt, {(size_t)size, sign}};
+  }
+
   IntSize Size() const { return this->size; }
   bool Signed() const { return this->sign; }
 
-  TypeKind Kind() const override { return TypeKind::TyInt; }
+  static constexpr TypeKind StaticKind = TypeKind::TyInt;
+  TypeKind Kind() const override { return StaticKind; }
 
 private:
   IntSize size;
@@ -176,9 +236,14 @@ public:
 
   explicit FloatType(FloatSize size) : size(size) {}
 
+  static TypeKey Key(FloatSize size) {
+    return {TypeKind::TyFloat, {(size_t)size}};
+  }
+
   FloatSize Size() const { return this->size; }
 
-  TypeKind Kind() const override { return TypeKind::TyFloat; }
+  static constexpr TypeKind StaticKind = TypeKind::TyFloat;
+  TypeKind Kind() const override { return StaticKind; }
 
 private:
   FloatSize size;
@@ -192,7 +257,10 @@ public:
 
   explicit BoolType() {}
 
-  TypeKind Kind() const override { return TypeKind::TyBool; }
+  static TypeKey Key() { return {TypeKind::TyBool, {}}; }
+
+  static constexpr TypeKind StaticKind = TypeKind::TyBool;
+  TypeKind Kind() const override { return StaticKind; }
 };
 
 class CharType : public BaseType {
@@ -203,7 +271,10 @@ public:
 
   explicit CharType() {}
 
-  TypeKind Kind() const override { return TypeKind::TyChar; }
+  static TypeKey Key() { return {TypeKind::TyChar, {}}; }
+
+  static constexpr TypeKind StaticKind = TypeKind::TyChar;
+  TypeKind Kind() const override { return StaticKind; }
 };
 
 class UnitType : public BaseType {
@@ -214,7 +285,10 @@ public:
 
   explicit UnitType() {}
 
-  TypeKind Kind() const override { return TypeKind::TyUnit; }
+  static TypeKey Key() { return {TypeKind::TyUnit, {}}; }
+
+  static constexpr TypeKind StaticKind = TypeKind::TyUnit;
+  TypeKind Kind() const override { return StaticKind; }
 };
 
 class ArrayType : public BaseType {
@@ -226,10 +300,15 @@ public:
 
   ArrayType(TypeId type, size_t size) : type(type), size(size) {}
 
+  static TypeKey Key(TypeId const &type, size_t size) {
+    return {TypeKind::TyArray, {type.Value(), size}};
+  }
+
   TypeId Type() const { return this->type; }
   size_t Size() const { return this->size; }
 
-  TypeKind Kind() const override { return TypeKind::TyArray; }
+  static constexpr TypeKind StaticKind = TypeKind::TyArray;
+  TypeKind Kind() const override { return StaticKind; }
 
 private:
   TypeId type;
@@ -245,14 +324,50 @@ public:
 
   explicit PointerType(TypeId type) : type(type) {}
 
+  static TypeKey Key(TypeId const &type) {
+    return {TypeKind::TyPointer, {type.Value()}};
+  }
+
   TypeId Type() const { return this->type; }
 
-  TypeKind Kind() const override { return TypeKind::TyPointer; }
+  static constexpr TypeKind StaticKind = TypeKind::TyPointer;
+  TypeKind Kind() const override { return StaticKind; }
 
 private:
   TypeId type;
 };
 
+class FunctionType : public BaseType {
+public:
+  FunctionType() = delete;
+  FunctionType(FunctionType &&) = delete;
+  FunctionType(FunctionType const &) = delete;
+  FunctionType &operator=(FunctionType const &) = delete;
+
+  FunctionType(TypeId ret, std::vector<TypeId> params, bool variadic = false)
+      : ret(ret), params(std::move(params)), variadic(variadic) {}
+
+  static TypeKey Key(TypeId const &ret, std::vector<TypeId> const &params,
+                     bool variadic = false) {
+    TypeKey key{TypeKind::TyFunction, {ret.Value(), variadic}};
+    for (auto &param : params)
+      key.operands.push_back(param.Value());
+    return key;
+  }
+
+  TypeId Return() const { return this->ret; }
+  auto &Params() const { return this->params; }
+  bool Variadic() const { return this->variadic; }
+
+  static constexpr TypeKind StaticKind = TypeKind::TyFunction;
+  TypeKind Kind() const override { return StaticKind; }
+
+private:
+  TypeId ret;
+  std::vector<TypeId> params;
+  bool variadic;
+};
+
 class VoidType : public BaseType {
 public:
   VoidType(VoidType &&) = delete;
@@ -261,7 +376,24 @@ public:
 
   explicit VoidType() {}
 
-  TypeKind Kind() const override { return TypeKind::TyVoid; }
+  static TypeKey Key() { return {TypeKind::TyVoid, {}}; }
+
+  static constexpr TypeKind StaticKind = TypeKind::TyVoid;
+  TypeKind Kind() const override { return StaticKind; }
+};
+
+// Placeholder for a type that is not known yet, solved by typesys::Unifier.
+// Type variables are never interned: every Create gives a fresh variable.
+class TypeVarType : public BaseType {
+public:
+  TypeVarType(TypeVarType &&) = delete;
+  TypeVarType(TypeVarType const &) = delete;
+  TypeVarType &operator=(TypeVarType const &) = delete;
+
+  explicit TypeVarType() {}
+
+  static constexpr TypeKind StaticKind = TypeKind::TyVar;
+  TypeKind Kind() const override { return StaticKind; }
 };
 
 class UnknownType : public BaseType {
@@ -272,9 +404,31 @@ public:
 
   explicit UnknownType() {}
 
-  TypeKind Kind() const override { return TypeKind::TyUnknown; }
+  static TypeKey Key() { return {TypeKind::TyUnknown, {}}; }
+
+  static constexpr TypeKind StaticKind = TypeKind::TyUnknown;
+  TypeKind Kind() const override { return StaticKind; }
 };
 
+// Structural types (ints, floats, pointers, arrays, functions, ...) expose a
+// static Key() and are hash-consed by TypeSystem::Create, so every shape maps
+// to exactly one TypeId. Nominal types such as StructType have no key and get
+// a fresh TypeId on every Create.
+template <class T, typename... Args>
+concept Interned = requires(Args &&...args) {
+                     { T::Key(args...) } -> std::same_as<TypeKey>;
+                   };
+
+// TypeSystem is safe to use from many threads at once. Types live in an
+// append-only table made of segments that double in size and never move, so
+// resolving a published TypeId is a couple of plain loads and never blocks.
+// A type is published once it and every type added before it are
+// constructed; Count is the number of published types.
+// Interning goes through a sharded table keyed by TypeKey; threads creating
+// different shapes rarely touch the same shard.
+//
+// Mutating a type after it was created (StructType::AddField) is not
+// synchronized and must happen before the type is shared between threads.
 class TypeSystem {
 public:
   TypeSystem() = default;
@@ -282,21 +436,79 @@ public:
   TypeSystem(TypeSystem const &) = delete;
   TypeSystem &operator=(TypeSystem const &) = delete;
 
-  TypeId AddType(Type *type) {
-    auto id = TypeId::GetNext(this);
-    this->types.emplace(id, type);
-    return id;
-  }
+  ~TypeSystem();
 
-  Type *GetType(TypeId id) { return this->types.at(id); }
+  TypeId AddType(Type &&type);
+
+  Type *GetType(TypeId const &id) {
+    assert(id.System() == this);
+    if (id.Value() >= this->Count())
+      throw std::out_of_range("TypeId out of range");
+    return this->Slot(id.Value());
+  }
 
   template <Derived<BaseType> T, typename... Args>
   TypeId Create(Args &&...args) {
-    return this->AddType(new Type(new T(args...)));
+    if constexpr (Interned<T, Args...>) {
+      auto key = T::Key(args...);
+      auto &shard = this->shards[std::hash<TypeKey>{}(key) % ShardCount];
+
+      {
+        std::shared_lock lock(shard.mutex);
+        if (auto it = shard.interned.find(key); it != shard.interned.end())
+          return it->second;
+      }
+
+      std::unique_lock lock(shard.mutex);
+      if (auto it = shard.interned.find(key); it != shard.interned.end())
+        return it->second;
+
+      auto id = this->AddType(Type(new T(args...)));
+      shard.interned.emplace(std::move(key), id);
+      return id;
+    } else {
+      return this->AddType(Type(new T(args...)));
+    }
+  }
+
+  size_t Count() const {
+    return this->published.load(std::memory_order_acquire);
   }
 
 private:
-  std::unordered_map<TypeId, Type *> types{};
+  static constexpr size_t FirstSegmentBits = 6;
+  static constexpr size_t SegmentCount = 48;
+  static constexpr size_t ShardCount = 64;
+
+  struct alignas(64) Shard {
+    std::shared_mutex mutex{};
+    std::unordered_map<TypeKey, TypeId> interned{};
+  };
+
+  // Segment s holds 2^(FirstSegmentBits + s) types; maps a dense index to
+  // its segment and the offset inside it.
+  static std::pair<size_t, size_t> Locate(size_t index) {
+    auto biased = index + ((size_t)1 << FirstSegmentBits);
+    auto msb = (size_t)std::bit_width(biased) - 1;
+    return {msb - FirstSegmentBits, biased - ((size_t)1 << msb)};
+  }
+
+  Type *Slot(size_t index) const {
+    auto [segment, offset] = Locate(index);
+    return this->segments[segment].load(std::memory_order_acquire) + offset;
+  }
+
+  Type *Segment(size_t segment);
+
+  // Indices handed out, and the types constructed in order of index.
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> published{0};
+  std::array<std::atomic<Type *>, SegmentCount> segments{};
+  std::array<Shard, ShardCount> shards{};
 };
 
+template <Derived<BaseType> T> T *TypeId::Resolve() const {
+  return type_system->GetType(*this)->As<T>();
+}
+
 } // namespace aatbe::typesys
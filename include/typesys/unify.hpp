@@ -0,0 +1,62 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <typesys/type_system.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace aatbe::typesys {
+
+// Unifier solves equality constraints between types with a union-find over
+// TypeIds. Since TypeIds are dense the forest is a plain vector indexed by
+// id; Find compresses paths and variables are merged by rank, so a sequence
+// of n unifications runs in near linear time.
+//
+// A variable can be restricted to integer types (for untyped integer
+// literals). Such variables only unify with IntType and default to int64
+// when nothing else constrains them.
+class Unifier {
+public:
+  enum class VarClass : uint8_t {
+    Any,
+    Integer,
+  };
+
+  explicit Unifier(TypeSystem &types) : types(types) {}
+  Unifier(Unifier &&) = delete;
+  Unifier(Unifier const &) = delete;
+  Unifier &operator=(Unifier const &) = delete;
+
+  TypeId Fresh(VarClass varClass = VarClass::Any);
+
+  // Representative of the equivalence class of `id`.
+  TypeId Find(TypeId const &id);
+
+  // Makes `lhs` and `rhs` the same type, returns false when they can not be.
+  bool Unify(TypeId const &lhs, TypeId const &rhs);
+
+  // Fully substituted type of `id`, with integer literal variables defaulted.
+  // Variables that remain unconstrained are returned as is.
+  TypeId Resolve(TypeId const &id);
+
+  bool IsVar(TypeId const &id) {
+    return types.GetType(Find(id))->Kind() == TypeKind::TyVar;
+  }
+
+private:
+  void Track(size_t index);
+  bool Bind(TypeId const &var, TypeId const &type);
+  bool Occurs(TypeId const &var, TypeId const &type);
+
+  TypeSystem &types;
+
+  std::vector<size_t> parent{};
+  std::vector<uint8_t> rank{};
+  std::vector<VarClass> classes{};
+};
+
+} // namespace aatbe::typesys
@@ -0,0 +1,148 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+// Replaces the global operator new and delete, so that every heap allocation
+// is counted against the phase that made it, see accounting. Linked into the
+// lang driver; a program embedding the compiler can link it in as well.
+//
+// Every block comes after a header telling its size, the phase and epoch it
+// was counted in and how far before it the block from malloc starts, so that
+// it can be released in whichever phase. Blocks allocated while not
+// counting, or in an earlier epoch, are released without being counted.
+
+#include <accounting.hpp>
+
+#include <llvm/Support/MathExtras.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+using namespace aatbe;
+
+namespace {
+
+struct alignas(16) Header {
+  size_t size;
+  uint32_t epoch;
+  // The offset is a power of two, as alignments are, of any size.
+  uint8_t offsetLog2;
+  uint8_t phase;
+  bool counted;
+};
+static_assert(sizeof(Header) == 16);
+
+const bool registered = (accounting::detail::interposed = true);
+
+} // namespace
+
+static void *Allocate(size_t size, size_t align) {
+  align = std::max(align, alignof(Header));
+  // The header sits right before the block, the offset keeps it aligned.
+  auto offset = std::max(sizeof(Header), align);
+  // Neither the header nor rounding up to the alignment may wrap around.
+  if (offset > SIZE_MAX - align || size > SIZE_MAX - offset - align)
+    return nullptr;
+  void *base;
+  if (align <= alignof(std::max_align_t))
+    base = std::malloc(offset + size);
+  else
+    base = std::aligned_alloc(align,
+                              (offset + size + align - 1) & ~(align - 1));
+  if (!base)
+    return nullptr;
+
+  auto block = (char *)base + offset;
+  auto header = (Header *)block - 1;
+  header->size = size;
+  header->offsetLog2 = (uint8_t)llvm::Log2_64(offset);
+  header->counted = accounting::Counting();
+  if (header->counted) {
+    auto phase = accounting::Current();
+    header->phase = (uint8_t)phase;
+    header->epoch = accounting::Epoch();
+    accounting::Allocated(phase, size);
+  }
+  return block;
+}
+
+static void Release(void *block) {
+  if (!block)
+    return;
+  auto header = (Header *)block - 1;
+  if (header->counted && accounting::Counting() &&
+      header->epoch == accounting::Epoch())
+    accounting::Released((accounting::Phase)header->phase, header->size);
+  std::free((char *)block - ((size_t)1 << header->offsetLog2));
+}
+
+static void *AllocateOrThrow(size_t size, size_t align) {
+  while (true) {
+    if (auto block = Allocate(size, align))
+      return block;
+    auto handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void *operator new(size_t size) {
+  return AllocateOrThrow(size, alignof(std::max_align_t));
+}
+void *operator new[](size_t size) {
+  return AllocateOrThrow(size, alignof(std::max_align_t));
+}
+void *operator new(size_t size, std::align_val_t align) {
+  return AllocateOrThrow(size, (size_t)align);
+}
+void *operator new[](size_t size, std::align_val_t align) {
+  return AllocateOrThrow(size, (size_t)align);
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return Allocate(size, alignof(std::max_align_t));
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return Allocate(size, alignof(std::max_align_t));
+}
+void *operator new(size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+  return Allocate(size, (size_t)align);
+}
+void *operator new[](size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  return Allocate(size, (size_t)align);
+}
+
+void operator delete(void *block) noexcept { Release(block); }
+void operator delete[](void *block) noexcept { Release(block); }
+void operator delete(void *block, size_t) noexcept { Release(block); }
+void operator delete[](void *block, size_t) noexcept { Release(block); }
+void operator delete(void *block, std::align_val_t) noexcept {
+  Release(block);
+}
+void operator delete[](void *block, std::align_val_t) noexcept {
+  Release(block);
+}
+void operator delete(void *block, size_t, std::align_val_t) noexcept {
+  Release(block);
+}
+void operator delete[](void *block, size_t, std::align_val_t) noexcept {
+  Release(block);
+}
+void operator delete(void *block, const std::nothrow_t &) noexcept {
+  Release(block);
+}
+void operator delete[](void *block, const std::nothrow_t &) noexcept {
+  Release(block);
+}
+void operator delete(void *block, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  Release(block);
+}
+void operator delete[](void *block, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  Release(block);
+}
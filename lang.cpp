@@ -2,12 +2,27 @@
 
 #include <argparse/argparse.hpp>
 
+#include <accounting.hpp>
 #include <codegen.hpp>
+#include <codegen/batch.hpp>
+#include <codegen/emit.hpp>
+#include <codegen/prelude.hpp>
+#include <engine.hpp>
 #include <jit.hpp>
+#include <jit/reload.hpp>
+#include <jit/repl.hpp>
+#include <server/daemon.hpp>
+#include <timing.hpp>
 
 #include <lexer/lexer.hpp>
 
 #include <llvm/IR/Verifier.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+
+#include <map>
+#include <set>
 
 using namespace aatbe::lexer;
 using namespace aatbe::source;
@@ -15,45 +30,618 @@ using namespace aatbe::jit;
 
 #define PROJECT_NAME "lang"
 
-int main(int argc, char **argv) {
-  LLVMInitializeNativeTarget();
-  LLVMInitializeNativeAsmParser();
-  LLVMInitializeNativeAsmPrinter();
-  argparse::ArgumentParser args(PROJECT_NAME, "A simple language interpreter");
+// Compiles the modules to objects and links them into `output`.
+static int BuildExecutable(std::vector<ThreadSafeModule> &modules,
+                           aatbe::codegen::OptLevel level,
+                           const std::string &output) {
+  auto objects = aatbe::codegen::EmitObjects(modules, level, output);
+  if (!objects) {
+    std::cerr << toString(objects.takeError()) << std::endl;
+    return 1;
+  }
+
+  auto linked = aatbe::codegen::LinkExecutable(*objects, output);
+  for (auto &object : *objects)
+    llvm::sys::fs::remove(object);
+
+  if (linked) {
+    std::cerr << toString(std::move(linked)) << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Compiles `inputs` to objects on `options.Jobs` threads. With `compile`,
+// writes `<stem>.o` for every input, or links them into one relocatable
+// object at `output` when it is given; otherwise links an executable at
+// `output`.
+static int BuildBatch(const std::vector<std::string> &inputs,
+                      const aatbe::codegen::BatchOptions &options,
+                      bool compile, const std::string &output) {
+  auto keep = compile && output.empty();
+  std::vector<std::string> objects;
+  std::set<std::string> written;
+  for (auto &input : inputs) {
+    auto stem = llvm::sys::path::stem(input).str();
+    if (keep) {
+      if (!written.insert(stem + ".o").second) {
+        std::cerr << stem << ".o: written for more than one input"
+                  << std::endl;
+        return 1;
+      }
+      objects.push_back(stem + ".o");
+      continue;
+    }
+
+    llvm::SmallString<128> path;
+    if (auto EC = llvm::sys::fs::createTemporaryFile(stem, "o", path)) {
+      std::cerr << input << ": " << EC.message() << std::endl;
+      for (auto &object : objects)
+        llvm::sys::fs::remove(object);
+      return 1;
+    }
+    objects.push_back(path.str().str());
+  }
+
+  auto results = aatbe::codegen::BatchCompile(inputs, objects, options);
+  auto failed = !results;
+  if (!results) {
+    std::cerr << toString(results.takeError()) << std::endl;
+  } else {
+    for (auto &result : *results) {
+      for (auto &diagnostic : result.Diagnostics)
+        fprintf(stderr, "%s\n", diagnostic.c_str());
+      failed |= result.Object.empty();
+    }
+  }
+
+  if (!failed && !keep) {
+    auto linked = compile ? aatbe::codegen::LinkRelocatable(objects, output)
+                          : aatbe::codegen::LinkExecutable(objects, output);
+    if (linked) {
+      std::cerr << toString(std::move(linked)) << std::endl;
+      failed = true;
+    }
+  }
+
+  // Like `cc -c`, the objects of the inputs that compiled stay.
+  if (!keep)
+    for (auto &object : objects)
+      llvm::sys::fs::remove(object);
+  return failed ? 1 : 0;
+}
+
+// Records where the time of a run goes while it lives, see aatbe::timing,
+// and prints the report and writes the trace when the run is done,
+// however it ends.
+struct TimeReport {
+  TimeReport(bool report, std::string trace)
+      : report(report), trace(std::move(trace)) {
+    if (this->report || !this->trace.empty())
+      aatbe::timing::Start();
+  }
+  TimeReport(TimeReport &&) = delete;
+  TimeReport(TimeReport const &) = delete;
+  TimeReport &operator=(TimeReport const &) = delete;
+  ~TimeReport() {
+    if (!report && trace.empty())
+      return;
+    aatbe::timing::Stop();
+    if (report)
+      aatbe::timing::Report(llvm::errs());
+    if (!trace.empty())
+      if (auto err = aatbe::timing::WriteTrace(trace))
+        std::cerr << toString(std::move(err)) << std::endl;
+  }
+
+  bool report;
+  std::string trace;
+};
+
+// Counts the memory each phase of a run allocates while it lives, see
+// aatbe::accounting, and prints the report when the run is done.
+struct MemReport {
+  explicit MemReport(bool report) : report(report) {
+    if (report)
+      aatbe::accounting::Start();
+  }
+  MemReport(MemReport &&) = delete;
+  MemReport(MemReport const &) = delete;
+  MemReport &operator=(MemReport const &) = delete;
+  ~MemReport() {
+    if (!report)
+      return;
+    aatbe::accounting::Stop();
+    aatbe::accounting::Report(llvm::errs());
+  }
+
+  bool report;
+};
+
+// Calls `main`, declared either with `argc` and `argv` or without
+// parameters. Returns false when there is no such function.
+static bool RunMain(aatbe::Engine &engine) {
+  if (auto main = engine.get<int32_t()>("main")) {
+    (*main)();
+    return true;
+  } else {
+    llvm::consumeError(main.takeError());
+  }
+
+  auto main = engine.get<int32_t(int32_t, char **)>("main");
+  if (!main) {
+    std::cerr << toString(main.takeError()) << std::endl;
+    return false;
+  }
+  auto jitargv = new char *[1];
+  jitargv[0] = strdup("<main>");
+  (*main)(1, jitargv);
+  return true;
+}
+
+// Reads inputs from stdin until `:q` or the end of input and prints the
+// value of each expression.
+static int RunRepl(const JitOptions &options) {
+  auto repl = Repl::Create(options);
+  if (!repl) {
+    std::cerr << toString(repl.takeError()) << std::endl;
+    return 1;
+  }
+
+  std::string input, line;
+  while (true) {
+    std::cout << (input.empty() ? "> " : ". ") << std::flush;
+    if (!std::getline(std::cin, line))
+      break;
+    if (input.empty() && line == ":q")
+      break;
+
+    input += line + "\n";
+    if (Repl::IsIncomplete(input))
+      continue;
+
+    auto result = repl->get()->Eval(input);
+    input.clear();
+    if (!result)
+      std::cerr << toString(result.takeError()) << std::endl;
+    else if (!result->empty())
+      std::cout << *result << std::endl;
+  }
+  return 0;
+}
+
+// What `lang --daemon` keeps between requests: the preludes it loaded and a
+// JIT for every set of options, which has compiled the prelude already.
+// Programs are unloaded from their JIT once they ran.
+struct Warm {
+  std::map<std::string, std::shared_ptr<const aatbe::codegen::Prelude>>
+      preludes;
+  std::map<std::string, std::unique_ptr<aatbe::Engine>> engines;
+
+  static std::string Key(const JitOptions &options) {
+    std::string level(aatbe::codegen::FormatOptLevel(options.Level));
+    return level + " " + std::to_string((int)options.Mode) + " " +
+           std::to_string(options.Threads) + " " +
+           std::to_string(options.SlabBytes) + " " +
+           std::to_string(options.CacheBytes) + " " + options.CacheDir +
+           "\n" + options.PreludePath;
+  }
+};
 
-  args.add_argument("INPUT").help("Input file to be compiled").required();
+// Runs `lang` with `argList`, in a process of its own when `warm` is null
+// and for a client of the daemon otherwise.
+static int Run(std::vector<std::string> argList, Warm *warm) {
+  // `lang build -o out INPUT...` compiles to an executable instead of
+  // running the program in the JIT, `lang repl` reads definitions and expressions
+  // from stdin.
+  auto build = argList.size() > 1 && argList[1] == "build";
+  auto repl = argList.size() > 1 && argList[1] == "repl";
+  if (build || repl)
+    argList.erase(argList.begin() + 1);
+
+  argparse::ArgumentParser args(build  ? PROJECT_NAME " build"
+                                : repl ? PROJECT_NAME " repl"
+                                       : PROJECT_NAME,
+                                "A simple language interpreter");
+
+  if (build)
+    args.add_argument("INPUT")
+        .help("Input files to be compiled")
+        .nargs(argparse::nargs_pattern::at_least_one);
+  else if (!repl)
+    args.add_argument("INPUT").help("Input file to be compiled").required();
+  if (build) {
+    args.add_argument("-o")
+        .help("Output executable, or object with -c")
+        .default_value(std::string("a.out"));
+    args.add_argument("-c")
+        .help("Compile every input to an object, <stem>.o unless -o is given, "
+              "instead of linking an executable")
+        .default_value(false)
+        .implicit_value(true);
+    args.add_argument("-j")
+        .help("Compile this many inputs at once, 0 for one per hardware "
+              "thread")
+        .default_value(1)
+        .scan<'i', int>();
+    args.add_argument("--emit-bitcode")
+        .help("Write the module as bitcode and its interface, as the "
+              "prelude is built, instead of an executable")
+        .default_value(false)
+        .implicit_value(true);
+  }
+  args.add_argument("--codegen-threads")
+      .help("Generate code for shards of the module on this many threads")
+      .default_value(1)
+      .scan<'i', int>();
+  args.add_argument("--lazy")
+      .help("JIT: compile each function on its first call")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--tiered")
+      .help("JIT: compile unoptimized first, recompile hot functions at -O")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--tier-threshold")
+      .help("JIT: calls after which a tiered function is recompiled")
+      .default_value(1000)
+      .scan<'i', int>();
+  args.add_argument("--jit-stats")
+      .help("JIT: print the tier of each function after running")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--jit-threads")
+      .help("JIT: compile on this many threads, 0 compiles on the main thread")
+      .default_value(0)
+      .scan<'i', int>();
+  args.add_argument("--cache-dir")
+      .help("JIT: cache compiled objects in this directory across runs");
+  args.add_argument("--cache-size")
+      .help("JIT: size limit of the object cache in MiB")
+      .default_value(256)
+      .scan<'i', int>();
+  args.add_argument("--jit-slab-size")
+      .help("JIT: pack the code of all modules into slabs of this many MiB, "
+            "0 maps pages per module")
+      .default_value(0)
+      .scan<'i', int>();
+  args.add_argument("--jitlink")
+      .help("JIT: link with JITLink, write a perf map and register with GDB")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--watch")
+      .help("JIT: recompile the functions that change in INPUT while it runs")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--no-prelude")
+      .help("Do not declare the runtime prelude's functions")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("-g")
+      .help("Emit debug info")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("-O")
+      .help("Optimization level: 0, 1, 2, 3 or s")
+      .default_value(std::string("0"));
+  args.add_argument("-ftime-report")
+      .help("Print the time spent in each phase and optimization pass")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("-ftime-trace")
+      .help("Write a Chrome trace of the phases, passes and functions")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--time-trace-file")
+      .help("Path of the -ftime-trace trace [default: <INPUT stem>.trace.json]");
+  args.add_argument("-fmem-report")
+      .help("Print the memory allocated by each phase and its peak")
+      .default_value(false)
+      .implicit_value(true);
+
+  // Accept the usual spelling -O2 as well as -O 2.
+  for (size_t i = 1; i < argList.size(); i++) {
+    if (argList[i].size() == 3 && argList[i].rfind("-O", 0) == 0) {
+      argList.insert(argList.begin() + (long)i + 1, argList[i].substr(2));
+      argList[i] = "-O";
+    }
+  }
+
+  // Help and version exit the process, which is the daemon's.
+  for (auto &arg : argList)
+    if (warm && (arg == "-h" || arg == "--help" || arg == "-v" ||
+                 arg == "--version")) {
+      std::cout << args;
+      return 0;
+    }
 
   try {
-    args.parse_args(argc, argv);
+    args.parse_args(argList);
   } catch (const std::runtime_error &err) {
     std::cerr << err.what() << std::endl;
     std::cerr << args;
-    std::exit(1);
+    return 1;
+  }
+
+  auto threads = args.get<int>("--codegen-threads");
+  auto level = aatbe::codegen::ParseOptLevel(args.get("-O"));
+  if (!level) {
+    std::cerr << "invalid optimization level -O" << args.get("-O")
+              << std::endl;
+    return 1;
+  }
+  if (args.get<bool>("--lazy") && args.get<bool>("--tiered")) {
+    std::cerr << "--lazy and --tiered cannot be combined" << std::endl;
+    return 1;
+  }
+  auto watch = !build && !repl && args.get<bool>("--watch");
+  if (watch && warm) {
+    std::cerr << "--watch cannot be used through the daemon" << std::endl;
+    return 1;
+  }
+  if (watch && (args.get<bool>("--lazy") || args.get<bool>("--tiered"))) {
+    std::cerr << "--watch cannot be combined with --lazy or --tiered"
+              << std::endl;
+    return 1;
+  }
+
+  std::string trace;
+  if (args.get<bool>("-ftime-trace")) {
+    auto input = repl    ? std::string("repl")
+                 : build ? args.get<std::vector<std::string>>("INPUT")[0]
+                         : args.get("INPUT");
+    trace = args.present("--time-trace-file").value_or(
+        llvm::sys::path::stem(input).str() + ".trace.json");
+  }
+  TimeReport timeReport(args.get<bool>("-ftime-report"), trace);
+  MemReport memReport(args.get<bool>("-fmem-report"));
+
+  // Every program may call the prelude's functions, see Prelude.
+  std::shared_ptr<const aatbe::codegen::Prelude> prelude;
+  auto preludePath = aatbe::codegen::Prelude::DefaultPath();
+  if (!args.get<bool>("--no-prelude") && !preludePath.empty()) {
+    if (warm && warm->preludes.count(preludePath)) {
+      prelude = warm->preludes[preludePath];
+    } else {
+      auto loaded = aatbe::codegen::Prelude::Load(preludePath);
+      if (!loaded) {
+        std::cerr << toString(loaded.takeError()) << std::endl;
+        return 1;
+      }
+      prelude = std::move(*loaded);
+      if (warm)
+        warm->preludes[preludePath] = prelude;
+    }
+    preludePath = prelude->Path();
+  } else {
+    preludePath.clear();
+  }
+
+  if (repl) {
+    JitOptions options;
+    options.Level = *level;
+    options.PreludePath = preludePath;
+    options.SlabBytes =
+        (uint64_t)std::max(0, args.get<int>("--jit-slab-size")) << 20;
+    return RunRepl(options);
+  }
+
+  // Several inputs, or objects of their own, compile as a batch: every
+  // input on its own, sharing the type system.
+  std::vector<std::string> inputs;
+  if (build)
+    inputs = args.get<std::vector<std::string>>("INPUT");
+  else
+    inputs.push_back(args.get("INPUT"));
+  if (build && (inputs.size() > 1 || args.get<bool>("-c"))) {
+    if (args.get<bool>("--emit-bitcode")) {
+      std::cerr << "--emit-bitcode takes a single INPUT" << std::endl;
+      return 1;
+    }
+    aatbe::codegen::BatchOptions options;
+    options.Level = *level;
+    options.Jobs = (unsigned)std::max(0, args.get<int>("-j"));
+    options.DebugInfo = args.get<bool>("-g");
+    options.Runtime = prelude;
+    auto compile = args.get<bool>("-c");
+    return BuildBatch(inputs, options, compile,
+                      !compile || args.is_used("-o") ? args.get("-o") : "");
+  }
+
+  auto &file = inputs[0];
+  if (!build)
+    printf("=================Start=================\n");
+  auto jitlink = !build && args.get<bool>("--jitlink");
+  aatbe::codegen::CompilationSession session(file);
+  session.SetDebugInfo(jitlink || args.get<bool>("-g"));
+  session.SetPrelude(prelude, build);
+  if (!session.AnalyzeFile(file)) {
+    for (auto &diagnostic : session.Diagnostics())
+      fprintf(stderr, "%s\n", diagnostic.c_str());
+    return 1;
+  }
+  if (!build)
+    printf("%s\n", session.Node()->Format().c_str());
+
+  if (build && args.get<bool>("--emit-bitcode")) {
+    if (auto err = aatbe::codegen::Prelude::Write(session, *level,
+                                                  args.get("-o"))) {
+      std::cerr << toString(std::move(err)) << std::endl;
+      return 1;
+    }
+    return 0;
   }
 
-  auto file = args.get("INPUT");
+  // The JIT optimizes modules as it compiles them, an executable is
+  // optimized here, shard by shard.
+  auto codegenLevel = build ? *level : aatbe::codegen::OptLevel::O0;
+  std::vector<ThreadSafeModule> modules;
+  if (threads > 1)
+    modules = session.CodegenParallel(threads, codegenLevel);
+  else
+    modules.push_back(session.Codegen(codegenLevel));
+
+  if (!build)
+    printf("================Codegen================\n");
+  auto valid = true;
+  for (auto &module : modules) {
+    module.withModuleDo([&](llvm::Module &M) {
+      if (!build)
+        M.print(llvm::outs(), nullptr);
+      aatbe::timing::Scope verify("Verify",
+                                  [&] { return M.getModuleIdentifier(); });
+      valid &= !llvm::verifyModule(M, &llvm::errs());
+    });
+  }
 
-  printf("=================Start=================\n");
-  aatbe::codegen::compile_file(file);
+  if (build)
+    return valid ? BuildExecutable(modules, *level, args.get("-o")) : 1;
 
-  printf("================Codegen================\n");
-  aatbe::codegen::Module->print(llvm::outs(), nullptr);
+  if (valid) {
+    JitOptions options;
+    options.Level = *level;
+    options.Mode = args.get<bool>("--lazy") ? JitMode::Lazy : JitMode::Eager;
+    options.Threads = (unsigned)std::max(0, args.get<int>("--jit-threads"));
+    if (args.get<bool>("--tiered")) {
+      options.Mode = JitMode::Tiered;
+      options.TierUpThreshold = (uint64_t)args.get<int>("--tier-threshold");
+    }
+    if (auto cacheDir = args.present("--cache-dir")) {
+      options.CacheDir = *cacheDir;
+      options.CacheBytes =
+          (uint64_t)std::max(0, args.get<int>("--cache-size")) << 20;
+    }
+    options.SlabBytes =
+        (uint64_t)std::max(0, args.get<int>("--jit-slab-size")) << 20;
+    options.PreludePath = preludePath;
+    if (jitlink) {
+      options.Linker = ObjectLinker::JITLink;
+      options.PerfMapPath = PerfMapPlugin::DefaultPath();
+      options.DebuggerSupport = true;
+    }
 
-  if (!llvm::verifyModule(*aatbe::codegen::Module, &llvm::errs())) {
-    auto jit = AatbeJit::Create();
-    if (!jit)
-      std::cout << toString(jit.takeError()) << std::endl;
+    // The daemon keeps JITs, except tiered ones, which keep recompiling,
+    // and JITLink ones, which register every object they link.
+    std::unique_ptr<aatbe::Engine> owned;
+    auto &engine = warm && options.Mode != JitMode::Tiered && !jitlink
+                       ? warm->engines[Warm::Key(options)]
+                       : owned;
+    if (!engine) {
+      auto jit = AatbeJit::Create(options);
+      if (!jit) {
+        std::cerr << toString(jit.takeError()) << std::endl;
+        return 1;
+      }
+      engine = std::make_unique<aatbe::Engine>(std::move(*jit), prelude);
+    }
 
-    auto _ = jit->get()->addModule(ThreadSafeModule(std::move(aatbe::codegen::Module),
-                                    std::move(aatbe::codegen::LLVMContext)));
+    // Watched programs call their functions through stubs that are
+    // repointed when the file changes, see HotReloader.
+    std::unique_ptr<HotReloader> reloader;
+    if (watch) {
+      reloader = std::make_unique<HotReloader>(engine->getJit(), file);
+      reloader->SetPrelude(prelude);
+      auto source = llvm::MemoryBuffer::getFile(file);
+      auto loaded = source ? reloader->Update((*source)->getBuffer().str())
+                           : llvm::errorCodeToError(source.getError());
+      if (!loaded) {
+        std::cerr << toString(loaded.takeError()) << std::endl;
+        return 1;
+      }
+      reloader->Watch(file, std::chrono::milliseconds(100), [](auto names) {
+        if (!names) {
+          std::cerr << toString(names.takeError()) << std::endl;
+          return;
+        }
+        std::string list;
+        for (auto &name : *names)
+          list += " " + name;
+        fprintf(stderr, "reloaded%s\n", list.c_str());
+      });
+      modules.clear();
+    }
+    auto added = engine->add(session, std::move(modules));
+    if (!added) {
+      std::cerr << toString(added.takeError()) << std::endl;
+      return 1;
+    }
 
     printf("==================RUN==================\n");
-    auto *main = (int (*)(int argc, char **argv))jit->get()->lookup("main")->getAddress();
+    bool ran;
+    {
+      aatbe::timing::Scope run("Run main");
+      ran = RunMain(*engine);
+    }
+    if (warm)
+      llvm::consumeError(engine->unload(*added));
+    if (!ran)
+      return 1;
+    if (reloader)
+      reloader->Stop();
+
+    if (args.get<bool>("--jit-stats")) {
+      engine->getJit().waitForTierUps();
+      for (auto &stats : engine->getJit().getTierStats())
+        fprintf(stderr, "%-30s tier %u %12lu calls %10.3f ms\n",
+                stats.Name.c_str(), stats.Tier, stats.Calls,
+                stats.RecompileMs);
+    }
+  }
+
+  return 0;
+}
+
+// `lang --daemon` serves the requests of `lang-client` on a Unix domain
+// socket, see aatbe::server::Daemon, with LLVM initialized and preludes and
+// JITs created once, until a client sends `--stop-daemon`.
+static int Serve(const std::vector<std::string> &argList) {
+  argparse::ArgumentParser args(PROJECT_NAME " --daemon",
+                                "A simple language interpreter");
+  args.add_argument("--daemon")
+      .help("Serve the requests of lang-client")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--socket")
+      .help("Listen on this Unix domain socket")
+      .default_value(aatbe::server::DefaultSocketPath());
+
+  try {
+    args.parse_args(argList);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << args;
+    return 1;
+  }
 
-    auto jitargv = new char*[1];
-    jitargv[0] = strdup("<main>");
-    main(1, jitargv);
+  Warm warm;
+  aatbe::server::Daemon daemon(
+      args.get("--socket"), [&](const aatbe::server::Request &request) {
+        if (request.Args.size() == 1 && request.Args[0] == "--stop-daemon") {
+          daemon.Stop();
+          return 0;
+        }
+        std::vector<std::string> argList{PROJECT_NAME};
+        argList.insert(argList.end(), request.Args.begin(),
+                       request.Args.end());
+        return Run(std::move(argList), &warm);
+      });
+  if (auto err = daemon.Listen()) {
+    std::cerr << toString(std::move(err)) << std::endl;
+    return 1;
   }
 
+  fprintf(stderr, "listening on %s\n", daemon.Path().c_str());
+  daemon.Serve();
   return 0;
 }
+
+int main(int argc, char **argv) {
+  LLVMInitializeNativeTarget();
+  LLVMInitializeNativeAsmParser();
+  LLVMInitializeNativeAsmPrinter();
+
+  std::vector<std::string> argList(argv, argv + argc);
+  if (argList.size() > 1 && argList[1] == "--daemon")
+    return Serve(argList);
+  return Run(std::move(argList), nullptr);
+}
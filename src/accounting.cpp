@@ -0,0 +1,179 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <accounting.hpp>
+
+#include <llvm/Support/Format.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace aatbe::accounting {
+
+namespace detail {
+std::atomic<bool> counting = false;
+std::atomic<uint32_t> epoch = 0;
+std::atomic<bool> interposed = false;
+thread_local Phase phase = Phase::Other;
+} // namespace detail
+
+namespace {
+
+struct alignas(64) Counter {
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> live{0};
+  std::atomic<uint64_t> peak{0};
+
+  void Allocated(uint64_t size) {
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    Grow(size);
+  }
+
+  void Grow(uint64_t size) {
+    auto now = live.fetch_add(size, std::memory_order_relaxed) + size;
+    auto high = peak.load(std::memory_order_relaxed);
+    while (now > high &&
+           !peak.compare_exchange_weak(high, now, std::memory_order_relaxed))
+      ;
+  }
+
+  void Released(uint64_t size) {
+    live.fetch_sub(size, std::memory_order_relaxed);
+  }
+
+  Usage Get() const {
+    return {bytes.load(std::memory_order_relaxed),
+            allocations.load(std::memory_order_relaxed),
+            live.load(std::memory_order_relaxed),
+            peak.load(std::memory_order_relaxed)};
+  }
+
+  void Reset() {
+    bytes = 0;
+    allocations = 0;
+    live = 0;
+    peak = 0;
+  }
+};
+
+} // namespace
+
+// One per phase, and the total last. The total only keeps live bytes and
+// their peak, its bytes and allocations are summed up from the phases.
+static std::array<Counter, PhaseCount + 1> counters;
+
+llvm::StringRef Name(Phase phase) {
+  switch (phase) {
+  case Phase::Lexer:
+    return "lexer";
+  case Phase::Parser:
+    return "parser";
+  case Phase::Typesys:
+    return "typesys";
+  case Phase::Codegen:
+    return "codegen";
+  case Phase::Jit:
+    return "jit";
+  case Phase::Other:
+  default:
+    return "other";
+  }
+}
+
+void Start() {
+  detail::counting = false;
+  detail::epoch++;
+  for (auto &counter : counters)
+    counter.Reset();
+  detail::counting = true;
+}
+
+void Stop() { detail::counting = false; }
+
+void Allocated(Phase phase, uint64_t bytes) {
+  counters[(size_t)phase].Allocated(bytes);
+  counters[PhaseCount].Grow(bytes);
+}
+
+void Released(Phase phase, uint64_t bytes) {
+  counters[(size_t)phase].Released(bytes);
+  counters[PhaseCount].Released(bytes);
+}
+
+Usage Get(Phase phase) { return counters[(size_t)phase].Get(); }
+
+Usage Total() {
+  auto total = counters[PhaseCount].Get();
+  for (size_t phase = 0; phase < PhaseCount; phase++) {
+    auto usage = Get((Phase)phase);
+    total.Bytes += usage.Bytes;
+    total.Allocations += usage.Allocations;
+  }
+  return total;
+}
+
+static double KiB(uint64_t bytes) { return (double)bytes / 1024; }
+
+void Report(llvm::raw_ostream &os) {
+  os << "===--- Memory report ---===\n";
+  if (!Interposed())
+    os << "operator new is not counted, only arenas\n";
+  os << "phase      allocated KiB  allocations    peak KiB    live KiB\n";
+  auto line = [&](llvm::StringRef name, Usage usage) {
+    os << llvm::format("%-8s %15.1f %12lu %11.1f %11.1f\n",
+                       name.str().c_str(), KiB(usage.Bytes),
+                       (unsigned long)usage.Allocations, KiB(usage.Peak),
+                       KiB(usage.Live));
+  };
+  for (size_t phase = 0; phase < PhaseCount; phase++)
+    line(Name((Phase)phase), Get((Phase)phase));
+  line("total", Total());
+}
+
+// Slabs start small, as most arenas hold the tokens of a small file, and
+// double up to a limit.
+static const size_t FirstSlab = 4096;
+static const size_t LargestSlab = 1 << 20;
+
+Arena::~Arena() {
+  for (auto it = destructors.rbegin(); it != destructors.rend(); ++it)
+    it->second(it->first);
+  for (auto &slab : slabs) {
+    if (slab.counted && Counting() && slab.epoch == Epoch())
+      Released(phase, slab.size);
+    std::free(slab.memory);
+  }
+}
+
+void *Arena::Allocate(size_t size, size_t align) {
+  auto at = (uintptr_t)next;
+  auto aligned = (at + align - 1) & ~(uintptr_t)(align - 1);
+  if (next && aligned + size <= (uintptr_t)end) {
+    next = (char *)(aligned + size);
+    return (void *)aligned;
+  }
+
+  // Slabs come from malloc, not operator new, so they are not counted
+  // twice when it is interposed.
+  auto slabSize =
+      slabs.empty() ? FirstSlab : std::min(slabs.back().size * 2, LargestSlab);
+  slabSize = std::max(slabSize, size + align);
+  auto memory = (char *)std::malloc(slabSize);
+  if (!memory)
+    throw std::bad_alloc();
+  auto counted = Counting();
+  if (counted)
+    Allocated(phase, slabSize);
+  slabs.push_back({memory, slabSize, Epoch(), counted});
+  bytes += slabSize;
+
+  aligned = ((uintptr_t)memory + align - 1) & ~(uintptr_t)(align - 1);
+  next = (char *)(aligned + size);
+  end = memory + slabSize;
+  return (void *)aligned;
+}
+
+} // namespace aatbe::accounting
@@ -1,53 +1,26 @@
 #include <codegen.hpp>
 #include <codegen/context.hpp>
 #include <codegen/expression.hpp>
-
-#include <parser/parser.hpp>
+#include <timing.hpp>
 
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/IRBuilder.h>
 
-using namespace aatbe::source;
-using namespace aatbe::lexer;
 using namespace aatbe::parser;
 
 namespace aatbe::codegen {
 
-std::unique_ptr<llvm::LLVMContext> LLVMContext;
-std::shared_ptr<llvm::IRBuilder<>> Builder;
-std::unique_ptr<llvm::Module> Module;
-std::shared_ptr<CompilerContext> CompContext;
-
-std::shared_ptr<llvm::IRBuilder<>> GetLLVMBuilder() { return Builder; }
-std::shared_ptr<CompilerContext> GetCompilerContext() { return CompContext; }
-
-auto DeclPass(ModuleNode *mod) {
+auto DeclPass(CompilerContext &ctx, ModuleNode *mod) {
+  timing::Scope scope("DeclPass");
   for (auto &statement : mod->Value()) {
     switch (statement->Kind()) {
-    case ModuleStatementKind::Function: {
-      auto funcDecl = statement->AsFunction();
-      auto funcType = funcDecl->Type();
-      auto funcName = funcDecl->Name();
-      auto funcParams = funcDecl->Parameters();
-
-      std::vector<llvm::Type *> paramTypes;
-      for (auto &param : funcParams->Bindings()) {
-        paramTypes.push_back(param->Type()->LLVMType());
-      }
-
-      GetCompilerContext()->CurrentScope()->SetFunction(
-          funcName,
-          llvm::Function::Create(funcType,
-              llvm::Function::ExternalLinkage, funcName, Module.get()));
-
-      break;
-    }
     case ModuleStatementKind::Struct: {
         auto structDecl = statement->AsStruct();
         auto structName = structDecl->Name();
 
-        GetCompilerContext()->CurrentScope()->SetStruct(
-            structName, structDecl->LLVMType());
+        ctx.CurrentScope()->SetStruct(
+            structName, llvm::cast<llvm::StructType>(
+                            ctx.Lowering().Lower(structDecl->Id())));
       break;
     }
     default:
@@ -56,64 +29,50 @@ auto DeclPass(ModuleNode *mod) {
   }
 }
 
-auto CodegenPass(ModuleNode *mod) {
-  for (auto &statement : mod->Value()) {
-    switch (statement->Kind()) {
-    case ModuleStatementKind::Function: {
-      auto funcDecl = statement->AsFunction();
-      auto funcName = funcDecl->Name();
+auto CodegenPass(CompilerContext &ctx, uint32_t begin, uint32_t end) {
+  timing::Scope scope("CodegenPass");
+  auto &functions = ctx.Session().Symbols().Functions();
+  for (uint32_t index = begin; index < end; index++) {
+    auto funcDecl = functions[index];
+    auto funcName = funcDecl->Name();
 
-      if (funcDecl->IsExtern() || !funcDecl->Body().has_value()) {
-        continue;
-      }
-
-      auto func = Module->getFunction(funcName);
+    if (funcDecl->IsExtern() || !funcDecl->Body().has_value()) {
+      continue;
+    }
 
-      auto bb = funcName == "main"
-                    ? llvm::BasicBlock::Create(*LLVMContext, "entry", func)
-                    : llvm::BasicBlock::Create(*LLVMContext, "", func);
+    timing::Scope function("Codegen function",
+                           [&] { return std::string(funcName); });
+    auto func = ctx.GetFunction(index);
 
-      Builder->SetInsertPoint(bb);
+    auto bb = funcName == "main"
+                  ? llvm::BasicBlock::Create(ctx.Context(), "entry", func)
+                  : llvm::BasicBlock::Create(ctx.Context(), "", func);
 
-      GetCompilerContext()->EnterScope(funcName);
+    ctx.Builder().SetInsertPoint(bb);
+    ctx.DescribeFunction(func, ctx.Session().Line(funcDecl->Offset()));
 
-      std::optional<llvm::Value *> retVal = CodegenExpression(*funcDecl->Body());
+    ctx.EnterScope(funcName);
+    ctx.EnterFunction(&ctx.Session().Symbols().Info(index), func);
 
-      if (funcDecl->ReturnType()->Kind() == TypeKind::Unit)
-        Builder->CreateRetVoid();
-      else
-        Builder->CreateRet(*retVal);
+    std::optional<llvm::Value *> retVal =
+        CodegenExpression(ctx, *funcDecl->Body());
 
-      GetCompilerContext()->ExitScope();
+    if (func->getReturnType()->isVoidTy())
+      ctx.Builder().CreateRetVoid();
+    else
+      ctx.Builder().CreateRet(*retVal);
 
-      break;
-    }
-    default:
-      break;
-    }
+    ctx.ExitScope();
   }
 }
 
-void compile_file(const std::string &file) {
-  LLVMContext = std::make_unique<llvm::LLVMContext>();
-  Module = std::make_unique<llvm::Module>(file, *LLVMContext);
-  Builder = std::make_shared<llvm::IRBuilder<>>(*LLVMContext);
-  CompContext = std::make_shared<CompilerContext>();
-
-  auto srcFile = SrcFile::FromFile(file);
-
-  Lexer lexer(std::move(srcFile));
-  auto tokens = lexer.Lex();
-
-  Parser parser(tokens);
-
-  auto mod = parser.Parse();
-  printf("%s\n", mod.Format().c_str());
-
-  CompContext->EnterScope("root");
-  DeclPass(mod.Node());
-  CodegenPass(mod.Node());
-  CompContext->ExitScope();
+void EmitModule(CompilerContext &ctx, ModuleNode *mod, uint32_t begin,
+                uint32_t end) {
+  ctx.EnterScope("root");
+  DeclPass(ctx, mod);
+  CodegenPass(ctx, begin, end);
+  ctx.ExitScope();
+  ctx.FinalizeDebugInfo();
 }
 
 } // namespace aatbe::codegen
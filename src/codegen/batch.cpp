@@ -0,0 +1,115 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <accounting.hpp>
+#include <codegen/batch.hpp>
+#include <codegen/emit.hpp>
+#include <codegen/session.hpp>
+#include <timing.hpp>
+
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+namespace aatbe::codegen {
+
+// Compiles `result.File` to `object` with the worker's `machine`.
+static void CompileOne(BatchResult &result, const std::string &object,
+                       typesys::TypeSystem &types, llvm::TargetMachine &machine,
+                       const BatchOptions &options) {
+  timing::Scope scope("Compile file", [&] { return result.File; });
+  CompilationSession session(result.File, types);
+  session.SetDebugInfo(options.DebugInfo);
+  session.SetPrelude(options.Runtime, true);
+  if (!session.AnalyzeFile(result.File)) {
+    result.Diagnostics = session.Diagnostics();
+    return;
+  }
+
+  // Optimized here rather than by Codegen, which would create a target
+  // machine of its own for every file.
+  auto module = session.Codegen(OptLevel::O0);
+  module.withModuleDo([&](llvm::Module &M) {
+    accounting::PhaseScope phase(accounting::Phase::Codegen);
+    std::string message;
+    llvm::raw_string_ostream errors(message);
+    bool broken;
+    {
+      timing::Scope verify("Verify", [&] { return result.File; });
+      broken = llvm::verifyModule(M, &errors);
+    }
+    if (broken) {
+      result.Diagnostics.push_back(result.File + ": " + errors.str());
+      return;
+    }
+
+    if (options.Level != OptLevel::O0)
+      OptimizeModule(M, options.Level, &machine);
+    if (auto err = EmitObject(M, machine, object))
+      result.Diagnostics.push_back(llvm::toString(std::move(err)));
+    else
+      result.Object = object;
+  });
+}
+
+llvm::Expected<std::vector<BatchResult>>
+BatchCompile(const std::vector<std::string> &files,
+             const std::vector<std::string> &objects,
+             const BatchOptions &options) {
+  assert(files.size() == objects.size() && "an object per file");
+
+  std::vector<BatchResult> results(files.size());
+  for (size_t i = 0; i < files.size(); i++)
+    results[i].File = files[i];
+
+  // Largest first: the last file taken bounds how long the batch takes.
+  std::vector<uint64_t> sizes(files.size(), 0);
+  for (size_t i = 0; i < files.size(); i++)
+    llvm::sys::fs::file_size(files[i], sizes[i]);
+  std::vector<size_t> order(files.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+  auto jobs = options.Jobs ? options.Jobs : std::thread::hardware_concurrency();
+  jobs = std::max(1u, std::min(jobs, (unsigned)files.size()));
+
+  typesys::TypeSystem types;
+  std::atomic<size_t> next = 0;
+  std::vector<std::string> errors(jobs);
+
+  auto work = [&](unsigned job) {
+    auto machine = CreateHostMachine(options.Level);
+    if (!machine) {
+      errors[job] = llvm::toString(machine.takeError());
+      return;
+    }
+
+    for (size_t at; (at = next.fetch_add(1)) < order.size();) {
+      auto i = order[at];
+      CompileOne(results[i], objects[i], types, **machine, options);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned job = 1; job < jobs; job++)
+    workers.emplace_back(work, job);
+  work(0);
+  for (auto &worker : workers)
+    worker.join();
+
+  // Workers that have a machine take over the files of those without one.
+  if (std::all_of(errors.begin(), errors.end(),
+                  [](auto &error) { return !error.empty(); }))
+    return llvm::createStringError(llvm::inconvertibleErrorCode(), errors[0]);
+
+  return results;
+}
+
+} // namespace aatbe::codegen
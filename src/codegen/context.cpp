@@ -0,0 +1,91 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <codegen/context.hpp>
+#include <codegen/session.hpp>
+
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/Support/Path.h>
+
+namespace aatbe::codegen {
+
+CompilerContext::CompilerContext(CompilationSession &session,
+                                 const std::string &name)
+    : session(session), context(std::make_unique<llvm::LLVMContext>()),
+      module(std::make_unique<llvm::Module>(name, *context)),
+      builder(*context) {
+  // Struct layouts follow the host target, fall back to LLVM's default
+  // layout when no native target has been initialized.
+  if (auto JTMB = llvm::orc::JITTargetMachineBuilder::detectHost()) {
+    module->setTargetTriple(JTMB->getTargetTriple().str());
+    if (auto DL = JTMB->getDefaultDataLayoutForTarget())
+      module->setDataLayout(*DL);
+    else
+      llvm::consumeError(DL.takeError());
+  } else {
+    llvm::consumeError(JTMB.takeError());
+  }
+
+  lowering = std::make_unique<TypeLowering>(session.Types(), *context,
+                                            module->getDataLayout());
+  functions.assign(session.Symbols().Functions().size(), nullptr);
+
+  if (session.DebugInfo()) {
+    module->addModuleFlag(llvm::Module::Warning, "Debug Info Version",
+                          llvm::DEBUG_METADATA_VERSION);
+    module->addModuleFlag(llvm::Module::Warning, "Dwarf Version", 4);
+
+    debug = std::make_unique<llvm::DIBuilder>(*module);
+    auto &path = session.Name();
+    debugFile = debug->createFile(llvm::sys::path::filename(path),
+                                  llvm::sys::path::parent_path(path));
+    debug->createCompileUnit(llvm::dwarf::DW_LANG_C, debugFile, "aatbe",
+                             false, "", 0);
+  }
+}
+
+void CompilerContext::DescribeFunction(llvm::Function *function,
+                                       unsigned line) {
+  if (!debug)
+    return;
+
+  auto subprogram = debug->createFunction(
+      debugFile, function->getName(), function->getName(), debugFile, line,
+      debug->createSubroutineType(debug->getOrCreateTypeArray({})), line,
+      llvm::DINode::FlagPrototyped, llvm::DISubprogram::SPFlagDefinition);
+  function->setSubprogram(subprogram);
+  builder.SetCurrentDebugLocation(
+      llvm::DILocation::get(*context, line, 0, subprogram));
+}
+
+void CompilerContext::FinalizeDebugInfo() {
+  if (debug)
+    debug->finalize();
+}
+
+// Types and the module reference the context, release them first.
+CompilerContext::~CompilerContext() {
+  lowering.reset();
+  module.reset();
+}
+
+llvm::Function *CompilerContext::GetFunction(uint32_t index) {
+  auto &function = this->functions[index];
+  if (!function) {
+    auto decl = session.Symbols().Functions()[index];
+    function = llvm::Function::Create(Lowering().LowerFunction(decl->Id()),
+                                      llvm::Function::ExternalLinkage,
+                                      decl->Name(), module.get());
+  }
+  return function;
+}
+
+llvm::orc::ThreadSafeModule CompilerContext::TakeModule() {
+  lowering.reset();
+  functions.clear();
+  locals.clear();
+  return llvm::orc::ThreadSafeModule(std::move(module), std::move(context));
+}
+
+} // namespace aatbe::codegen
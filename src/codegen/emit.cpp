@@ -0,0 +1,162 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <codegen/emit.hpp>
+#include <accounting.hpp>
+#include <timing.hpp>
+
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <cstdlib>
+#include <thread>
+
+namespace aatbe::codegen {
+
+static llvm::CodeGenOpt::Level ToCodeGen(OptLevel level) {
+  switch (level) {
+  case OptLevel::O1:
+    return llvm::CodeGenOpt::Less;
+  case OptLevel::O2:
+  case OptLevel::Os:
+    return llvm::CodeGenOpt::Default;
+  case OptLevel::O3:
+    return llvm::CodeGenOpt::Aggressive;
+  case OptLevel::O0:
+  default:
+    return llvm::CodeGenOpt::None;
+  }
+}
+
+llvm::Expected<std::unique_ptr<llvm::TargetMachine>>
+CreateHostMachine(OptLevel level) {
+  auto JTMB = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!JTMB)
+    return JTMB.takeError();
+
+  JTMB->setRelocationModel(llvm::Reloc::PIC_);
+  JTMB->setCodeGenOptLevel(ToCodeGen(level));
+  return JTMB->createTargetMachine();
+}
+
+llvm::Error EmitObject(llvm::Module &module, llvm::TargetMachine &machine,
+                       const std::string &path) {
+  timing::Scope scope("Emit object", [&] { return path; });
+  accounting::PhaseScope phase(accounting::Phase::Codegen);
+  std::error_code EC;
+  llvm::raw_fd_ostream out(path, EC, llvm::sys::fs::OF_None);
+  if (EC)
+    return llvm::createFileError(path, EC);
+
+  module.setDataLayout(machine.createDataLayout());
+  module.setTargetTriple(machine.getTargetTriple().str());
+
+  llvm::legacy::PassManager PM;
+  if (machine.addPassesToEmitFile(PM, out, nullptr, llvm::CGFT_ObjectFile))
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "target cannot emit object files");
+  PM.run(module);
+
+  out.flush();
+  if (out.has_error())
+    return llvm::createFileError(path, out.error());
+  return llvm::Error::success();
+}
+
+llvm::Expected<std::vector<std::string>>
+EmitObjects(std::vector<llvm::orc::ThreadSafeModule> &modules,
+            OptLevel level, const std::string &prefix) {
+  std::vector<std::string> paths(modules.size());
+  std::vector<std::string> errors(modules.size());
+  std::vector<std::thread> workers;
+  // A temporary file's prefix is a file name, not a path.
+  auto name = llvm::sys::path::filename(prefix).str();
+
+  for (size_t i = 0; i < modules.size(); i++) {
+    workers.emplace_back([&, i] {
+      llvm::SmallString<128> path;
+      if (auto EC = llvm::sys::fs::createTemporaryFile(
+              name + "." + std::to_string(i), "o", path)) {
+        errors[i] = prefix + ": " + EC.message();
+        return;
+      }
+      paths[i] = path.str().str();
+
+      auto machine = CreateHostMachine(level);
+      if (!machine) {
+        errors[i] = llvm::toString(machine.takeError());
+        return;
+      }
+
+      modules[i].withModuleDo([&](llvm::Module &M) {
+        if (auto error = EmitObject(M, **machine, paths[i]))
+          errors[i] = llvm::toString(std::move(error));
+      });
+    });
+  }
+
+  for (auto &worker : workers)
+    worker.join();
+
+  std::string message;
+  for (auto &error : errors)
+    if (!error.empty())
+      message += (message.empty() ? "" : "\n") + error;
+
+  if (!message.empty()) {
+    for (auto &path : paths)
+      if (!path.empty())
+        llvm::sys::fs::remove(path);
+    return llvm::createStringError(llvm::inconvertibleErrorCode(), message);
+  }
+
+  return paths;
+}
+
+// Runs the C compiler driver with `args` to produce `output`.
+static llvm::Error RunDriver(std::vector<llvm::StringRef> args,
+                             const std::vector<std::string> &objects,
+                             const std::string &output) {
+  timing::Scope scope("Link", [&] { return output; });
+  auto driver = std::getenv("CC");
+  auto program = llvm::sys::findProgramByName(driver ? driver : "cc");
+  if (!program)
+    return llvm::createStringError(program.getError(),
+                                   "cannot find the C compiler driver");
+
+  args.insert(args.begin(), *program);
+  args.push_back("-o");
+  args.push_back(output);
+  for (auto &object : objects)
+    args.push_back(object);
+
+  std::string message;
+  auto status = llvm::sys::ExecuteAndWait(*program, args, llvm::None, {}, 0,
+                                          0, &message);
+  if (status != 0) {
+    if (message.empty())
+      message = *program + " exited with " + std::to_string(status);
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "linking " + output + " failed: " +
+                                       message);
+  }
+
+  return llvm::Error::success();
+}
+
+llvm::Error LinkExecutable(const std::vector<std::string> &objects,
+                           const std::string &output) {
+  return RunDriver({}, objects, output);
+}
+
+llvm::Error LinkRelocatable(const std::vector<std::string> &objects,
+                            const std::string &output) {
+  return RunDriver({"-r", "-nostdlib"}, objects, output);
+}
+
+} // namespace aatbe::codegen
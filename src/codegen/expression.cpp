@@ -2,60 +2,73 @@
 // Created by chronium on 28.08.2022.
 //
 
-#include <codegen.hpp>
+#include <codegen/session.hpp>
 #include <codegen/expression.hpp>
 
 #include <llvm/IR/Constants.h>
 
+#include <sema/resolve.hpp>
+
 namespace aatbe::codegen {
 
-std::optional<llvm::Value *> CodegenCall(CallExpression *call) {
+std::optional<llvm::Value *> CodegenCall(CompilerContext &ctx,
+                                         CallExpression *call) {
   assert(call->Callee()->Kind() == ExpressionKind::Atom);
   assert(call->Callee()->AsAtom()->Value()->Kind() == TerminalKind::Identifier);
   assert(call->Args()->Kind() == ExpressionKind::Tuple);
 
-  auto terminal = call->Callee()->AsAtom()->Value()->AsIdentifier();
   auto argsExprs = call->Args()->AsTuple()->Value();
 
-  auto function = GetCompilerContext()->GetFunction(terminal->Value());
+  auto symbol = ctx.CurrentFunction()->Use(call->Callee());
+  assert(symbol.kind == sema::Symbol::Kind::Function);
+  auto function = ctx.GetFunction(symbol.index);
 
   std::vector<llvm::Value *> args;
 
   for (auto arg : argsExprs) {
-    auto argValue = CodegenExpression(arg);
+    auto argValue = CodegenExpression(ctx, arg);
     if (!argValue) {
       return std::nullopt;
     }
     args.push_back(*argValue);
   }
 
-  return GetLLVMBuilder()->CreateCall(function, args);
+  return ctx.Builder().CreateCall(function, args);
 }
 
-std::optional<llvm::Value *> CodegenExpression(ExpressionNode *expression) {
+std::optional<llvm::Value *> CodegenExpression(CompilerContext &ctx,
+                                               ExpressionNode *expression) {
   std::optional<llvm::Value *> result = {};
 
   switch (expression->Kind()) {
   case ExpressionKind::Atom:
-    return CodegenAtom(expression->AsAtom());
+    if (expression->AsAtom()->Value()->Kind() == TerminalKind::Identifier) {
+      auto symbol = ctx.CurrentFunction()->Use(expression);
+      if (symbol.kind == sema::Symbol::Kind::Function)
+        return ctx.GetFunction(symbol.index);
+      return ctx.GetVariable(symbol);
+    }
+    return CodegenAtom(ctx, expression->AsAtom());
   case ExpressionKind::Unary:
-    assert(nullptr);
+    return CodegenUnary(ctx, expression->AsUnary());
   case ExpressionKind::Binary:
-    assert(nullptr);
+    return CodegenBinary(ctx, expression->AsBinary());
   case ExpressionKind::Tuple:
     assert(nullptr);
   case ExpressionKind::Call:
-    return CodegenCall(expression->AsCall());
+    return CodegenCall(ctx, expression->AsCall());
   case ExpressionKind::Block:
     for (auto expr : expression->AsBlock()->Value()) {
-      result = CodegenExpression(expr);
+      result = CodegenExpression(ctx, expr);
       if (!result) {
         return std::nullopt;
       }
     }
     return result;
   case ExpressionKind::If:
-    return CodegenIf(expression->AsIf());
+    return CodegenIf(ctx, expression->AsIf());
+  case ExpressionKind::Let:
+    return CodegenLet(ctx, expression->AsLet());
   case ExpressionKind::Loop:
     assert(nullptr);
   default:
@@ -63,132 +76,266 @@ std::optional<llvm::Value *> CodegenExpression(ExpressionNode *expression) {
   }
 }
 
-llvm::Value *ConstantInteger(IntegerTerm *term) {
-  switch (term->Type()->Kind()) {
-  case TypeKind::Int8:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt8Ty(), term->Value(),
-                                  true);
-  case TypeKind::Int16:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt16Ty(), term->Value(),
-                                  true);
-  case TypeKind::Int32:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt32Ty(), term->Value(),
-                                  true);
-  case TypeKind::Int64:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt64Ty(), term->Value(),
-                                  true);
-
-  case TypeKind::UInt8:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt8Ty(), term->Value(),
-                                  false);
-  case TypeKind::UInt16:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt16Ty(), term->Value(),
-                                  false);
-  case TypeKind::UInt32:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt32Ty(), term->Value(),
-                                  false);
-  case TypeKind::UInt64:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt64Ty(), term->Value(),
-                                  false);
-  default:
-    assert(nullptr);
-    return nullptr;
-  }
+llvm::Value *ConstantInteger(CompilerContext &ctx, IntegerTerm *term) {
+  auto type = term->Type();
+  auto isSigned = type->Kind() == TypeKind::Int8 ||
+                  type->Kind() == TypeKind::Int16 ||
+                  type->Kind() == TypeKind::Int32 ||
+                  type->Kind() == TypeKind::Int64;
+
+  return llvm::ConstantInt::get(ctx.Lowering().Lower(type->Id()),
+                                term->Value(), isSigned);
 }
 
-std::optional<llvm::Value *> CodegenAtom(AtomExpression *atom) {
+std::optional<llvm::Value *> CodegenAtom(CompilerContext &ctx,
+                                         AtomExpression *atom) {
   auto term = atom->Value();
   switch (term->Kind()) {
   case TerminalKind::Identifier:
     assert(nullptr);
   case TerminalKind::Integer:
-    return ConstantInteger(term->AsInteger());
+    return ConstantInteger(ctx, term->AsInteger());
   case TerminalKind::String:
-    return GetLLVMBuilder()->CreateGlobalStringPtr(term->AsString()->Value());
+    return ctx.Builder().CreateGlobalStringPtr(term->AsString()->Value());
   case TerminalKind::Boolean:
-    return llvm::ConstantInt::get(GetLLVMBuilder()->getInt1Ty(),
+    return llvm::ConstantInt::get(ctx.Builder().getInt1Ty(),
                                   term->AsBoolean()->Value());
   default:
     return std::nullopt;
   }
 }
 
-std::optional<llvm::Value *> CodegenIf(IfExpression *ifExpr) {
-  auto hasElse =
-      std::get<0>(ifExpr->Value()[ifExpr->Value().size() - 1]) == nullptr;
-  llvm::Type *bodyType = nullptr;
+// Value of expressions of unit type.
+static llvm::Value *UnitValue(CompilerContext &ctx) {
+  return llvm::UndefValue::get(ctx.Builder().getVoidTy());
+}
 
-  auto function = GetLLVMBuilder()->GetInsertBlock()->getParent();
-  auto &entry = function->getEntryBlock();
+static bool IsSigned(CompilerContext &ctx, const ExpressionNode *expression) {
+  auto integer =
+      ctx.Session().Inference().TypeOf(expression).Resolve<typesys::IntType>();
+  return integer && integer->Signed();
+}
 
-  std::vector<llvm::BasicBlock *> branchBlocks;
-  std::vector<llvm::Value *> branchValues;
+static bool IsFloat(CompilerContext &ctx, const ExpressionNode *expression) {
+  return ctx.Session()
+             .Inference().TypeOf(expression)
+             .Resolve<typesys::FloatType>() != nullptr;
+}
 
-  auto mergeBlock = llvm::BasicBlock::Create(*LLVMContext, "merge");
+std::optional<llvm::Value *> CodegenUnary(CompilerContext &ctx,
+                                          UnaryExpression *unary) {
+  auto operand =
+      CodegenExpression(ctx, const_cast<ExpressionNode *>(unary->Value()));
+  if (!operand)
+    return std::nullopt;
 
-  // Create target blocks
-  for (size_t _i = 0; _i < ifExpr->Size(); _i++) {
-    auto thenBlock = llvm::BasicBlock::Create(*LLVMContext, "branch", function);
-    branchBlocks.push_back(thenBlock);
+  switch (unary->OpKind()) {
+  case UnaryExpression::Negation:
+    return IsFloat(ctx, unary->Value()) ? ctx.Builder().CreateFNeg(*operand)
+                                   : ctx.Builder().CreateNeg(*operand);
+  case UnaryExpression::LogicalNot:
+  case UnaryExpression::BitwiseNot:
+    return ctx.Builder().CreateNot(*operand);
+  default:
+    // Address-of and dereference need storage for locals.
+    return std::nullopt;
   }
+}
+
+// `&&` and `||` only evaluate their right operand when needed.
+static std::optional<llvm::Value *> CodegenLogical(CompilerContext &ctx,
+                                                   BinaryExpression *binary) {
+  auto isAnd = binary->OpKind() == BinaryExpression::LogicalAnd;
+
+  auto left = CodegenExpression(ctx, binary->Left().get());
+  if (!left)
+    return std::nullopt;
+
+  auto function = ctx.Builder().GetInsertBlock()->getParent();
+  auto leftBlock = ctx.Builder().GetInsertBlock();
+  auto rightBlock = llvm::BasicBlock::Create(ctx.Context(), "rhs", function);
+  auto mergeBlock = llvm::BasicBlock::Create(ctx.Context(), "merge", function);
+
+  if (isAnd)
+    ctx.Builder().CreateCondBr(*left, rightBlock, mergeBlock);
+  else
+    ctx.Builder().CreateCondBr(*left, mergeBlock, rightBlock);
+
+  ctx.Builder().SetInsertPoint(rightBlock);
+  auto right = CodegenExpression(ctx, binary->Right().get());
+  if (!right)
+    return std::nullopt;
+  rightBlock = ctx.Builder().GetInsertBlock();
+  ctx.Builder().CreateBr(mergeBlock);
+
+  ctx.Builder().SetInsertPoint(mergeBlock);
+  auto phi = ctx.Builder().CreatePHI(ctx.Builder().getInt1Ty(), 2);
+  phi->addIncoming(ctx.Builder().getInt1(!isAnd), leftBlock);
+  phi->addIncoming(*right, rightBlock);
+
+  return phi;
+}
+
+std::optional<llvm::Value *> CodegenBinary(CompilerContext &ctx,
+                                           BinaryExpression *binary) {
+  if (binary->OpKind() == BinaryExpression::LogicalAnd ||
+      binary->OpKind() == BinaryExpression::LogicalOr)
+    return CodegenLogical(ctx, binary);
 
-  // Create jump list
-  for (size_t i = 0; i < ifExpr->Size() - hasElse; i++) {
-    auto expr = std::get<0>(ifExpr->Value()[i]);
-    auto condition = CodegenExpression(expr);
-    if (!condition) {
+  auto left = CodegenExpression(ctx, binary->Left().get());
+  if (!left)
+    return std::nullopt;
+  auto right = CodegenExpression(ctx, binary->Right().get());
+  if (!right)
+    return std::nullopt;
+
+  auto &builder = ctx.Builder();
+  auto lhs = *left, rhs = *right;
+
+  if (IsFloat(ctx, binary->Left().get())) {
+    switch (binary->OpKind()) {
+    case BinaryExpression::Addition:
+      return builder.CreateFAdd(lhs, rhs);
+    case BinaryExpression::Subtraction:
+      return builder.CreateFSub(lhs, rhs);
+    case BinaryExpression::Multiplication:
+      return builder.CreateFMul(lhs, rhs);
+    case BinaryExpression::Division:
+      return builder.CreateFDiv(lhs, rhs);
+    case BinaryExpression::Modulo:
+      return builder.CreateFRem(lhs, rhs);
+    case BinaryExpression::Equal:
+      return builder.CreateFCmpOEQ(lhs, rhs);
+    case BinaryExpression::NotEqual:
+      return builder.CreateFCmpUNE(lhs, rhs);
+    case BinaryExpression::LessThan:
+      return builder.CreateFCmpOLT(lhs, rhs);
+    case BinaryExpression::LessThanOrEqual:
+      return builder.CreateFCmpOLE(lhs, rhs);
+    case BinaryExpression::GreaterThan:
+      return builder.CreateFCmpOGT(lhs, rhs);
+    case BinaryExpression::GreaterThanOrEqual:
+      return builder.CreateFCmpOGE(lhs, rhs);
+    default:
       return std::nullopt;
     }
+  }
 
-    auto thenBlock = branchBlocks[i];
-    auto bailBlock =
-        hasElse ? branchBlocks[ifExpr->Value().size() - 1] : mergeBlock;
-
-    GetLLVMBuilder()->CreateCondBr(
-        GetLLVMBuilder()->CreateICmpEQ(
-            condition.value(),
-            llvm::ConstantInt::get(GetLLVMBuilder()->getInt1Ty(), 1, true)),
-        thenBlock, bailBlock);
+  auto isSigned = IsSigned(ctx, binary->Left().get());
+
+  switch (binary->OpKind()) {
+  case BinaryExpression::Addition:
+    return builder.CreateAdd(lhs, rhs);
+  case BinaryExpression::Subtraction:
+    return builder.CreateSub(lhs, rhs);
+  case BinaryExpression::Multiplication:
+    return builder.CreateMul(lhs, rhs);
+  case BinaryExpression::Division:
+    return isSigned ? builder.CreateSDiv(lhs, rhs)
+                    : builder.CreateUDiv(lhs, rhs);
+  case BinaryExpression::Modulo:
+    return isSigned ? builder.CreateSRem(lhs, rhs)
+                    : builder.CreateURem(lhs, rhs);
+  case BinaryExpression::BitwiseAnd:
+    return builder.CreateAnd(lhs, rhs);
+  case BinaryExpression::BitwiseOr:
+    return builder.CreateOr(lhs, rhs);
+  case BinaryExpression::BitwiseXor:
+    return builder.CreateXor(lhs, rhs);
+  case BinaryExpression::BitwiseLeftShift:
+    return builder.CreateShl(lhs, rhs);
+  case BinaryExpression::BitwiseRightShift:
+    return isSigned ? builder.CreateAShr(lhs, rhs)
+                    : builder.CreateLShr(lhs, rhs);
+  case BinaryExpression::Equal:
+    return builder.CreateICmpEQ(lhs, rhs);
+  case BinaryExpression::NotEqual:
+    return builder.CreateICmpNE(lhs, rhs);
+  case BinaryExpression::LessThan:
+    return isSigned ? builder.CreateICmpSLT(lhs, rhs)
+                    : builder.CreateICmpULT(lhs, rhs);
+  case BinaryExpression::LessThanOrEqual:
+    return isSigned ? builder.CreateICmpSLE(lhs, rhs)
+                    : builder.CreateICmpULE(lhs, rhs);
+  case BinaryExpression::GreaterThan:
+    return isSigned ? builder.CreateICmpSGT(lhs, rhs)
+                    : builder.CreateICmpUGT(lhs, rhs);
+  case BinaryExpression::GreaterThanOrEqual:
+    return isSigned ? builder.CreateICmpSGE(lhs, rhs)
+                    : builder.CreateICmpUGE(lhs, rhs);
+  default:
+    return std::nullopt;
   }
+}
+
+std::optional<llvm::Value *> CodegenLet(CompilerContext &ctx,
+                                        LetExpression *let) {
+  auto value = CodegenExpression(ctx, let->Value());
+  if (!value)
+    return std::nullopt;
+
+  auto info = ctx.CurrentFunction();
+  ctx.SetLocal(info->locals.lookup(let), *value);
+
+  return UnitValue(ctx);
+}
+
+std::optional<llvm::Value *> CodegenIf(CompilerContext &ctx,
+                                       IfExpression *ifExpr) {
+  auto &branches = ifExpr->Branches();
+  auto hasElse = std::get<0>(branches.back()) == nullptr;
 
-  // FillBlocks
-  for (size_t i = 0; i < ifExpr->Size(); i++) {
-    auto expr = std::get<1>(ifExpr->Value()[i]);
-    auto thenBlock = branchBlocks[i];
+  auto function = ctx.Builder().GetInsertBlock()->getParent();
+  auto mergeBlock = llvm::BasicBlock::Create(ctx.Context(), "merge");
 
-    GetLLVMBuilder()->SetInsertPoint(thenBlock);
-    auto result = CodegenExpression(expr);
+  // Value of each branch and the block it was computed in.
+  std::vector<std::pair<llvm::Value *, llvm::BasicBlock *>> incoming;
+
+  for (auto &[condition, body] : branches) {
+    llvm::BasicBlock *nextBlock = nullptr;
+
+    if (condition) {
+      auto value = CodegenExpression(ctx, condition);
+      if (!value) {
+        return std::nullopt;
+      }
+
+      auto thenBlock =
+          llvm::BasicBlock::Create(ctx.Context(), "branch", function);
+      nextBlock = llvm::BasicBlock::Create(ctx.Context(), "next", function);
+      ctx.Builder().CreateCondBr(*value, thenBlock, nextBlock);
+      ctx.Builder().SetInsertPoint(thenBlock);
+    }
+
+    auto result = CodegenExpression(ctx, body);
     if (!result) {
       return std::nullopt;
     }
 
-    if (bodyType == nullptr && result.has_value())
-      bodyType = result.value()->getType();
-    else
-      assert(bodyType == result.value()->getType());
+    incoming.emplace_back(*result, ctx.Builder().GetInsertBlock());
+    ctx.Builder().CreateBr(mergeBlock);
 
-    branchValues.push_back(result.value());
-
-    GetLLVMBuilder()->CreateBr(mergeBlock);
+    if (nextBlock)
+      ctx.Builder().SetInsertPoint(nextBlock);
   }
 
-  function->getBasicBlockList().push_back(mergeBlock);
-  GetLLVMBuilder()->SetInsertPoint(mergeBlock);
+  // Without an else the last condition falls through to the merge block.
+  if (!hasElse)
+    ctx.Builder().CreateBr(mergeBlock);
 
-  if (bodyType == nullptr)
-    return llvm::ConstantDataSequential::getNullValue(
-        GetLLVMBuilder()->getVoidTy());
+  function->getBasicBlockList().push_back(mergeBlock);
+  ctx.Builder().SetInsertPoint(mergeBlock);
 
-  auto phi = GetLLVMBuilder()->CreatePHI(bodyType, ifExpr->Size());
+  auto bodyType = incoming.front().first->getType();
+  if (!hasElse || bodyType->isVoidTy())
+    return UnitValue(ctx);
 
-  for (size_t i = 0; i < ifExpr->Size(); i++) {
-    phi->addIncoming(branchValues[i], branchBlocks[i]);
+  auto phi = ctx.Builder().CreatePHI(bodyType, incoming.size());
+  for (auto &[value, block] : incoming) {
+    assert(value->getType() == bodyType);
+    phi->addIncoming(value, block);
   }
 
-  if (!hasElse)
-    phi->addIncoming(llvm::ConstantDataSequential::getNullValue(bodyType),
-                     &entry);
-
   return phi;
 }
 
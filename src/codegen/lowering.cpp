@@ -0,0 +1,96 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <codegen/lowering.hpp>
+
+namespace aatbe::codegen {
+
+using namespace aatbe::typesys;
+
+llvm::Type *TypeLowering::Lower(TypeId const &id) {
+  assert(id.System() == &types && "type from another TypeSystem");
+
+  auto index = id.Value();
+  if (index >= cache.size())
+    cache.resize(types.Count(), nullptr);
+
+  if (auto lowered = cache[index])
+    return lowered;
+
+  auto lowered = Compute(id);
+  cache[index] = lowered;
+  return lowered;
+}
+
+unsigned TypeLowering::FieldIndex(TypeId const &id, size_t declIndex) {
+  auto &fields = layouts.Get(id).fields;
+  for (unsigned i = 0; i < fields.size(); i++)
+    if (fields[i].index == declIndex)
+      return i;
+
+  assert(false && "no such field");
+  return 0;
+}
+
+void TypeLowering::LowerStructBody(TypeId const &id,
+                                   llvm::StructType *lowered) {
+  auto type = id.Resolve<typesys::StructType>();
+
+  std::vector<llvm::Type *> fields;
+  for (auto &field : layouts.Get(id).fields)
+    fields.push_back(Lower(type->Fields()[field.index].second));
+
+  lowered->setBody(fields);
+}
+
+llvm::Type *TypeLowering::Compute(TypeId const &id) {
+  auto type = types.GetType(id);
+
+  switch (type->Kind()) {
+  case TypeKind::TyInt:
+    return llvm::IntegerType::get(context,
+                                  8u << (unsigned)type->As<IntType>()->Size());
+  case TypeKind::TyFloat:
+    return type->As<typesys::FloatType>()->Size() ==
+                   typesys::FloatType::FloatSize::Float32
+               ? llvm::Type::getFloatTy(context)
+               : llvm::Type::getDoubleTy(context);
+  case TypeKind::TyBool:
+    return llvm::Type::getInt1Ty(context);
+  case TypeKind::TyChar:
+    return llvm::Type::getInt8Ty(context);
+  case TypeKind::TyPointer:
+    return llvm::PointerType::get(
+        Lower(type->As<typesys::PointerType>()->Type()), 0);
+  case TypeKind::TyArray: {
+    auto array = type->As<typesys::ArrayType>();
+    return llvm::ArrayType::get(Lower(array->Type()), array->Size());
+  }
+  case TypeKind::TyFunction: {
+    auto function = type->As<FunctionType>();
+
+    std::vector<llvm::Type *> params;
+    for (auto &param : function->Params())
+      params.push_back(Lower(param));
+
+    return llvm::FunctionType::get(Lower(function->Return()), params,
+                                   function->Variadic());
+  }
+  case TypeKind::TyStruct: {
+    // Cache the named struct before lowering its fields so that fields
+    // pointing back at the struct resolve to the same type.
+    auto lowered = llvm::StructType::create(
+        context, type->As<typesys::StructType>()->Name());
+    cache[id.Value()] = lowered;
+    LowerStructBody(id, lowered);
+    return lowered;
+  }
+  case TypeKind::TyUnit:
+  case TypeKind::TyVoid:
+  default:
+    return llvm::Type::getVoidTy(context);
+  }
+}
+
+} // namespace aatbe::codegen
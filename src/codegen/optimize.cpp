@@ -0,0 +1,139 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <codegen/optimize.hpp>
+#include <timing.hpp>
+
+#include <llvm/Analysis/LazyCallGraph.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/PassInstrumentation.h>
+#include <llvm/Passes/PassBuilder.h>
+
+namespace aatbe::codegen {
+
+#if LLVM_VERSION_MAJOR >= 14
+using LLVMOptLevel = llvm::OptimizationLevel;
+#else
+using LLVMOptLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
+
+std::optional<OptLevel> ParseOptLevel(std::string_view level) {
+  if (level == "0")
+    return OptLevel::O0;
+  if (level == "1")
+    return OptLevel::O1;
+  if (level == "2")
+    return OptLevel::O2;
+  if (level == "3")
+    return OptLevel::O3;
+  if (level == "s")
+    return OptLevel::Os;
+  return std::nullopt;
+}
+
+std::string_view FormatOptLevel(OptLevel level) {
+  switch (level) {
+  case OptLevel::O1:
+    return "1";
+  case OptLevel::O2:
+    return "2";
+  case OptLevel::O3:
+    return "3";
+  case OptLevel::Os:
+    return "s";
+  case OptLevel::O0:
+  default:
+    return "0";
+  }
+}
+
+static LLVMOptLevel ToLLVM(OptLevel level) {
+  switch (level) {
+  case OptLevel::O1:
+    return LLVMOptLevel::O1;
+  case OptLevel::O2:
+    return LLVMOptLevel::O2;
+  case OptLevel::O3:
+    return LLVMOptLevel::O3;
+  case OptLevel::Os:
+    return LLVMOptLevel::Os;
+  case OptLevel::O0:
+  default:
+    return LLVMOptLevel::O0;
+  }
+}
+
+// Pass managers and adaptors only run other passes, which have scopes of
+// their own.
+static bool RunsPasses(llvm::StringRef pass) {
+  return pass.contains("PassManager") || pass.contains("PassAdaptor") ||
+         pass.contains("AnalysisManagerProxy") ||
+         pass.contains("RepeatedPass") || pass == "ModuleInlinerWrapperPass";
+}
+
+// The function, loop or call graph SCC a pass runs on.
+static std::string UnitName(llvm::Any IR) {
+  if (llvm::any_isa<const llvm::Function *>(IR))
+    return llvm::any_cast<const llvm::Function *>(IR)->getName().str();
+  if (llvm::any_isa<const llvm::Loop *>(IR))
+    return llvm::any_cast<const llvm::Loop *>(IR)
+        ->getHeader()
+        ->getParent()
+        ->getName()
+        .str();
+  if (llvm::any_isa<const llvm::LazyCallGraph::SCC *>(IR))
+    return llvm::any_cast<const llvm::LazyCallGraph::SCC *>(IR)->getName();
+  if (llvm::any_isa<const llvm::Module *>(IR))
+    return llvm::any_cast<const llvm::Module *>(IR)->getModuleIdentifier();
+  return {};
+}
+
+// A timing scope for every pass that runs, named after the pass.
+static void TimePasses(llvm::PassInstrumentationCallbacks &PIC) {
+  PIC.registerBeforeNonSkippedPassCallback([](llvm::StringRef pass,
+                                              llvm::Any IR) {
+    if (!RunsPasses(pass))
+      timing::Begin(pass, UnitName(IR));
+  });
+  PIC.registerAfterPassCallback(
+      [](llvm::StringRef pass, llvm::Any, const llvm::PreservedAnalyses &) {
+        if (!RunsPasses(pass))
+          timing::End();
+      });
+  PIC.registerAfterPassInvalidatedCallback(
+      [](llvm::StringRef pass, const llvm::PreservedAnalyses &) {
+        if (!RunsPasses(pass))
+          timing::End();
+      });
+}
+
+void OptimizeModule(llvm::Module &module, OptLevel level,
+                    llvm::TargetMachine *machine) {
+  timing::Scope scope("Optimize",
+                      [&] { return module.getModuleIdentifier(); });
+  llvm::PassInstrumentationCallbacks PIC;
+  if (timing::Recording())
+    TimePasses(PIC);
+
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  llvm::PassBuilder PB(machine, llvm::PipelineTuningOptions(), llvm::None,
+                       &PIC);
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  auto MPM = level == OptLevel::O0
+                 ? PB.buildO0DefaultPipeline(LLVMOptLevel::O0)
+                 : PB.buildPerModuleDefaultPipeline(ToLLVM(level));
+  MPM.run(module, MAM);
+}
+
+} // namespace aatbe::codegen
@@ -0,0 +1,113 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <codegen/prelude.hpp>
+#include <codegen/session.hpp>
+#include <timing.hpp>
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+
+namespace aatbe::codegen {
+
+// `fn name (a: T, ...) -> R`, a declaration of `function`.
+static std::string Declaration(parser::FunctionStatement *function) {
+  std::string parameters;
+  for (auto binding : function->Parameters()->Bindings())
+    parameters += (parameters.empty() ? "" : ", ") + binding->Name() + ": " +
+                  binding->Type()->Source();
+  if (function->IsVariadic())
+    parameters += parameters.empty() ? "..." : ", ...";
+
+  return "fn " + function->Name() + " (" + parameters + ") -> " +
+         function->ReturnType()->Source() + "\n";
+}
+
+std::string Prelude::InterfacePath(const std::string &path) {
+  llvm::SmallString<128> interface(path);
+  llvm::sys::path::replace_extension(interface, "aati");
+  return interface.str().str();
+}
+
+std::string Prelude::DefaultPath() {
+  if (auto path = llvm::sys::Process::GetEnv("AATBE_PRELUDE"))
+    return *path;
+#ifdef AATBE_PRELUDE
+  if (llvm::sys::fs::exists(AATBE_PRELUDE))
+    return AATBE_PRELUDE;
+#endif
+  return "";
+}
+
+llvm::Expected<std::shared_ptr<const Prelude>>
+Prelude::Load(const std::string &path) {
+  auto bitcode = llvm::MemoryBuffer::getFile(path);
+  if (!bitcode)
+    return llvm::createFileError(path, bitcode.getError());
+  auto interfacePath = InterfacePath(path);
+  auto interface = llvm::MemoryBuffer::getFile(interfacePath);
+  if (!interface)
+    return llvm::createFileError(interfacePath, interface.getError());
+
+  // Only the header is read here, bodies are read by whoever links them.
+  llvm::LLVMContext context;
+  auto module = llvm::getLazyBitcodeModule(**bitcode, context);
+  if (!module)
+    return llvm::createFileError(path, module.takeError());
+
+  return std::make_shared<const Prelude>(
+      path, (*interface)->getBuffer().str(), std::move(*bitcode));
+}
+
+llvm::Error Prelude::Write(CompilationSession &session, OptLevel level,
+                           const std::string &path) {
+  std::string interface;
+  for (auto statement : session.Node()->Value())
+    if (statement->Kind() == parser::ModuleStatementKind::Function)
+      interface += Declaration(statement->AsFunction());
+
+  std::error_code error;
+  llvm::raw_fd_ostream interfaceOut(InterfacePath(path), error);
+  if (error)
+    return llvm::createFileError(InterfacePath(path), error);
+  interfaceOut << interface;
+
+  auto module = session.Codegen(level);
+  llvm::raw_fd_ostream bitcodeOut(path, error);
+  if (error)
+    return llvm::createFileError(path, error);
+  module.withModuleDo(
+      [&](llvm::Module &M) { llvm::WriteBitcodeToFile(M, bitcodeOut); });
+  return llvm::Error::success();
+}
+
+llvm::Error Prelude::LinkInto(llvm::Module &module) const {
+  timing::Scope scope("Link prelude",
+                      [&] { return module.getModuleIdentifier(); });
+  auto prelude = llvm::getLazyBitcodeModule(*bitcode, module.getContext());
+  if (!prelude)
+    return prelude.takeError();
+
+  // LinkOnlyNeeded reads and links only what `module` refers to.
+  auto failed = llvm::Linker::linkModules(
+      module, std::move(*prelude), llvm::Linker::Flags::LinkOnlyNeeded,
+      [](llvm::Module &M, const llvm::StringSet<> &linked) {
+        llvm::internalizeModule(M, [&](const llvm::GlobalValue &GV) {
+          return !GV.hasName() || !linked.count(GV.getName());
+        });
+      });
+  if (failed)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "cannot link the prelude into %s",
+                                   module.getModuleIdentifier().c_str());
+  return llvm::Error::success();
+}
+
+} // namespace aatbe::codegen
@@ -0,0 +1,244 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <accounting.hpp>
+#include <codegen.hpp>
+#include <codegen/emit.hpp>
+#include <codegen/session.hpp>
+
+#include <lexer/lexer.hpp>
+#include <parser/parser.hpp>
+#include <source/source_file.hpp>
+#include <timing.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+
+using namespace aatbe::lexer;
+using namespace aatbe::source;
+
+namespace aatbe::codegen {
+
+bool CompilationSession::AnalyzeFile(const std::string &file) {
+  std::unique_ptr<SrcFile> src;
+  {
+    timing::Scope scope("Load source", [&] { return file; });
+    src = SrcFile::FromFile(file);
+  }
+  if (!src) {
+    diagnostics.push_back("Could not open the file - '" + file + "'");
+    return false;
+  }
+  auto &source = src->Content();
+  Lexer lexer(std::move(src));
+  return Analyze(source, lexer.Lex());
+}
+
+bool CompilationSession::AnalyzeSource(const std::string &source) {
+  Lexer lexer(SrcFile::FromString(source.c_str()));
+  return Analyze(source, lexer.Lex());
+}
+
+bool CompilationSession::Analyze(const std::string &source,
+                                 std::vector<Token *> tokens) {
+  assert(!mod && "session already analyzed a module");
+
+  lines.push_back(0);
+  for (size_t at = 0; at < source.size(); at++)
+    if (source[at] == '\n')
+      lines.push_back(at + 1);
+
+  parser::Parser parser(std::move(tokens));
+
+  auto result = parser.Parse();
+  if (!result) {
+    diagnostics.push_back(name + ": parse error");
+    return false;
+  }
+  mod = result.Node();
+  if (prelude && !(mod = WithPrelude(mod))) {
+    diagnostics.push_back(prelude->Path() + ": parse error");
+    return false;
+  }
+
+  bool resolved;
+  {
+    timing::Scope scope("Resolve", [&] { return name; });
+    accounting::PhaseScope phase(accounting::Phase::Typesys);
+    resolved = symbols.ResolveModule(mod);
+  }
+  if (!resolved) {
+    for (auto &error : symbols.Errors())
+      diagnostics.push_back(name + ": error " + error.Format());
+    return false;
+  }
+
+  bool inferred;
+  {
+    timing::Scope scope("Infer", [&] { return name; });
+    accounting::PhaseScope phase(accounting::Phase::Typesys);
+    inferred = inference.InferModule(mod);
+  }
+  if (!inferred) {
+    for (auto &error : inference.Errors())
+      diagnostics.push_back(name + ": type error " + error.Format());
+    return false;
+  }
+
+  return true;
+}
+
+parser::ModuleNode *
+CompilationSession::WithPrelude(parser::ModuleNode *module) {
+  Lexer lexer(SrcFile::FromString(prelude->Interface().c_str()));
+  parser::Parser parser(lexer.Lex());
+  auto result = parser.Parse();
+  if (!result)
+    return nullptr;
+
+  std::unordered_set<std::string> declared;
+  for (auto statement : module->Value())
+    if (statement->Kind() == parser::ModuleStatementKind::Function)
+      declared.insert(statement->AsFunction()->Name());
+
+  std::vector<parser::ModuleStatementNode *> statements;
+  for (auto statement : result.Node()->Value())
+    if (!declared.count(statement->AsFunction()->Name()))
+      statements.push_back(statement);
+  auto own = module->Value();
+  statements.insert(statements.end(), own.begin(), own.end());
+  return new parser::ModuleNode(std::move(statements));
+}
+
+bool CompilationSession::AnalyzeIncrement(const std::string &source) {
+  Lexer lexer(SrcFile::FromString(source.c_str()));
+  parser::Parser parser(lexer.Lex());
+
+  auto result = parser.Parse();
+  if (!result) {
+    diagnostics.push_back(name + ": parse error");
+    return false;
+  }
+  auto statements = result.Node()->Value();
+
+  accounting::PhaseScope phase(accounting::Phase::Typesys);
+  auto count = symbols.Functions().size();
+  if (!symbols.ResolveStatements(statements, true)) {
+    for (auto &error : symbols.Errors())
+      diagnostics.push_back(name + ": error " + error.Format());
+    return false;
+  }
+
+  if (!inference.InferStatements(statements)) {
+    for (auto &error : inference.Errors())
+      diagnostics.push_back(name + ": type error " + error.Format());
+    symbols.Truncate(count);
+    return false;
+  }
+
+  if (!mod)
+    mod = new parser::ModuleNode({});
+  mod->Append(statements);
+  return true;
+}
+
+bool CompilationSession::AnalyzeExpression(const std::string &name,
+                                           const std::string &source) {
+  Lexer lexer(SrcFile::FromString(source.c_str()));
+  parser::Parser parser(lexer.Lex());
+
+  accounting::PhaseScope parsing(accounting::Phase::Parser);
+  auto body = parser::ParseExpression(parser);
+  if (!body || parser.Peek()) {
+    diagnostics.push_back(this->name + ": parse error");
+    return false;
+  }
+
+  auto decl = new parser::FunctionStatement(
+      false, name,
+      new parser::ParameterList(std::vector<parser::ParameterBinding *>{}),
+      new parser::TypeNode(new parser::UnitType()), body.Node(), false);
+  std::vector<parser::ModuleStatementNode *> statements{
+      new parser::ModuleStatementNode(decl)};
+
+  accounting::PhaseScope typing(accounting::Phase::Typesys);
+  auto count = symbols.Functions().size();
+  if (!symbols.ResolveStatements(statements, true)) {
+    for (auto &error : symbols.Errors())
+      diagnostics.push_back(this->name + ": error " + error.Format());
+    return false;
+  }
+
+  if (!inference.InferExpression(decl)) {
+    for (auto &error : inference.Errors())
+      diagnostics.push_back(this->name + ": type error " + error.Format());
+    symbols.Truncate(count);
+    return false;
+  }
+
+  if (!mod)
+    mod = new parser::ModuleNode({});
+  return true;
+}
+
+unsigned CompilationSession::Line(size_t offset) const {
+  return (unsigned)(std::upper_bound(lines.begin(), lines.end(), offset) -
+                    lines.begin());
+}
+
+llvm::orc::ThreadSafeModule
+CompilationSession::EmitShard(const std::string &moduleName, uint32_t begin,
+                              uint32_t end, OptLevel level) {
+  accounting::PhaseScope phase(accounting::Phase::Codegen);
+  CompilerContext ctx(*this, moduleName);
+  EmitModule(ctx, mod, begin, end);
+
+  if (prelude && linkPrelude)
+    if (auto err = prelude->LinkInto(ctx.Module()))
+      llvm::logAllUnhandledErrors(std::move(err), llvm::errs(),
+                                  moduleName + ": ");
+
+  if (level != OptLevel::O0) {
+    // A target machine per shard, they are not safe to share across threads.
+    std::unique_ptr<llvm::TargetMachine> machine;
+    if (auto TM = CreateHostMachine(level))
+      machine = std::move(*TM);
+    else
+      llvm::consumeError(TM.takeError());
+    OptimizeModule(ctx.Module(), level, machine.get());
+  }
+
+  return ctx.TakeModule();
+}
+
+llvm::orc::ThreadSafeModule CompilationSession::Codegen(OptLevel level) {
+  return EmitShard(name, 0, (uint32_t)symbols.Functions().size(), level);
+}
+
+std::vector<llvm::orc::ThreadSafeModule>
+CompilationSession::CodegenParallel(unsigned shards, OptLevel level) {
+  auto count = (uint32_t)symbols.Functions().size();
+  shards = std::max(1u, std::min(shards, count));
+
+  std::vector<llvm::orc::ThreadSafeModule> modules(shards);
+  std::vector<std::thread> workers;
+
+  for (unsigned shard = 0; shard < shards; shard++) {
+    workers.emplace_back([this, shard, shards, count, level, &modules] {
+      auto begin = (uint32_t)((uint64_t)count * shard / shards);
+      auto end = (uint32_t)((uint64_t)count * (shard + 1) / shards);
+
+      modules[shard] = EmitShard(name + ".shard" + std::to_string(shard),
+                                 begin, end, level);
+    });
+  }
+
+  for (auto &worker : workers)
+    worker.join();
+
+  return modules;
+}
+
+} // namespace aatbe::codegen
@@ -0,0 +1,149 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <engine.hpp>
+
+namespace aatbe {
+
+// The signature of `function`, spelled like Signature::Name.
+static std::string Spell(parser::FunctionStatement *function) {
+  std::string parameters;
+  for (auto binding : function->Parameters()->Bindings())
+    parameters += (parameters.empty() ? "" : ", ") + binding->Type()->Source();
+  if (function->IsVariadic())
+    parameters += parameters.empty() ? "..." : ", ...";
+  return function->ReturnType()->Source() + "(" + parameters + ")";
+}
+
+static llvm::Error Diagnostics(codegen::CompilationSession &session) {
+  std::string message;
+  for (auto &diagnostic : session.Diagnostics())
+    message += (message.empty() ? "" : "\n") + diagnostic;
+  return llvm::createStringError(llvm::inconvertibleErrorCode(), message);
+}
+
+llvm::Expected<std::unique_ptr<Engine>>
+Engine::Create(const jit::JitOptions &options) {
+  std::shared_ptr<const codegen::Prelude> prelude;
+  if (!options.PreludePath.empty()) {
+    auto loaded = codegen::Prelude::Load(options.PreludePath);
+    if (!loaded)
+      return loaded.takeError();
+    prelude = std::move(*loaded);
+  }
+
+  auto jit = jit::AatbeJit::Create(options);
+  if (!jit)
+    return jit.takeError();
+  return std::make_unique<Engine>(std::move(*jit), std::move(prelude));
+}
+
+llvm::Expected<Engine::ModuleId> Engine::compile(const std::string &source,
+                                                 const std::string &name) {
+  codegen::CompilationSession session(name);
+  session.SetPrelude(prelude);
+  if (!session.AnalyzeSource(source))
+    return Diagnostics(session);
+  std::vector<llvm::orc::ThreadSafeModule> code;
+  code.push_back(session.Codegen());
+  return add(session, std::move(code));
+}
+
+llvm::Expected<Engine::ModuleId>
+Engine::compileFile(const std::string &file) {
+  codegen::CompilationSession session(file);
+  session.SetPrelude(prelude);
+  if (!session.AnalyzeFile(file))
+    return Diagnostics(session);
+  std::vector<llvm::orc::ThreadSafeModule> code;
+  code.push_back(session.Codegen());
+  return add(session, std::move(code));
+}
+
+llvm::Expected<Engine::ModuleId>
+Engine::add(codegen::CompilationSession &session,
+            std::vector<llvm::orc::ThreadSafeModule> emitted) {
+  std::lock_guard guard(lock);
+
+  // Checked here, the JIT only finds out when it links the second
+  // definition.
+  Module module{jit->getMainJITDylib().createResourceTracker(), {}};
+  for (auto function : session.Symbols().Functions()) {
+    if (!function->Body().has_value())
+      continue;
+    if (symbols.count(function->Name()))
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "%s: `%s` is already defined",
+                                     session.Name().c_str(),
+                                     function->Name().c_str());
+    module.functions.push_back(function->Name());
+  }
+
+  for (auto &code : emitted)
+    if (auto err = jit->addModule(std::move(code), module.tracker)) {
+      llvm::consumeError(module.tracker->remove());
+      return err;
+    }
+
+  auto id = next++;
+  for (auto function : session.Symbols().Functions())
+    if (function->Body().has_value())
+      symbols[function->Name()] = {Spell(function), id};
+  modules[id] = std::move(module);
+  return id;
+}
+
+llvm::Error Engine::unload(ModuleId id) {
+  std::lock_guard guard(lock);
+  auto module = modules.find(id);
+  if (module == modules.end())
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "no module %llu", (unsigned long long)id);
+
+  for (auto &name : module->second.functions)
+    symbols.erase(name);
+  auto tracker = std::move(module->second.tracker);
+  modules.erase(module);
+  return tracker->remove();
+}
+
+llvm::Expected<std::string> Engine::signature(llvm::StringRef name) {
+  std::lock_guard guard(lock);
+  auto symbol = symbols.find(name.str());
+  if (symbol == symbols.end())
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "no function `%s`", name.str().c_str());
+  return symbol->second.signature;
+}
+
+std::array<accounting::Usage, accounting::PhaseCount> Engine::memoryUsage() {
+  std::array<accounting::Usage, accounting::PhaseCount> usage;
+  for (size_t phase = 0; phase < accounting::PhaseCount; phase++)
+    usage[phase] = accounting::Get((accounting::Phase)phase);
+  return usage;
+}
+
+llvm::Expected<uint64_t> Engine::resolve(llvm::StringRef name,
+                                         const std::string &signature) {
+  std::lock_guard guard(lock);
+  auto symbol = symbols.find(name.str());
+  if (symbol == symbols.end())
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "no function `%s`", name.str().c_str());
+  if (symbol->second.signature != signature)
+    return llvm::createStringError(
+        llvm::inconvertibleErrorCode(), "`%s` is %s, not %s",
+        name.str().c_str(), symbol->second.signature.c_str(),
+        signature.c_str());
+
+  if (symbol->second.address == 0) {
+    auto found = jit->lookup(name);
+    if (!found)
+      return found.takeError();
+    symbol->second.address = found->getAddress();
+  }
+  return symbol->second.address;
+}
+
+} // namespace aatbe
@@ -4,12 +4,18 @@
 
 #include <jit.hpp>
 
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/DebugObjectManagerPlugin.h>
+#include <llvm/ExecutionEngine/Orc/EPCDebugObjectRegistrar.h>
+
 using namespace llvm;
 using namespace llvm::orc;
 
 namespace aatbe::jit {
 
-Expected<std::unique_ptr<AatbeJit>> AatbeJit::Create() {
+Expected<std::unique_ptr<AatbeJit>>
+AatbeJit::Create(const JitOptions &Options) {
   auto EPC = SelfExecutorProcessControl::Create();
   if (!EPC)
     return EPC.takeError();
@@ -23,19 +29,192 @@ Expected<std::unique_ptr<AatbeJit>> AatbeJit::Create() {
   if (!DL)
     return DL.takeError();
 
-  return std::make_unique<AatbeJit>(std::move(ES), std::move(JTMB),
-                                    std::move(*DL));
+  auto J = std::make_unique<AatbeJit>(std::move(ES), std::move(JTMB),
+                                      std::move(*DL), Options);
+  if (Options.Linker == ObjectLinker::JITLink) {
+    if (auto Err = J->addLinkerPlugins(Options))
+      return Err;
+  } else if (!Options.PerfMapPath.empty() || Options.DebuggerSupport) {
+    return createStringError(inconvertibleErrorCode(),
+                             "perf maps and debugger support need JITLink");
+  }
+  if (Options.Linker == ObjectLinker::JITLink && Options.SlabBytes != 0)
+    return createStringError(inconvertibleErrorCode(),
+                             "slab memory needs RuntimeDyld");
+
+  if (Options.Mode == JitMode::Lazy)
+    if (auto Err = J->enableLazyCompilation())
+      return Err;
+
+  if (!Options.PreludePath.empty())
+    if (auto Err = J->loadPrelude(Options.PreludePath))
+      return Err;
+
+  return J;
+}
+
+std::unique_ptr<ObjectLayer>
+AatbeJit::createObjectLayer(ExecutionSession &ES, ObjectLinker Linker,
+                            SlabPool *Slabs) {
+  if (Linker == ObjectLinker::JITLink)
+    return std::make_unique<ObjectLinkingLayer>(ES);
+
+  if (Slabs)
+    return std::make_unique<RTDyldObjectLinkingLayer>(
+        ES, [Slabs]() { return Slabs->CreateMemoryManager(); });
+  return std::make_unique<RTDyldObjectLinkingLayer>(
+      ES, []() { return std::make_unique<SectionMemoryManager>(); });
+}
+
+Error AatbeJit::addLinkerPlugins(const JitOptions &Options) {
+  auto &Linker = static_cast<ObjectLinkingLayer &>(*ObjLayer);
+
+  if (!Options.PerfMapPath.empty()) {
+    auto Plugin = std::make_unique<PerfMapPlugin>(Options.PerfMapPath);
+    PerfMap = Plugin.get();
+    Linker.addPlugin(std::move(Plugin));
+  }
+
+  if (Options.DebuggerSupport) {
+    auto Registrar = createJITLoaderGDBRegistrar(*ES);
+    if (!Registrar)
+      return Registrar.takeError();
+    Linker.addPlugin(
+        std::make_unique<DebugObjectManagerPlugin>(*ES, std::move(*Registrar)));
+  }
+
+  return Error::success();
+}
+
+void AatbeJit::dispatchToThreads(unsigned Threads) {
+  CompileThreads =
+      std::make_unique<ThreadPool>(hardware_concurrency(Threads));
+
+#if LLVM_VERSION_MAJOR >= 14
+  ES->setDispatchTask([this](std::unique_ptr<Task> T) {
+    // ThreadPool tasks must be copyable, hand the task over as a raw pointer.
+    CompileThreads->async([UnownedT = T.release()]() {
+      std::unique_ptr<Task> T(UnownedT);
+      T->run();
+    });
+  });
+#else
+  ES->setDispatchMaterialization(
+      [this](std::unique_ptr<MaterializationUnit> MU,
+             std::unique_ptr<MaterializationResponsibility> MR) {
+        CompileThreads->async(
+            [UnownedMU = MU.release(), UnownedMR = MR.release()]() {
+              std::unique_ptr<MaterializationUnit> MU(UnownedMU);
+              std::unique_ptr<MaterializationResponsibility> MR(UnownedMR);
+              MU->materialize(std::move(MR));
+            });
+      });
+#endif
+}
+
+Error AatbeJit::enableLazyCompilation() {
+  auto LCTM = createLocalLazyCallThroughManager(TT, *ES, 0);
+  if (!LCTM)
+    return LCTM.takeError();
+  LCTMgr = std::move(*LCTM);
+
+  CODLayer = std::make_unique<CompileOnDemandLayer>(
+      *ES, OptimizeLayer, *LCTMgr, createLocalIndirectStubsManagerBuilder(TT));
+  CODLayer->setPartitionFunction(CompileOnDemandLayer::compileRequested);
+  return Error::success();
+}
+
+Error AatbeJit::loadPrelude(StringRef Path) {
+  auto Bitcode = MemoryBuffer::getFile(Path);
+  if (!Bitcode)
+    return createFileError(Path, Bitcode.getError());
+
+  PreludeJD = &ES->createBareJITDylib("<prelude>");
+  PreludeJD->addGenerator(
+      cantFail(DynamicLibrarySearchGenerator::GetForCurrentProcess(0)));
+  MainJD.addToLinkOrder(*PreludeJD);
+
+  if (Cache) {
+    PreludeKey = Cache->Key((*Bitcode)->getMemBufferRef(), "prelude");
+    if (auto Object = Cache->Lookup(PreludeKey))
+      return ObjLayer->add(*PreludeJD, std::move(Object));
+  }
+
+  auto Context = std::make_unique<LLVMContext>();
+  auto M = getOwningLazyBitcodeModule(std::move(*Bitcode), *Context);
+  if (!M)
+    return createFileError(Path, M.takeError());
+  return PreludeLayer.add(*PreludeJD,
+                          ThreadSafeModule(std::move(*M), std::move(Context)));
+}
+
+Expected<ThreadSafeModule>
+AatbeJit::materializePrelude(ThreadSafeModule TSM) {
+  if (auto Err = TSM.withModuleDo([&](Module &M) -> Error {
+        if (auto Err = M.materializeAll())
+          return Err;
+        if (!PreludeKey.empty())
+          DiskObjectCache::SetKey(M, PreludeKey);
+        return Error::success();
+      }))
+    return Err;
+  return TSM;
+}
+
+Expected<ThreadSafeModule>
+AatbeJit::optimizeModule(ThreadSafeModule TSM, JITTargetMachineBuilder JTMB,
+                         codegen::OptLevel Level) {
+  accounting::PhaseScope phase(accounting::Phase::Jit);
+  if (Level == codegen::OptLevel::O0)
+    return TSM;
+
+  auto TM = JTMB.createTargetMachine();
+  if (!TM)
+    return TM.takeError();
+
+  TSM.withModuleDo([&](Module &M) {
+    codegen::OptimizeModule(M, Level, TM->get());
+  });
+  return TSM;
 }
 
 Error AatbeJit::addModule(llvm::orc::ThreadSafeModule TSM,
                           llvm::orc::ResourceTrackerSP RT) {
+  accounting::PhaseScope phase(accounting::Phase::Jit);
   if (!RT)
     RT = this->MainJD.getDefaultResourceTracker();
-  return this->CompileLayer.add(RT, std::move(TSM));
+  if (this->CODLayer)
+    return this->CODLayer->add(RT, std::move(TSM));
+  if (this->Tiered)
+    return this->Tiered->addModule(std::move(TSM), RT);
+
+  // Look the module up before it is optimized, a hit skips the optimizer
+  // as well as codegen. Lazy partitions are keyed as they are compiled.
+  if (this->Cache) {
+    auto Key = TSM.withModuleDo([&](Module &M) {
+      auto Key = this->Cache->Key(M, codegen::FormatOptLevel(this->Level));
+      DiskObjectCache::SetKey(M, Key);
+      return Key;
+    });
+    if (auto Object = this->Cache->Lookup(Key))
+      return this->ObjLayer->add(RT, std::move(Object));
+  }
+
+  return this->OptimizeLayer.add(RT, std::move(TSM));
 }
 
 Expected<JITEvaluatedSymbol> AatbeJit::lookup(StringRef Name) {
-  return this->ES->lookup({&this->MainJD}, Name.str());
+  accounting::PhaseScope phase(accounting::Phase::Jit);
+  return this->ES->lookup({&this->MainJD}, this->Mangle(Name));
+}
+
+Expected<SymbolMap> AatbeJit::lookup(ArrayRef<std::string> Names) {
+  accounting::PhaseScope phase(accounting::Phase::Jit);
+  SymbolLookupSet Symbols;
+  for (auto &Name : Names)
+    Symbols.add(this->Mangle(Name));
+  return this->ES->lookup(makeJITDylibSearchOrder(&this->MainJD),
+                          std::move(Symbols));
 }
 
 } // namespace aatbe::jit
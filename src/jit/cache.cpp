@@ -0,0 +1,212 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <jit/cache.hpp>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <optional>
+
+#ifndef AATBE_VERSION
+#define AATBE_VERSION "unknown"
+#endif
+
+namespace aatbe::jit {
+
+DiskObjectCache::DiskObjectCache(std::string directory, uint64_t maxBytes,
+                                 const llvm::orc::JITTargetMachineBuilder &JTMB)
+    : directory(std::move(directory)), maxBytes(maxBytes) {
+  llvm::raw_string_ostream out(target);
+  out << JTMB.getTargetTriple().str() << '\0' << JTMB.getCPU() << '\0'
+      << JTMB.getFeatures().getString() << '\0'
+      << (int)JTMB.getRelocationModel().getValueOr(llvm::Reloc::Static)
+      << '\0' << (int)JTMB.getCodeModel().getValueOr(llvm::CodeModel::Small)
+      << '\0' << LLVM_VERSION_STRING << '\0' << AATBE_VERSION;
+  out.flush();
+
+  llvm::sys::fs::create_directories(this->directory);
+  for (auto &entry : Scan())
+    bytes += entry.size;
+}
+
+// Named metadata holding a key set with SetKey.
+static const char *KeyMetadata = "aatbe.object_cache.key";
+
+std::string DiskObjectCache::Key(const llvm::Module &M,
+                                 llvm::StringRef salt) const {
+  llvm::SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream out(bitcode);
+  llvm::WriteBitcodeToFile(M, out);
+  return Key(llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(),
+                                                   bitcode.size()),
+                                   M.getModuleIdentifier()),
+             salt);
+}
+
+std::string DiskObjectCache::Key(llvm::MemoryBufferRef bitcode,
+                                 llvm::StringRef salt) const {
+  llvm::SHA1 hasher;
+  hasher.update(target);
+  hasher.update(salt);
+  hasher.update(llvm::arrayRefFromStringRef(bitcode.getBuffer()));
+  return llvm::toHex(hasher.final(), true);
+}
+
+std::string DiskObjectCache::PathOf(const std::string &key) const {
+  llvm::SmallString<128> path(directory);
+  llvm::sys::path::append(path, key + ".o");
+  return path.str().str();
+}
+
+void DiskObjectCache::SetKey(llvm::Module &M, llvm::StringRef key) {
+  auto &context = M.getContext();
+  M.getOrInsertNamedMetadata(KeyMetadata)
+      ->addOperand(llvm::MDNode::get(context,
+                                     llvm::MDString::get(context, key)));
+}
+
+static std::optional<std::string> StoredKey(const llvm::Module &M) {
+  auto node = M.getNamedMetadata(KeyMetadata);
+  if (!node || node->getNumOperands() != 1)
+    return std::nullopt;
+  return llvm::cast<llvm::MDString>(node->getOperand(0)->getOperand(0))
+      ->getString()
+      .str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+DiskObjectCache::getObject(const llvm::Module *M) {
+  // A module with a key of its own was looked up before it was optimized.
+  auto key = StoredKey(*M);
+  std::unique_ptr<llvm::MemoryBuffer> object;
+  if (!key) {
+    key = Key(*M);
+    object = Lookup(*key);
+  }
+
+  // A module that failed to compile leaves its key behind. Every compile
+  // asks for its object first, so a later module at the same address
+  // replaces or drops the key here and is never stored under it.
+  std::lock_guard lock(pendingMutex);
+  if (object) {
+    pending.erase(M);
+    return object;
+  }
+  pending[M] = std::move(*key);
+  return nullptr;
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+DiskObjectCache::Lookup(const std::string &key) {
+  auto path = PathOf(key);
+
+  int fd;
+  if (!llvm::sys::fs::openFileForRead(path, fd)) {
+    auto buffer = llvm::MemoryBuffer::getOpenFile(fd, path, -1);
+    // Most recently used objects are evicted last.
+    llvm::sys::fs::setLastAccessAndModificationTime(
+        fd, std::chrono::system_clock::now());
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+    if (buffer) {
+      hits++;
+      return std::move(*buffer);
+    }
+  }
+
+  misses++;
+  return nullptr;
+}
+
+void DiskObjectCache::notifyObjectCompiled(const llvm::Module *M,
+                                           llvm::MemoryBufferRef Obj) {
+  std::string key;
+  {
+    std::lock_guard lock(pendingMutex);
+    auto it = pending.find(M);
+    if (it == pending.end())
+      return;
+    key = std::move(it->second);
+    pending.erase(it);
+  }
+
+  auto path = PathOf(key);
+  llvm::SmallString<128> temp;
+  int fd;
+  if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, temp))
+    return;
+
+  {
+    llvm::raw_fd_ostream out(fd, true);
+    out << Obj.getBuffer();
+    out.close();
+    if (out.has_error()) {
+      out.clear_error();
+      llvm::sys::fs::remove(temp);
+      return;
+    }
+  }
+
+  if (llvm::sys::fs::rename(temp, path)) {
+    llvm::sys::fs::remove(temp);
+    return;
+  }
+
+  // Other processes sharing the directory are only noticed when the
+  // estimate goes over the limit and the directory is scanned again.
+  if ((bytes += Obj.getBufferSize()) > maxBytes)
+    Evict(path);
+}
+
+std::vector<DiskObjectCache::Entry> DiskObjectCache::Scan() const {
+  std::vector<Entry> entries;
+
+  std::error_code EC;
+  for (llvm::sys::fs::directory_iterator it(directory, EC), end;
+       it != end && !EC; it.increment(EC)) {
+    if (llvm::sys::path::extension(it->path()) != ".o")
+      continue;
+
+    llvm::sys::fs::file_status status;
+    if (llvm::sys::fs::status(it->path(), status))
+      continue;
+
+    entries.push_back(
+        {it->path(), status.getSize(), status.getLastModificationTime()});
+  }
+
+  return entries;
+}
+
+void DiskObjectCache::Evict(const std::string &keep) {
+  std::lock_guard lock(evictMutex);
+
+  auto entries = Scan();
+  uint64_t total = 0;
+  for (auto &entry : entries)
+    total += entry.size;
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) {
+              return a.modified < b.modified;
+            });
+
+  for (auto &entry : entries) {
+    if (total <= maxBytes)
+      break;
+    if (entry.path != keep && !llvm::sys::fs::remove(entry.path))
+      total -= entry.size;
+  }
+  bytes = total;
+}
+
+} // namespace aatbe::jit
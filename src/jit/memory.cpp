@@ -0,0 +1,269 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <jit/memory.hpp>
+
+#include <llvm/ExecutionEngine/RuntimeDyld.h>
+#include <llvm/Support/Alignment.h>
+#include <llvm/Support/Memory.h>
+#include <llvm/Support/Process.h>
+
+#include <chrono>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace llvm;
+
+namespace aatbe::jit {
+
+static Error errnoError(const char *what) {
+  return createStringError(std::error_code(errno, std::generic_category()),
+                           "slab %s failed", what);
+}
+
+// Allocates the sections of one object from a SlabPool. RuntimeDyld writes
+// through the writable view, and notifyObjectLoaded moves the sections to
+// their executable view before relocations are applied.
+class SlabMemoryManager : public RTDyldMemoryManager {
+public:
+  explicit SlabMemoryManager(SlabPool &pool) : pool(pool) {}
+  ~SlabMemoryManager() override {
+    for (auto &block : blocks)
+      pool.Release(block);
+  }
+
+  uint8_t *allocateCodeSection(uintptr_t Size, unsigned Alignment,
+                               unsigned SectionID,
+                               StringRef SectionName) override {
+    return Allocate(SlabPool::Kind::Code, Size, Alignment);
+  }
+
+  uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment,
+                               unsigned SectionID, StringRef SectionName,
+                               bool IsReadOnly) override {
+    return Allocate(IsReadOnly ? SlabPool::Kind::ReadOnly
+                               : SlabPool::Kind::ReadWrite,
+                    Size, Alignment);
+  }
+
+  void notifyObjectLoaded(RuntimeDyld &RTDyld,
+                          const object::ObjectFile &Obj) override {
+    for (auto &block : blocks)
+      if (block.write != block.target)
+        RTDyld.mapSectionAddress(block.write,
+                                 (uint64_t)(uintptr_t)block.target);
+  }
+
+  // The frames are registered where they run from, their pc-relative
+  // entries are relocated against that address.
+  void registerEHFrames(uint8_t *Addr, uint64_t LoadAddr,
+                        size_t Size) override {
+    RTDyldMemoryManager::registerEHFrames((uint8_t *)(uintptr_t)LoadAddr,
+                                          LoadAddr, Size);
+  }
+
+  bool finalizeMemory(std::string *ErrMsg) override {
+    auto start = std::chrono::steady_clock::now();
+    for (auto &block : blocks)
+      if (block.kind == SlabPool::Kind::Code)
+        sys::Memory::InvalidateInstructionCache(block.target, block.size);
+    pool.RecordFinalize(std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count());
+    return false;
+  }
+
+private:
+  uint8_t *Allocate(SlabPool::Kind kind, uintptr_t size, unsigned alignment) {
+    auto block = pool.Allocate(kind, size, alignment);
+    if (!block) {
+      logAllUnhandledErrors(block.takeError(), errs(), "JIT memory: ");
+      return nullptr;
+    }
+    blocks.push_back(*block);
+    return block->write;
+  }
+
+  SlabPool &pool;
+  std::vector<SlabPool::Block> blocks{};
+};
+
+SlabPool::SlabPool(size_t slabBytes)
+    : pageSize(sys::Process::getPageSizeEstimate()) {
+  this->slabBytes = alignTo(std::max(slabBytes, pageSize), pageSize);
+}
+
+SlabPool::~SlabPool() {
+  for (auto &slab : slabs) {
+    munmap(slab.write, slab.size);
+    if (slab.target != slab.write)
+      munmap(slab.target, slab.size);
+  }
+}
+
+Error SlabPool::Map(Kind kind, size_t size) {
+  Slab slab{kind, nullptr, nullptr, size, {}, {}};
+  slab.AddFree(0, size);
+
+  if (kind == Kind::ReadWrite) {
+    auto memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+      return errnoError("mmap");
+    slab.write = slab.target = (uint8_t *)memory;
+    slabs.push_back(std::move(slab));
+    return Error::success();
+  }
+
+  // Both views share the pages of an anonymous file.
+#if defined(__linux__)
+  auto fd = memfd_create("aatbe-jit", MFD_CLOEXEC);
+#else
+  auto name = "/aatbe-jit-" + std::to_string(getpid());
+  auto fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd >= 0)
+    shm_unlink(name.c_str());
+#endif
+  if (fd < 0)
+    return errnoError("memfd");
+  if (ftruncate(fd, (off_t)size) != 0) {
+    close(fd);
+    return errnoError("ftruncate");
+  }
+
+  auto write =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  auto target =
+      mmap(nullptr, size,
+           kind == Kind::Code ? PROT_READ | PROT_EXEC : PROT_READ,
+           MAP_SHARED, fd, 0);
+  close(fd);
+  if (write == MAP_FAILED || target == MAP_FAILED) {
+    auto err = errnoError("mmap");
+    if (write != MAP_FAILED)
+      munmap(write, size);
+    if (target != MAP_FAILED)
+      munmap(target, size);
+    return err;
+  }
+
+  slab.write = (uint8_t *)write;
+  slab.target = (uint8_t *)target;
+  slabs.push_back(std::move(slab));
+  return Error::success();
+}
+
+void SlabPool::Slab::AddFree(size_t offset, size_t size) {
+  free.emplace(offset, size);
+  bySize.emplace(size, offset);
+}
+
+void SlabPool::Slab::RemoveFree(size_t offset, size_t size) {
+  free.erase(offset);
+  auto [first, last] = bySize.equal_range(size);
+  for (auto it = first; it != last; ++it)
+    if (it->second == offset) {
+      bySize.erase(it);
+      return;
+    }
+}
+
+std::optional<SlabPool::Block> SlabPool::Carve(Slab &slab, size_t size,
+                                               unsigned alignment) {
+  // Best fit: the smallest range that still fits once aligned.
+  for (auto it = slab.bySize.lower_bound(size); it != slab.bySize.end();
+       ++it) {
+    auto [length, offset] = *it;
+    auto start = alignTo(offset, alignment);
+    if (start + size > offset + length)
+      continue;
+
+    slab.RemoveFree(offset, length);
+    if (start > offset)
+      slab.AddFree(offset, start - offset);
+    if (start + size < offset + length)
+      slab.AddFree(start + size, offset + length - start - size);
+    return Block{slab.kind, slab.write + start, slab.target + start, size};
+  }
+  return std::nullopt;
+}
+
+Expected<SlabPool::Block> SlabPool::Allocate(Kind kind, size_t size,
+                                             unsigned alignment) {
+  size = std::max<size_t>(size, 1);
+  alignment = std::max(alignment, 1u);
+
+  std::lock_guard lock(mutex);
+  for (auto &slab : slabs)
+    if (slab.kind == kind)
+      if (auto block = Carve(slab, size, alignment))
+        return *block;
+
+  // Sections larger than a slab get a slab of their own.
+  if (auto err = Map(kind, std::max(slabBytes,
+                                    alignTo(size + alignment, pageSize))))
+    return err;
+  return *Carve(slabs.back(), size, alignment);
+}
+
+void SlabPool::Release(const Block &block) {
+  std::lock_guard lock(mutex);
+  for (auto &slab : slabs) {
+    if (block.write < slab.write || block.write >= slab.write + slab.size)
+      continue;
+
+    auto offset = (size_t)(block.write - slab.write);
+    auto size = block.size;
+
+    auto next = slab.free.lower_bound(offset);
+    if (next != slab.free.end() && offset + size == next->first) {
+      size += next->second;
+      slab.RemoveFree(next->first, next->second);
+    }
+    next = slab.free.lower_bound(offset);
+    if (next != slab.free.begin()) {
+      auto [previous, length] = *std::prev(next);
+      if (previous + length == offset) {
+        slab.RemoveFree(previous, length);
+        offset = previous;
+        size += length;
+      }
+    }
+    slab.AddFree(offset, size);
+    return;
+  }
+}
+
+std::unique_ptr<RTDyldMemoryManager> SlabPool::CreateMemoryManager() {
+  return std::make_unique<SlabMemoryManager>(*this);
+}
+
+void SlabPool::RecordFinalize(double ms) {
+  std::lock_guard lock(mutex);
+  finalizations++;
+  finalizeMs += ms;
+}
+
+SlabStats SlabPool::Stats() const {
+  std::lock_guard lock(mutex);
+  SlabStats stats{slabs.size(), 0, 0, finalizations, finalizeMs};
+
+  for (auto &slab : slabs) {
+    size_t freeBytes = 0, freePages = 0;
+    for (auto [offset, length] : slab.free) {
+      freeBytes += length;
+      auto first = alignTo(offset, pageSize);
+      auto last = alignDown(offset + length, pageSize);
+      if (last > first)
+        freePages += (last - first) / pageSize;
+    }
+    stats.Pages += slab.size / pageSize - freePages;
+    stats.Bytes += slab.size - freeBytes;
+  }
+  return stats;
+}
+
+} // namespace aatbe::jit
@@ -0,0 +1,62 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <jit/perf.hpp>
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/Process.h>
+
+namespace aatbe::jit {
+
+static uint64_t AddressOf(const llvm::jitlink::Symbol &symbol) {
+#if LLVM_VERSION_MAJOR >= 14
+  return symbol.getAddress().getValue();
+#else
+  return symbol.getAddress();
+#endif
+}
+
+PerfMapPlugin::PerfMapPlugin(const std::string &path) {
+  std::error_code EC;
+  out = std::make_unique<llvm::raw_fd_ostream>(path, EC,
+                                               llvm::sys::fs::OF_Append);
+  if (EC)
+    out.reset();
+}
+
+std::string PerfMapPlugin::DefaultPath() {
+  return "/tmp/perf-" + std::to_string(llvm::sys::Process::getProcessId()) +
+         ".map";
+}
+
+void PerfMapPlugin::modifyPassConfig(
+    llvm::orc::MaterializationResponsibility &MR, llvm::jitlink::LinkGraph &G,
+    llvm::jitlink::PassConfiguration &Config) {
+  // Addresses are final once the graph has been allocated and fixed up.
+  Config.PostFixupPasses.push_back(
+      [this](llvm::jitlink::LinkGraph &G) { return Record(G); });
+}
+
+llvm::Error PerfMapPlugin::Record(llvm::jitlink::LinkGraph &G) {
+  if (!out)
+    return llvm::Error::success();
+
+  std::lock_guard lock(mutex);
+  for (auto *symbol : G.defined_symbols()) {
+    if (!symbol->isCallable() || !symbol->hasName() || !symbol->getSize())
+      continue;
+
+    *out << llvm::format("%llx %llx ", (unsigned long long)AddressOf(*symbol),
+                         (unsigned long long)symbol->getSize())
+         << symbol->getName() << '\n';
+    entries++;
+  }
+  out->flush();
+
+  return llvm::Error::success();
+}
+
+} // namespace aatbe::jit
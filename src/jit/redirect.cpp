@@ -0,0 +1,92 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <jit/redirect.hpp>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Host.h>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace aatbe::jit {
+
+Redirects::Redirects(AatbeJit &jit)
+    : jit(jit), mangle(jit.getExecutionSession(), jit.getDataLayout()),
+      stubs(createLocalIndirectStubsManagerBuilder(
+          Triple(sys::getProcessTriple()))()) {}
+
+Redirects::Body Redirects::Emit(codegen::CompilationSession &session,
+                                uint32_t index, codegen::OptLevel level) {
+  auto name = session.Symbols().Functions()[index]->Name();
+  auto symbol = name + "$" + std::to_string(generation++);
+
+  auto module = session.CodegenRange(symbol, index, index + 1, level);
+  module.withModuleDo([&](Module &M) {
+    auto *F = M.getFunction(name);
+    F->setName(symbol);
+    auto *Decl = Function::Create(F->getFunctionType(),
+                                  GlobalValue::ExternalLinkage, name, M);
+    F->replaceAllUsesWith(Decl);
+  });
+  return {name, symbol, std::move(module)};
+}
+
+Expected<std::vector<ResourceTrackerSP>>
+Redirects::Install(std::vector<Body> bodies) {
+  if (bodies.empty())
+    return std::vector<ResourceTrackerSP>{};
+  auto &JD = jit.getMainJITDylib();
+
+  // Bodies may call each other, so every stub has to exist before the
+  // first body is linked. New stubs start out null. They are defined by
+  // the dylib's default tracker, so they outlive the bodies.
+  IndirectStubsManager::StubInitsMap inits;
+  for (auto &body : bodies)
+    if (!stubs->findStub(body.Name, false))
+      inits[body.Name] = {0, JITSymbolFlags::Exported |
+                                 JITSymbolFlags::Callable};
+  if (!inits.empty()) {
+    if (auto err = stubs->createStubs(inits))
+      return err;
+    SymbolMap symbols;
+    for (auto &init : inits)
+      symbols[mangle(init.first())] = stubs->findStub(init.first(), false);
+    if (auto err = JD.define(absoluteSymbols(std::move(symbols))))
+      return err;
+  }
+
+  std::vector<ResourceTrackerSP> trackers;
+  auto discard = [&](Error err) -> Error {
+    for (auto &RT : trackers)
+      err = joinErrors(std::move(err), RT->remove());
+    return err;
+  };
+
+  std::vector<std::string> names;
+  for (auto &body : bodies) {
+    trackers.push_back(JD.createResourceTracker());
+    if (auto err = jit.addModule(std::move(body.Module), trackers.back()))
+      return discard(std::move(err));
+    names.push_back(body.Symbol);
+  }
+  auto symbols = jit.lookup(names);
+  if (!symbols)
+    return discard(symbols.takeError());
+
+  std::vector<ResourceTrackerSP> replaced;
+  for (size_t i = 0; i < bodies.size(); i++) {
+    auto address = (*symbols)[mangle(bodies[i].Symbol)].getAddress();
+    if (auto err = stubs->updatePointer(bodies[i].Name, address))
+      return err;
+
+    auto &RT = current[bodies[i].Name];
+    if (RT)
+      replaced.push_back(RT);
+    RT = trackers[i];
+  }
+  return replaced;
+}
+
+} // namespace aatbe::jit
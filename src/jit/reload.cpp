@@ -0,0 +1,134 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <jit/reload.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace aatbe::jit {
+
+// Key of an item in HotReloader::hashes; functions and structs may share
+// names.
+static std::string Key(parser::ModuleStatementNode *statement) {
+  if (statement->Kind() == parser::ModuleStatementKind::Struct)
+    return "struct " + statement->AsStruct()->Name();
+  return "fn " + statement->AsFunction()->Name();
+}
+
+Expected<std::vector<std::string>>
+HotReloader::Update(const std::string &source) {
+  std::lock_guard lock(updating);
+
+  codegen::CompilationSession session(name);
+  session.SetPrelude(prelude);
+  if (!session.AnalyzeSource(source)) {
+    std::string message;
+    for (auto &diagnostic : session.Diagnostics())
+      message += (message.empty() ? "" : "\n") + diagnostic;
+    return createStringError(inconvertibleErrorCode(), message);
+  }
+
+  std::unordered_map<std::string, size_t> nextHashes;
+  std::unordered_map<std::string, std::string> nextSignatures;
+  auto statements = session.Node()->Value();
+  auto itemHashes = session.Node()->Hashes();
+  auto everything = hashes.empty();
+  for (size_t i = 0; i < statements.size(); i++) {
+    auto key = Key(statements[i]);
+    nextHashes[key] = itemHashes[i];
+
+    if (statements[i]->Kind() == parser::ModuleStatementKind::Struct) {
+      auto old = hashes.find(key);
+      everything |= old == hashes.end() || old->second != itemHashes[i];
+      continue;
+    }
+    auto signature = statements[i]->AsFunction()->Signature();
+    auto old = signatures.find(key);
+    everything |= old != signatures.end() && old->second != signature;
+    nextSignatures[key] = std::move(signature);
+  }
+  // A removed struct may have been replaced by one with another name.
+  for (auto &[key, hash] : hashes)
+    everything |= key.starts_with("struct ") && !nextHashes.count(key);
+
+  std::vector<std::string> changed;
+  std::vector<Redirects::Body> bodies;
+  auto &functions = session.Symbols().Functions();
+  for (uint32_t index = 0; index < functions.size(); index++) {
+    if (!functions[index]->Body().has_value())
+      continue;
+
+    auto key = "fn " + functions[index]->Name();
+    auto old = hashes.find(key);
+    if (!everything && old != hashes.end() && old->second == nextHashes[key])
+      continue;
+
+    changed.push_back(functions[index]->Name());
+    bodies.push_back(redirects.Emit(session, index));
+  }
+
+  auto replaced = redirects.Install(std::move(bodies));
+  if (!replaced)
+    return replaced.takeError();
+  retired.insert(retired.end(), replaced->begin(), replaced->end());
+
+  hashes = std::move(nextHashes);
+  signatures = std::move(nextSignatures);
+  return changed;
+}
+
+static sys::TimePoint<> Modified(const std::string &file) {
+  sys::fs::file_status status;
+  if (sys::fs::status(file, status))
+    return {};
+  return status.getLastModificationTime();
+}
+
+void HotReloader::Watch(
+    std::string file, std::chrono::milliseconds interval,
+    std::function<void(Expected<std::vector<std::string>>)> report) {
+  Stop();
+  // Changes made once Watch returns are seen.
+  auto last = Modified(file);
+  watcher = std::thread([this, file = std::move(file), interval,
+                         report = std::move(report), last]() mutable {
+    while (true) {
+      {
+        std::unique_lock lock(stopping);
+        if (stopped.wait_for(lock, interval, [this] { return stop; }))
+          return;
+      }
+
+      auto modified = Modified(file);
+      if (modified == last)
+        continue;
+      last = modified;
+
+      auto buffer = MemoryBuffer::getFile(file);
+      if (!buffer) {
+        report(errorCodeToError(buffer.getError()));
+        continue;
+      }
+      report(Update((*buffer)->getBuffer().str()));
+    }
+  });
+}
+
+void HotReloader::Stop() {
+  if (!watcher.joinable())
+    return;
+  {
+    std::lock_guard lock(stopping);
+    stop = true;
+  }
+  stopped.notify_all();
+  watcher.join();
+  stop = false;
+}
+
+} // namespace aatbe::jit
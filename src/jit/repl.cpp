@@ -0,0 +1,221 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <jit/repl.hpp>
+
+#include <cinttypes>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace aatbe::jit {
+
+Repl::Repl(std::unique_ptr<AatbeJit> jit)
+    : jit(std::move(jit)), redirects(*this->jit) {}
+
+Expected<std::unique_ptr<Repl>> Repl::Create(const JitOptions &options) {
+  auto jit = AatbeJit::Create(options);
+  if (!jit)
+    return jit.takeError();
+  auto repl = std::make_unique<Repl>(std::move(*jit));
+
+  // The prelude's functions are declared as if they had been typed in.
+  if (!options.PreludePath.empty()) {
+    auto prelude = codegen::Prelude::Load(options.PreludePath);
+    if (!prelude)
+      return prelude.takeError();
+    if (!repl->session.AnalyzeIncrement((*prelude)->Interface()))
+      return repl->Diagnostics();
+  }
+  return repl;
+}
+
+static bool StartsDefinition(const std::string &input) {
+  auto start = input.find_first_not_of(" \t\r\n");
+  if (start == std::string::npos)
+    return false;
+  if (input[start] == '@')
+    return true;
+
+  auto end = input.find_first_of(" \t\r\n(", start);
+  auto word = input.substr(start, end - start);
+  return word == "fn" || word == "extern" || word == "struct";
+}
+
+bool Repl::IsIncomplete(const std::string &input) {
+  int depth = 0;
+  char quote = 0;
+  for (size_t i = 0; i < input.size(); i++) {
+    auto c = input[i];
+    if (quote) {
+      if (c == '\\')
+        i++;
+      else if (c == quote)
+        quote = 0;
+      continue;
+    }
+
+    if (c == '"' || c == '\'')
+      quote = c;
+    else if (c == '(' || c == '[' || c == '{')
+      depth++;
+    else if (c == ')' || c == ']' || c == '}')
+      depth--;
+  }
+  if (depth > 0)
+    return true;
+
+  auto end = input.find_last_not_of(" \t\r\n");
+  if (end == std::string::npos)
+    return false;
+  auto last = input.substr(0, end + 1);
+  return last.ends_with("=") || last.ends_with("->") || last.ends_with(",");
+}
+
+Expected<std::string> Repl::Eval(const std::string &input) {
+  if (input.find_first_not_of(" \t\r\n") == std::string::npos)
+    return "";
+  return StartsDefinition(input) ? Define(input) : Evaluate(input);
+}
+
+Error Repl::Diagnostics() {
+  std::string message;
+  auto &all = session.Diagnostics();
+  for (; diagnostics < all.size(); diagnostics++)
+    message += (message.empty() ? "" : "\n") + all[diagnostics];
+  return createStringError(inconvertibleErrorCode(), message);
+}
+
+Expected<std::string> Repl::Define(const std::string &input) {
+  auto count = session.Symbols().Functions().size();
+  if (!session.AnalyzeIncrement(input))
+    return Diagnostics();
+
+  auto &functions = session.Symbols().Functions();
+  std::vector<Redirects::Body> bodies;
+  for (auto index = (uint32_t)count; index < functions.size(); index++)
+    if (functions[index]->Body().has_value())
+      bodies.push_back(redirects.Emit(session, index));
+
+  // Nothing runs between inputs, the replaced bodies can go right away.
+  auto replaced = redirects.Install(std::move(bodies));
+  if (!replaced) {
+    // The stubs still call the bodies these would have replaced.
+    session.Truncate(count);
+    return replaced.takeError();
+  }
+  for (auto &RT : *replaced)
+    if (auto err = RT->remove())
+      return err;
+  return "";
+}
+
+// Calls an expression function returning `type` and formats the result.
+static std::optional<std::string> Call(JITTargetAddress address,
+                                       typesys::TypeId const &type) {
+  auto *resolved = type.System()->GetType(type);
+  char buffer[64];
+
+  switch (resolved->Kind()) {
+  case typesys::TypeKind::TyUnit:
+    ((void (*)())address)();
+    return "";
+  case typesys::TypeKind::TyBool:
+    return ((bool (*)())address)() ? "true" : "false";
+  case typesys::TypeKind::TyChar:
+    return std::string("'") + ((char (*)())address)() + "'";
+  case typesys::TypeKind::TyInt: {
+    auto integer = resolved->As<typesys::IntType>();
+    if (integer->Signed()) {
+      int64_t value;
+      switch (integer->Size()) {
+      case typesys::IntType::IntSize::Int8:
+        value = ((int8_t(*)())address)();
+        break;
+      case typesys::IntType::IntSize::Int16:
+        value = ((int16_t(*)())address)();
+        break;
+      case typesys::IntType::IntSize::Int32:
+        value = ((int32_t(*)())address)();
+        break;
+      default:
+        value = ((int64_t(*)())address)();
+        break;
+      }
+      return std::to_string(value);
+    }
+
+    uint64_t value;
+    switch (integer->Size()) {
+    case typesys::IntType::IntSize::Int8:
+      value = ((uint8_t(*)())address)();
+      break;
+    case typesys::IntType::IntSize::Int16:
+      value = ((uint16_t(*)())address)();
+      break;
+    case typesys::IntType::IntSize::Int32:
+      value = ((uint32_t(*)())address)();
+      break;
+    default:
+      value = ((uint64_t(*)())address)();
+      break;
+    }
+    return std::to_string(value);
+  }
+  case typesys::TypeKind::TyFloat: {
+    auto real = resolved->As<typesys::FloatType>();
+    auto value = real->Size() == typesys::FloatType::FloatSize::Float32
+                     ? (double)((float (*)())address)()
+                     : ((double (*)())address)();
+    snprintf(buffer, sizeof(buffer), "%g", value);
+    return std::string(buffer);
+  }
+  case typesys::TypeKind::TyPointer: {
+    auto pointee = resolved->As<typesys::PointerType>()->Type();
+    auto isString =
+        type.System()->GetType(pointee)->Kind() == typesys::TypeKind::TyChar;
+    auto value = ((const char *(*)())address)();
+    if (isString && value)
+      return "\"" + std::string(value) + "\"";
+    snprintf(buffer, sizeof(buffer), "0x%" PRIxPTR, (uintptr_t)value);
+    return std::string(buffer);
+  }
+  default:
+    return std::nullopt;
+  }
+}
+
+Expected<std::string> Repl::Evaluate(const std::string &input) {
+  auto name = "__expr" + std::to_string(expressions++);
+  auto count = (uint32_t)session.Symbols().Functions().size();
+  if (!session.AnalyzeExpression(name, input))
+    return Diagnostics();
+
+  auto type = session.Symbols()
+                  .Functions()[count]
+                  ->Id()
+                  .Resolve<typesys::FunctionType>()
+                  ->Return();
+  auto module = session.CodegenRange(name, count, count + 1);
+  session.Truncate(count);
+
+  auto RT = jit->getMainJITDylib().createResourceTracker();
+  if (auto err = jit->addModule(std::move(module), RT))
+    return err;
+  auto symbol = jit->lookup(StringRef(name));
+  if (!symbol) {
+    consumeError(RT->remove());
+    return symbol.takeError();
+  }
+
+  auto result = Call(symbol->getAddress(), type);
+  if (auto err = RT->remove())
+    return err;
+  if (!result)
+    return createStringError(inconvertibleErrorCode(),
+                             "repl: cannot show a value of this type");
+  return *result;
+}
+
+} // namespace aatbe::jit
@@ -0,0 +1,235 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <jit/compile.hpp>
+#include <jit/tiered.hpp>
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+
+#include <chrono>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace aatbe::jit {
+
+// Baseline code calls this symbol to queue a function for tier 1.
+static const char *TierUpSymbol = "__aatbe_tier_up";
+
+static JITTargetMachineBuilder baselineMachine(JITTargetMachineBuilder JTMB) {
+  // CodeGenOpt::None selects FastISel.
+  JTMB.setCodeGenOptLevel(CodeGenOpt::None);
+  return JTMB;
+}
+
+TieredCompiler::TieredCompiler(ExecutionSession &ES, JITDylib &JD,
+                               ObjectLayer &ObjLayer,
+                               IRLayer &CompileLayer,
+                               MangleAndInterner &Mangle,
+                               JITTargetMachineBuilder JTMB,
+                               codegen::OptLevel TopLevel, uint64_t Threshold)
+    : ES(ES), JD(JD), Mangle(Mangle), JTMB(JTMB), TopLevel(TopLevel),
+      Threshold(std::max<uint64_t>(Threshold, 1)),
+      BaselineLayer(ES, ObjLayer,
+                    std::make_unique<TimedIRCompiler>(
+                        baselineMachine(JTMB))),
+      CompileLayer(CompileLayer),
+      Stubs(createLocalIndirectStubsManagerBuilder(JTMB.getTargetTriple())()),
+      Worker([this] { run(); }) {
+  cantFail(JD.define(absoluteSymbols(
+      {{Mangle(TierUpSymbol),
+        JITEvaluatedSymbol(pointerToJITTargetAddress(&tierUp),
+                           JITSymbolFlags::Exported |
+                               JITSymbolFlags::Callable)}})));
+}
+
+TieredCompiler::~TieredCompiler() {
+  {
+    std::lock_guard Lock(QueueMutex);
+    Stopping = true;
+  }
+  QueueChanged.notify_all();
+  Worker.join();
+}
+
+void TieredCompiler::tierUp(FunctionRecord *Record) {
+  auto &Self = *Record->Owner;
+  {
+    std::lock_guard Lock(Self.QueueMutex);
+    Self.Queue.push_back(Record);
+  }
+  Self.QueueChanged.notify_all();
+}
+
+void TieredCompiler::instrument(Function &F, FunctionRecord &Record,
+                                FunctionCallee TierUp) {
+  auto &Ctx = F.getContext();
+  auto *Entry = &F.getEntryBlock();
+  auto *Body = Entry->splitBasicBlock(Entry->begin(), "body");
+  auto *Hot = BasicBlock::Create(Ctx, "tier_up", &F, Body);
+  Entry->getTerminator()->eraseFromParent();
+
+  IRBuilder<> B(Entry);
+  B.SetCurrentDebugLocation(Body->front().getDebugLoc());
+  auto *Counter = ConstantExpr::getIntToPtr(
+      B.getInt64(pointerToJITTargetAddress(&Record.Calls)),
+      B.getInt64Ty()->getPointerTo());
+  auto *Previous =
+      B.CreateAtomicRMW(AtomicRMWInst::Add, Counter, B.getInt64(1),
+                        MaybeAlign(8), AtomicOrdering::Monotonic);
+  B.CreateCondBr(B.CreateICmpEQ(Previous, B.getInt64(Threshold - 1)), Hot,
+                 Body);
+
+  B.SetInsertPoint(Hot);
+  B.CreateCall(TierUp,
+               {ConstantExpr::getIntToPtr(
+                   B.getInt64(pointerToJITTargetAddress(&Record)),
+                   B.getInt8PtrTy())});
+  B.CreateBr(Body);
+}
+
+Error TieredCompiler::addModule(ThreadSafeModule TSM, ResourceTrackerSP RT) {
+  auto Source = std::make_shared<ThreadSafeModule>(cloneToNewContext(TSM));
+
+  // Every defined function `f` becomes `f$tier0`, and all references to it,
+  // recursive calls included, go through the declaration `f`, which
+  // resolves to the stub.
+  std::vector<FunctionRecord *> Added;
+  TSM.withModuleDo([&](Module &M) {
+    auto TierUp = M.getOrInsertFunction(
+        TierUpSymbol, Type::getVoidTy(M.getContext()),
+        Type::getInt8PtrTy(M.getContext()));
+
+    std::vector<Function *> Defined;
+    for (auto &F : M)
+      if (!F.isDeclaration())
+        Defined.push_back(&F);
+
+    for (auto *F : Defined) {
+      auto Name = F->getName().str();
+      {
+        std::lock_guard Lock(RecordsMutex);
+        Records.emplace_back();
+        Added.push_back(&Records.back());
+      }
+      auto &Record = *Added.back();
+      Record.Owner = this;
+      Record.Name = Name;
+      Record.Source = Source;
+
+      F->setName(Name + "$tier0");
+      auto *Decl = Function::Create(F->getFunctionType(),
+                                    GlobalValue::ExternalLinkage, Name, M);
+      F->replaceAllUsesWith(Decl);
+      instrument(*F, Record, TierUp);
+    }
+  });
+
+  // Stubs start out null, they are pointed at the baseline code before
+  // addModule returns.
+  IndirectStubsManager::StubInitsMap Inits;
+  for (auto *Record : Added)
+    Inits[Record->Name] = {0, JITSymbolFlags::Exported |
+                                  JITSymbolFlags::Callable};
+  if (auto Err = Stubs->createStubs(Inits))
+    return Err;
+
+  SymbolMap StubSymbols;
+  SymbolLookupSet Baseline;
+  for (auto *Record : Added) {
+    StubSymbols[Mangle(Record->Name)] = Stubs->findStub(Record->Name, false);
+    Baseline.add(Mangle(Record->Name + "$tier0"));
+  }
+  if (auto Err = JD.define(absoluteSymbols(std::move(StubSymbols)), RT))
+    return Err;
+  if (auto Err = BaselineLayer.add(RT, std::move(TSM)))
+    return Err;
+
+  auto Addresses = ES.lookup(makeJITDylibSearchOrder(&JD), Baseline);
+  if (!Addresses)
+    return Addresses.takeError();
+
+  for (auto *Record : Added)
+    if (auto Err = Stubs->updatePointer(
+            Record->Name,
+            (*Addresses)[Mangle(Record->Name + "$tier0")].getAddress()))
+      return Err;
+
+  return Error::success();
+}
+
+Error TieredCompiler::recompile(FunctionRecord &Record) {
+  accounting::PhaseScope phase(accounting::Phase::Jit);
+  auto Start = std::chrono::steady_clock::now();
+
+  // Only the function itself and the module's globals are defined, other
+  // functions are called through their stubs.
+  auto TSM = cloneToNewContext(*Record.Source, [&](const GlobalValue &GV) {
+    return GV.getName() == Record.Name || isa<GlobalVariable>(GV);
+  });
+
+  auto TM = JTMB.createTargetMachine();
+  if (!TM)
+    return TM.takeError();
+
+  TSM.withModuleDo([&](Module &M) {
+    M.getFunction(Record.Name)->setName(Record.Name + "$tier1");
+    codegen::OptimizeModule(M, TopLevel, TM->get());
+  });
+
+  if (auto Err = CompileLayer.add(JD, std::move(TSM)))
+    return Err;
+
+  auto Symbol = ES.lookup({&JD}, Mangle(Record.Name + "$tier1"));
+  if (!Symbol)
+    return Symbol.takeError();
+  if (auto Err = Stubs->updatePointer(Record.Name, Symbol->getAddress()))
+    return Err;
+
+  Record.Tier = 1;
+  Record.RecompileMs =
+      std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - Start)
+          .count();
+  Recompiles++;
+  return Error::success();
+}
+
+void TieredCompiler::run() {
+  std::unique_lock Lock(QueueMutex);
+  while (true) {
+    QueueChanged.wait(Lock, [&] { return Stopping || !Queue.empty(); });
+    if (Stopping)
+      return;
+
+    auto *Record = Queue.front();
+    Queue.pop_front();
+    Busy = true;
+    Lock.unlock();
+
+    if (auto Err = recompile(*Record))
+      ES.reportError(std::move(Err));
+
+    Lock.lock();
+    Busy = false;
+    QueueChanged.notify_all();
+  }
+}
+
+void TieredCompiler::waitForIdle() {
+  std::unique_lock Lock(QueueMutex);
+  QueueChanged.wait(Lock, [&] { return Queue.empty() && !Busy; });
+}
+
+std::vector<FunctionTierStats> TieredCompiler::stats() const {
+  std::lock_guard Lock(RecordsMutex);
+  std::vector<FunctionTierStats> Result;
+  for (auto &Record : Records)
+    Result.push_back({Record.Name, Record.Tier, Record.Calls,
+                      Record.RecompileMs});
+  return Result;
+}
+
+} // namespace aatbe::jit
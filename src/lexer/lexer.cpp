@@ -3,10 +3,12 @@
 //
 
 #include <lexer/lexer.hpp>
+#include <timing.hpp>
 
 #include <algorithm>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -58,10 +60,14 @@ std::vector<std::string> keywords = {
 
 Lexer::Lexer(std::shared_ptr<SrcFile> file)
     : file(std::move(file)), index(0), last_index(0) {
-  std::sort(symbols.begin(), symbols.end());
-  std::reverse(symbols.begin(), symbols.end());
-  std::sort(keywords.begin(), keywords.end());
-  std::reverse(keywords.begin(), keywords.end());
+  // Sorted once, lexers may run on several threads at a time.
+  static std::once_flag sorted;
+  std::call_once(sorted, [] {
+    std::sort(symbols.begin(), symbols.end());
+    std::reverse(symbols.begin(), symbols.end());
+    std::sort(keywords.begin(), keywords.end());
+    std::reverse(keywords.begin(), keywords.end());
+  });
 }
 
 char Lexer::peek(off_t off) { return file->Char(this->index + off); }
@@ -77,8 +83,8 @@ Token *Lexer::makeToken(TokenKind kind, const char *valueS) {
 }
 
 Token *Lexer::makeToken(TokenKind kind, std::string *valueS, uint64_t valueI) {
-  auto tok = new Token(kind, valueS, valueI, this->file, this->last_index,
-                       this->index);
+  auto tok = arena.Make<Token>(kind, valueS, valueI, this->file,
+                              this->last_index, this->index);
   this->last_index = this->index;
 
   return tok;
@@ -120,7 +126,10 @@ Token *Lexer::Next() {
     return false;
   };
 
-  auto read_escape = [=]() -> char {
+  // Malformed literals are reported and lexed as Unexpected, the parser
+  // fails on them.
+  auto malformed = false;
+  auto read_escape = [&]() -> char {
     if (this->peek() == '\\') {
       this->read();
 
@@ -136,8 +145,9 @@ Token *Lexer::Next() {
       case '"':
         return '"';
       case '\'':
-        fprintf(stderr, "Unexpected char delimiter at %zu", this->index);
-        exit(1);
+        fprintf(stderr, "Unexpected char delimiter at %zu\n", this->index);
+        malformed = true;
+        return '\'';
       }
     }
 
@@ -188,9 +198,11 @@ Token *Lexer::Next() {
     valueS += c;
 
     if (this->read() != '\'') {
-      fprintf(stderr, "Unclosed char delimiter at %zu", this->index);
-      exit(1);
+      fprintf(stderr, "Unclosed char delimiter at %zu\n", this->index);
+      malformed = true;
     }
+    if (malformed)
+      return Lexer::makeToken(TokenKind::Unexpected, new std::string(valueS));
 
     this->read();
 
@@ -202,9 +214,11 @@ Token *Lexer::Next() {
       valueS += read_escape();
 
     if (this->read() != '\"') {
-      fprintf(stderr, "Unclosed string delimiter at %zu", this->index);
-      exit(1);
+      fprintf(stderr, "Unclosed string delimiter at %zu\n", this->index);
+      malformed = true;
     }
+    if (malformed)
+      return Lexer::makeToken(TokenKind::Unexpected, new std::string(valueS));
 
     return Lexer::makeToken(TokenKind::String, new std::string(valueS));
   }
@@ -233,6 +247,8 @@ Token *Lexer::Next() {
 }
 
 std::vector<Token *> Lexer::Lex() {
+  timing::Scope scope("Lex");
+  accounting::PhaseScope phase(accounting::Phase::Lexer);
   std::vector<Token *> tokens;
 
   while (true) {
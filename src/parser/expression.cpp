@@ -23,7 +23,7 @@ ParseResult<UnaryExpression *> ParseUnary(Parser &parser) {
     return ParserError(ParseErrorKind::ExpectedSymbol, "");
 
   auto op = token->get()->ValueS();
-  ErrorOrContinue(expr, ParseExpression(parser));
+  ErrorOrContinue(expr, ParsePrimary(parser));
 
   if (op == "!")
     return expr.WrapWith<UnaryExpression>(
@@ -61,7 +61,13 @@ ParseResult<TupleExpression *> ParseTuple(Parser &parser) {
 
   return parser.SurroundedBy(
       Deffer(new TupleExpression(parser.DelimitedBy(
-          Deffer(ParseExpression(parser).Node()), TokenKind::Symbol, ","))),
+          [](Parser &parser) {
+            if (auto expression = ParseExpression(parser))
+              return expression.Node();
+            else
+              return (ExpressionNode *)nullptr;
+          },
+          TokenKind::Symbol, ","))),
       TokenKind::Symbol, "(", TokenKind::Symbol, ")");
 }
 
@@ -118,7 +124,96 @@ ParseResult<LoopExpression *> ParseLoop(Parser &parser) {
   return ParserSuccess(new LoopExpression(body.Node()));
 }
 
+ParseResult<LetExpression *> ParseLet(Parser &parser) {
+  auto isMutable = parser.Read(TokenKind::Keyword, "var").has_value();
+  if (!isMutable && !parser.Read(TokenKind::Keyword, "val"))
+    return ParserError(ParseErrorKind::ExpectedToken, "");
+
+  ErrorOrContinue(name, ParseIdentifier(parser));
+
+  TypeNode *type = nullptr;
+  if (parser.Read(TokenKind::Symbol, ":")) {
+    ErrorOrContinue(declared, ParseType(parser));
+    type = declared.Node();
+  }
+
+  if (!parser.Read(TokenKind::Symbol, "="))
+    return ParserError(ParseErrorKind::ExpectedToken, "");
+
+  ErrorOrContinue(value, ParseExpression(parser));
+
+  return ParserSuccess(
+      new LetExpression(name.Value(), type, value.Node(), isMutable));
+}
+
+struct BinaryOperator {
+  const char *symbol;
+  int precedence;
+  BinaryExpression::BinaryKind kind;
+};
+
+static const BinaryOperator binaryOperators[] = {
+    {"||", 1, BinaryExpression::LogicalOr},
+    {"&&", 2, BinaryExpression::LogicalAnd},
+    {"|", 3, BinaryExpression::BitwiseOr},
+    {"^", 4, BinaryExpression::BitwiseXor},
+    {"&", 5, BinaryExpression::BitwiseAnd},
+    {"==", 6, BinaryExpression::Equal},
+    {"!=", 6, BinaryExpression::NotEqual},
+    {"<", 7, BinaryExpression::LessThan},
+    {"<=", 7, BinaryExpression::LessThanOrEqual},
+    {">", 7, BinaryExpression::GreaterThan},
+    {">=", 7, BinaryExpression::GreaterThanOrEqual},
+    {"<<", 8, BinaryExpression::BitwiseLeftShift},
+    {">>", 8, BinaryExpression::BitwiseRightShift},
+    {"+", 9, BinaryExpression::Addition},
+    {"-", 9, BinaryExpression::Subtraction},
+    {"*", 10, BinaryExpression::Multiplication},
+    {"/", 10, BinaryExpression::Division},
+    {"%", 10, BinaryExpression::Modulo},
+};
+
+const BinaryOperator *PeekBinaryOperator(Parser &parser) {
+  for (auto &op : binaryOperators)
+    if (parser.Peek(TokenKind::Symbol, op.symbol))
+      return &op;
+
+  return nullptr;
+}
+
+// Precedence climbing over primary expressions, all operators are left
+// associative.
+ParseResult<ExpressionNode *> ParseBinary(Parser &parser, int minPrecedence) {
+  ErrorOrContinue(lhs, ParsePrimary(parser));
+  auto left = lhs.Node();
+
+  while (auto op = PeekBinaryOperator(parser)) {
+    if (op->precedence < minPrecedence)
+      break;
+
+    auto memo = parser.Snapshot();
+    parser.Read();
+
+    auto rhs = ParseBinary(parser, op->precedence + 1);
+    if (!rhs) {
+      parser.Restore(memo);
+      break;
+    }
+
+    left = new ExpressionNode(new BinaryExpression(
+        std::shared_ptr<ExpressionNode>(left),
+        std::shared_ptr<ExpressionNode>(rhs.Node()), op->kind));
+  }
+
+  return ParserSuccess(left);
+}
+
 ParseResult<ExpressionNode *> ParseExpression(Parser &parser) {
+  return ParseBinary(parser, 0);
+}
+
+ParseResult<ExpressionNode *> ParsePrimary(Parser &parser) {
+  TryReturn(parser.Try(ParseLet).WrapWith<ExpressionNode>());
   TryReturn(parser.Try(ParseUnary).WrapWith<ExpressionNode>());
   TryReturn(parser.Try(ParseUnitAtom).WrapWith<ExpressionNode>());
   TryReturn(parser.Try(ParseTuple).WrapWith<ExpressionNode>());
@@ -8,6 +8,7 @@
 namespace aatbe::parser {
 
 ParseResult<FunctionStatement *> ParseFunction(Parser &parser) {
+  auto offset = parser.Peek() ? (*parser.Peek()).get()->Start() : 0;
   auto isExtern = parser.ReadKeyword("extern").has_value();
 
   if (!parser.Read(TokenKind::Keyword, "fn"))
@@ -50,19 +51,52 @@ ParseResult<FunctionStatement *> ParseFunction(Parser &parser) {
       return ParserError(ParseErrorKind::ExpectedType, "");
   }
 
-  auto body = parser.Read(TokenKind::Symbol, "=")
-                  ? std::optional(ParseExpression(parser).Node())
-                  : std::nullopt;
+  std::optional<ExpressionNode *> body;
+  if (parser.Read(TokenKind::Symbol, "=")) {
+    ErrorOrContinue(expression, ParseExpression(parser));
+    body = expression.Node();
+  }
+
+  auto function = new FunctionStatement(isExtern, name.Node()->Value(),
+                                        args.Node(), returnType, body,
+                                        isVariadic);
+  function->SetOffset(offset);
+  return ParserSuccess(function);
+}
+
+std::vector<std::string> ParseAttributes(Parser &parser) {
+  std::vector<std::string> attributes;
+
+  while (parser.Peek(TokenKind::Symbol, "@")) {
+    auto memo = parser.Snapshot();
+    parser.Read();
+
+    if (auto name = ParseIdentifier(parser)) {
+      attributes.push_back(name.Value());
+    } else {
+      parser.Restore(memo);
+      break;
+    }
+  }
 
-  return ParserSuccess(new FunctionStatement(isExtern, name.Node()->Value(),
-                                             args.Node(), returnType, body,
-                                             isVariadic));
+  return attributes;
 }
 
 ParseResult<ModuleStatementNode *> ParseModuleStatement(Parser &parser) {
-  TryReturn(parser.Try(ParseFunction).WrapWith<ModuleStatementNode>());
-  TryReturn(parser.Try(ParseStruct).WrapWith<ModuleStatementNode>())
+  auto memo = parser.Snapshot();
+  auto attributes = ParseAttributes(parser);
+
+  auto withAttributes = [&](auto result) -> ParseResult<ModuleStatementNode *> {
+    result.Node()->SetAttributes(attributes);
+    return result.template WrapWith<ModuleStatementNode>();
+  };
+
+  if (auto function = parser.Try(ParseFunction))
+    return withAttributes(function);
+  if (auto structure = parser.Try(ParseStruct))
+    return withAttributes(structure);
 
+  parser.Restore(memo);
   return ParserError(ParseErrorKind::UnexpectedToken, "");
 }
 
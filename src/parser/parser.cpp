@@ -7,6 +7,8 @@
 #include <lexer/lexer.hpp>
 #include <parser/ast.hpp>
 #include <parser/parser.hpp>
+#include <accounting.hpp>
+#include <timing.hpp>
 
 using namespace aatbe::lexer;
 
@@ -44,13 +46,13 @@ ParseResult<IntegerTerm *> ParseNumber(Parser &parser) {
   if (auto token = parser.Peek()) {
     if (token->get()->Kind() == TokenKind::Number) {
       parser.Read();
-      if (auto type = ParseType(parser))
+      if (auto type = ParseNumericType(parser))
         return ParserSuccess(
             new IntegerTerm(token->get()->ValueI(), type.Node()));
       else
         return ParserSuccess(
             new IntegerTerm(token->get()->ValueI(),
-                            new TypeNode(new SIntType(TypeKind::Int64))));
+                            new TypeNode(new SIntType(TypeKind::Int64)), true));
     }
   }
   return ParserError(ParseErrorKind::UnexpectedToken, "");
@@ -86,6 +88,8 @@ ParseResult<TerminalNode *> ParseTerminal(Parser &parser) {
 }
 
 ParseResult<ModuleNode *> Parser::Parse() {
+  timing::Scope scope("Parse");
+  accounting::PhaseScope phase(accounting::Phase::Parser);
   auto statements = std::vector<ModuleStatementNode *>();
 
   while (this->Peek()) {
@@ -127,6 +127,14 @@ ParseResult<TypenameType *> ParseTypename(Parser &parser) {
   return ParserSuccess(new TypenameType(name.Value()));
 }
 
+ParseResult<TypeNode *> ParseNumericType(Parser &parser) {
+  TryReturn(parser.Try(ParseSInt).WrapWith<TypeNode>());
+  TryReturn(parser.Try(ParseUInt).WrapWith<TypeNode>());
+  TryReturn(parser.Try(ParseFloat).WrapWith<TypeNode>());
+
+  return ParserError(ParseErrorKind::ExpectedType, "");
+}
+
 ParseResult<TypeNode *> ParseType(Parser &parser) {
   TryReturn(parser.Try(ParseSInt).WrapWith<TypeNode>());
   TryReturn(parser.Try(ParseUInt).WrapWith<TypeNode>());
@@ -144,4 +152,20 @@ ParseResult<TypeNode *> ParseType(Parser &parser) {
   return ParserError(ParseErrorKind::ExpectedType, "");
 }
 
+std::string TypeNode::Source() const {
+  switch (Kind()) {
+  case TypeKind::Slice:
+    return "[" + AsSlice()->Inner()->Source() + "]";
+  case TypeKind::Array:
+    return "[" + AsArray()->Inner()->Source() + "; " +
+           std::to_string(AsArray()->Size()) + "]";
+  case TypeKind::Ref:
+    return "ref " + AsRef()->Inner()->Source();
+  case TypeKind::Pointer:
+    return "ptr " + AsPointer()->Inner()->Source();
+  default:
+    return value->Format();
+  }
+}
+
 } // namespace aatbe::parser
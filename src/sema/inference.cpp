@@ -0,0 +1,556 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <sema/inference.hpp>
+
+namespace aatbe::sema {
+
+TypeId TypeInference::LowerType(TypeNode *type) {
+  if (type->HasId() && type->Id().System() == &types)
+    return type->Id();
+
+  auto id = InternType(type);
+  type->SetId(id);
+  return id;
+}
+
+TypeId TypeInference::InternType(const TypeNode *type) {
+  switch (type->Kind()) {
+  case parser::TypeKind::Int8:
+    return types.Create<IntType>(IntType::IntSize::Int8);
+  case parser::TypeKind::Int16:
+    return types.Create<IntType>(IntType::IntSize::Int16);
+  case parser::TypeKind::Int32:
+    return types.Create<IntType>(IntType::IntSize::Int32);
+  case parser::TypeKind::Int64:
+    return types.Create<IntType>(IntType::IntSize::Int64);
+  case parser::TypeKind::UInt8:
+    return types.Create<IntType>(IntType::IntSize::Int8, false);
+  case parser::TypeKind::UInt16:
+    return types.Create<IntType>(IntType::IntSize::Int16, false);
+  case parser::TypeKind::UInt32:
+    return types.Create<IntType>(IntType::IntSize::Int32, false);
+  case parser::TypeKind::UInt64:
+    return types.Create<IntType>(IntType::IntSize::Int64, false);
+  case parser::TypeKind::Float32:
+    return types.Create<typesys::FloatType>(
+        typesys::FloatType::FloatSize::Float32);
+  case parser::TypeKind::Float64:
+    return types.Create<typesys::FloatType>(
+        typesys::FloatType::FloatSize::Float64);
+  case parser::TypeKind::Bool:
+    return types.Create<typesys::BoolType>();
+  case parser::TypeKind::Char:
+    return types.Create<typesys::CharType>();
+  case parser::TypeKind::Str:
+    return types.Create<typesys::PointerType>(
+        types.Create<typesys::CharType>());
+  case parser::TypeKind::Unit:
+    return types.Create<typesys::UnitType>();
+  case parser::TypeKind::Array: {
+    auto array = type->AsArray();
+    return types.Create<typesys::ArrayType>(LowerType(array->Inner()),
+                                            array->Size());
+  }
+  case parser::TypeKind::Ref:
+    return types.Create<typesys::PointerType>(
+        LowerType(type->AsRef()->Inner()));
+  case parser::TypeKind::Pointer:
+    return types.Create<typesys::PointerType>(
+        LowerType(type->AsPointer()->Inner()));
+  case parser::TypeKind::Typename: {
+    auto name = type->AsTypename()->Name();
+    if (auto it = structs.find(name); it != structs.end())
+      return it->second;
+    Error("unknown type " + name);
+    return types.Create<UnknownType>();
+  }
+  case parser::TypeKind::Slice:
+  default:
+    // Slices have no typesys counterpart yet.
+    return types.Create<UnknownType>();
+  }
+}
+
+void TypeInference::Error(std::string message) {
+  errors.push_back({currentFunction, std::move(message)});
+}
+
+std::string TypeInference::Describe(TypeId const &id) {
+  auto resolved = unifier.Resolve(id);
+  auto type = types.GetType(resolved);
+
+  switch (type->Kind()) {
+  case typesys::TypeKind::TyInt: {
+    auto integer = type->As<IntType>();
+    return std::string(integer->Signed() ? "int" : "uint") +
+           std::to_string(8 << (int)integer->Size());
+  }
+  case typesys::TypeKind::TyFloat:
+    return type->As<typesys::FloatType>()->Size() ==
+                   typesys::FloatType::FloatSize::Float32
+               ? "float32"
+               : "float64";
+  case typesys::TypeKind::TyBool:
+    return "bool";
+  case typesys::TypeKind::TyChar:
+    return "char";
+  case typesys::TypeKind::TyUnit:
+    return "()";
+  case typesys::TypeKind::TyStruct:
+    return type->As<typesys::StructType>()->Name();
+  case typesys::TypeKind::TyPointer:
+    return "ptr " + Describe(type->As<typesys::PointerType>()->Type());
+  case typesys::TypeKind::TyArray: {
+    auto array = type->As<typesys::ArrayType>();
+    return "[" + Describe(array->Type()) + "; " +
+           std::to_string(array->Size()) + "]";
+  }
+  case typesys::TypeKind::TyFunction:
+    return "fn";
+  case typesys::TypeKind::TyVar:
+    return "?" + std::to_string(resolved.Value());
+  default:
+    return "<unknown>";
+  }
+}
+
+void TypeInference::Expect(TypeId const &actual, TypeId const &expected,
+                           const std::string &what) {
+  if (!unifier.Unify(actual, expected))
+    Error(what + ": expected " + Describe(expected) + ", found " +
+          Describe(actual));
+}
+
+std::optional<TypeId> TypeInference::Lookup(const std::string &name) {
+  for (auto scope = scopes.rbegin(); scope != scopes.rend(); scope++)
+    if (auto it = scope->find(name); it != scope->end())
+      return it->second;
+
+  if (auto it = functions.find(name); it != functions.end())
+    return it->second;
+
+  return std::nullopt;
+}
+
+void TypeInference::DeclareStruct(StructStatement *decl) {
+  auto id = types.Create<typesys::StructType>(decl->Name(), decl->Reorder());
+  decl->SetId(id);
+  structs.emplace(decl->Name(), id);
+}
+
+void TypeInference::DeclareFunction(FunctionStatement *decl) {
+  std::vector<TypeId> params;
+  for (auto &param : decl->Parameters()->Bindings())
+    params.push_back(LowerType(param->Type()));
+
+  auto id = types.Create<FunctionType>(LowerType(decl->ReturnType()), params,
+                                       decl->IsVariadic());
+  decl->SetId(id);
+  functions.insert_or_assign(decl->Name(), id);
+}
+
+bool TypeInference::InferModule(ModuleNode *mod) {
+  auto statements = mod->Value();
+
+  // Struct names first so that fields and signatures can refer to any
+  // struct in the module, then fields, then function signatures.
+  for (auto statement : statements)
+    if (statement->Kind() == ModuleStatementKind::Struct)
+      DeclareStruct(statement->AsStruct());
+
+  for (auto statement : statements) {
+    if (statement->Kind() != ModuleStatementKind::Struct)
+      continue;
+
+    auto decl = statement->AsStruct();
+    auto type = structs.at(decl->Name()).Resolve<typesys::StructType>();
+    for (auto &member : decl->Members()->Bindings())
+      type->AddField(member->Name(), LowerType(member->Type()));
+  }
+
+  for (auto statement : statements)
+    if (statement->Kind() == ModuleStatementKind::Function)
+      DeclareFunction(statement->AsFunction());
+
+  for (auto statement : statements)
+    if (statement->Kind() == ModuleStatementKind::Function)
+      InferFunction(statement->AsFunction());
+
+  Finish();
+  return errors.empty();
+}
+
+bool TypeInference::InferStatements(
+    const std::vector<ModuleStatementNode *> &statements) {
+  errors.clear();
+
+  std::vector<StructStatement *> newStructs;
+  for (auto statement : statements) {
+    if (statement->Kind() != ModuleStatementKind::Struct)
+      continue;
+
+    auto decl = statement->AsStruct();
+    if (structs.count(decl->Name())) {
+      Error("struct " + decl->Name() + " is already defined");
+      continue;
+    }
+    DeclareStruct(decl);
+    newStructs.push_back(decl);
+  }
+
+  for (auto decl : newStructs) {
+    auto type = structs.at(decl->Name()).Resolve<typesys::StructType>();
+    for (auto &member : decl->Members()->Bindings())
+      type->AddField(member->Name(), LowerType(member->Type()));
+  }
+
+  // Signatures replaced by redefinitions, to restore on errors.
+  std::vector<std::pair<std::string, std::optional<TypeId>>> replaced;
+  for (auto statement : statements) {
+    if (statement->Kind() != ModuleStatementKind::Function)
+      continue;
+
+    auto decl = statement->AsFunction();
+    std::optional<TypeId> previous;
+    if (auto it = functions.find(decl->Name()); it != functions.end())
+      previous = it->second;
+    replaced.emplace_back(decl->Name(), previous);
+
+    DeclareFunction(decl);
+    if (previous && !(*previous == decl->Id()))
+      Error("cannot change the type of " + decl->Name() + " from " +
+            Describe(*previous) + " to " + Describe(decl->Id()));
+  }
+
+  for (auto statement : statements)
+    if (statement->Kind() == ModuleStatementKind::Function)
+      InferFunction(statement->AsFunction());
+
+  Finish();
+  if (errors.empty())
+    return true;
+
+  for (auto decl : newStructs)
+    structs.erase(decl->Name());
+  for (auto it = replaced.rbegin(); it != replaced.rend(); it++) {
+    if (it->second)
+      functions.insert_or_assign(it->first, *it->second);
+    else
+      functions.erase(it->first);
+  }
+  return false;
+}
+
+bool TypeInference::InferExpression(FunctionStatement *decl) {
+  errors.clear();
+  currentFunction = decl->Name();
+
+  scopes.emplace_back();
+  auto body = Infer(*decl->Body());
+  scopes.pop_back();
+  currentFunction.clear();
+
+  Finish();
+  decl->SetId(types.Create<FunctionType>(unifier.Resolve(body),
+                                         std::vector<TypeId>{}, false));
+  return errors.empty();
+}
+
+void TypeInference::Finish() {
+  WriteBackLiterals();
+  literals.clear();
+
+  // Substitute solved variables once so TypeOf is a plain lookup that can
+  // be shared by code generators running on several threads.
+  for (auto expr : pendingExprs) {
+    auto &type = exprTypes.at(expr);
+    type = unifier.Resolve(type);
+  }
+  for (auto let : pendingLets) {
+    auto &type = letTypes.at(let);
+    type = unifier.Resolve(type);
+  }
+  pendingExprs.clear();
+  pendingLets.clear();
+}
+
+void TypeInference::InferFunction(FunctionStatement *decl) {
+  if (!decl->Body().has_value())
+    return;
+
+  currentFunction = decl->Name();
+
+  auto signature = functions.at(decl->Name()).Resolve<FunctionType>();
+  auto bindings = decl->Parameters()->Bindings();
+
+  scopes.emplace_back();
+  for (size_t i = 0; i < bindings.size(); i++)
+    scopes.back().emplace(bindings[i]->Name(), signature->Params()[i]);
+
+  auto body = Infer(*decl->Body());
+
+  // The value of a unit function body is discarded.
+  if (decl->ReturnType()->Kind() != parser::TypeKind::Unit)
+    Expect(body, signature->Return(), "return value of " + decl->Name());
+
+  scopes.pop_back();
+  currentFunction.clear();
+}
+
+TypeId TypeInference::Infer(ExpressionNode *expr) {
+  TypeId type;
+
+  switch (expr->Kind()) {
+  case ExpressionKind::Atom:
+    type = InferAtom(expr->AsAtom());
+    break;
+  case ExpressionKind::Unary:
+    type = InferUnary(expr->AsUnary());
+    break;
+  case ExpressionKind::Binary:
+    type = InferBinary(expr->AsBinary());
+    break;
+  case ExpressionKind::Call:
+    type = InferCall(expr->AsCall());
+    break;
+  case ExpressionKind::If:
+    type = InferIf(expr->AsIf());
+    break;
+  case ExpressionKind::Block:
+    type = InferBlock(expr->AsBlock());
+    break;
+  case ExpressionKind::Let:
+    type = InferLet(expr->AsLet());
+    break;
+  case ExpressionKind::Tuple:
+    for (auto element : expr->AsTuple()->Value())
+      Infer(element);
+    type = unifier.Fresh();
+    break;
+  case ExpressionKind::Loop:
+    Infer(expr->AsLoop()->Value());
+    type = types.Create<typesys::UnitType>();
+    break;
+  case ExpressionKind::Accessor: {
+    auto accessor = expr->AsAccessor();
+    auto object = unifier.Resolve(Infer(accessor->Object()));
+    if (auto structure = object.Resolve<typesys::StructType>()) {
+      auto &fields = structure->Fields();
+      auto field = std::find_if(fields.begin(), fields.end(), [&](auto &f) {
+        return f.first == accessor->Accessor();
+      });
+      if (field != fields.end()) {
+        type = field->second;
+        break;
+      }
+      Error("no field " + accessor->Accessor() + " in " + structure->Name());
+    }
+    type = unifier.Fresh();
+    break;
+  }
+  default:
+    type = unifier.Fresh();
+    break;
+  }
+
+  exprTypes.insert_or_assign(expr, type);
+  pendingExprs.push_back(expr);
+  return type;
+}
+
+TypeId TypeInference::InferAtom(AtomExpression *atom) {
+  auto terminal = atom->Value();
+
+  switch (terminal->Kind()) {
+  case TerminalKind::Integer: {
+    auto integer = terminal->AsInteger();
+    if (!integer->IsImplicit())
+      return LowerType(integer->Type());
+
+    auto var = unifier.Fresh(Unifier::VarClass::Integer);
+    literals.emplace_back(integer, var);
+    return var;
+  }
+  case TerminalKind::Boolean:
+    return types.Create<typesys::BoolType>();
+  case TerminalKind::Character:
+    return types.Create<typesys::CharType>();
+  case TerminalKind::String:
+    return types.Create<typesys::PointerType>(
+        types.Create<typesys::CharType>());
+  case TerminalKind::UnitVal:
+    return types.Create<typesys::UnitType>();
+  case TerminalKind::Identifier: {
+    auto name = terminal->AsIdentifier()->Value();
+    if (auto type = Lookup(name))
+      return *type;
+    Error("unknown identifier " + name);
+    return unifier.Fresh();
+  }
+  default:
+    return unifier.Fresh();
+  }
+}
+
+TypeId TypeInference::InferUnary(UnaryExpression *unary) {
+  auto operand = Infer(const_cast<ExpressionNode *>(unary->Value()));
+
+  switch (unary->OpKind()) {
+  case UnaryExpression::LogicalNot: {
+    auto boolean = types.Create<typesys::BoolType>();
+    Expect(operand, boolean, "operand of !");
+    return boolean;
+  }
+  case UnaryExpression::AddressOf:
+    return types.Create<typesys::PointerType>(operand);
+  case UnaryExpression::Dereference: {
+    auto pointee = unifier.Fresh();
+    Expect(operand, types.Create<typesys::PointerType>(pointee),
+           "operand of *");
+    return pointee;
+  }
+  case UnaryExpression::Negation:
+  case UnaryExpression::BitwiseNot:
+  default:
+    return operand;
+  }
+}
+
+TypeId TypeInference::InferBinary(BinaryExpression *binary) {
+  auto left = Infer(binary->Left().get());
+  auto right = Infer(binary->Right().get());
+
+  switch (binary->OpKind()) {
+  case BinaryExpression::LogicalAnd:
+  case BinaryExpression::LogicalOr: {
+    auto boolean = types.Create<typesys::BoolType>();
+    Expect(left, boolean, "left operand of " + binary->Format());
+    Expect(right, boolean, "right operand of " + binary->Format());
+    return boolean;
+  }
+  case BinaryExpression::Equal:
+  case BinaryExpression::NotEqual:
+  case BinaryExpression::LessThan:
+  case BinaryExpression::LessThanOrEqual:
+  case BinaryExpression::GreaterThan:
+  case BinaryExpression::GreaterThanOrEqual:
+    Expect(right, left, "operands of " + binary->Format());
+    return types.Create<typesys::BoolType>();
+  default:
+    Expect(right, left, "operands of " + binary->Format());
+    return left;
+  }
+}
+
+TypeId TypeInference::InferCall(CallExpression *call) {
+  std::vector<TypeId> args;
+  for (auto arg : call->Args()->AsTuple()->Value())
+    args.push_back(Infer(arg));
+
+  auto callee = call->Callee();
+  if (callee->Kind() != ExpressionKind::Atom ||
+      callee->AsAtom()->Value()->Kind() != TerminalKind::Identifier) {
+    // Method calls are not typed yet.
+    Infer(callee);
+    return unifier.Fresh();
+  }
+
+  auto name = callee->AsAtom()->Value()->AsIdentifier()->Value();
+  auto target = Lookup(name);
+  if (!target) {
+    Error("call to unknown function " + name);
+    return unifier.Fresh();
+  }
+  exprTypes.insert_or_assign(callee, *target);
+  pendingExprs.push_back(callee);
+
+  auto function = unifier.Find(*target).Resolve<FunctionType>();
+  if (!function) {
+    Error(name + " is not a function");
+    return unifier.Fresh();
+  }
+
+  auto &params = function->Params();
+  if (args.size() < params.size() ||
+      (args.size() > params.size() && !function->Variadic())) {
+    Error("wrong number of arguments to " + name);
+    return function->Return();
+  }
+
+  for (size_t i = 0; i < params.size(); i++)
+    Expect(args[i], params[i],
+           "argument " + std::to_string(i + 1) + " of " + name);
+
+  return function->Return();
+}
+
+TypeId TypeInference::InferIf(IfExpression *ifExpr) {
+  auto boolean = types.Create<typesys::BoolType>();
+  auto &branches = ifExpr->Branches();
+  auto hasElse = std::get<0>(branches.back()) == nullptr;
+  auto result = unifier.Fresh();
+
+  for (auto &[condition, body] : branches) {
+    if (condition)
+      Expect(Infer(condition), boolean, "condition");
+
+    auto type = Infer(body);
+    if (hasElse)
+      Expect(type, result, "branch of if");
+  }
+
+  return hasElse ? result : types.Create<typesys::UnitType>();
+}
+
+TypeId TypeInference::InferBlock(BlockExpression *block) {
+  scopes.emplace_back();
+
+  TypeId result = types.Create<typesys::UnitType>();
+  for (auto statement : block->Value())
+    result = Infer(statement);
+
+  scopes.pop_back();
+  return result;
+}
+
+TypeId TypeInference::InferLet(LetExpression *let) {
+  auto value = Infer(let->Value());
+
+  if (let->Type())
+    Expect(value, LowerType(let->Type()), "initializer of " + let->Name());
+
+  scopes.back().insert_or_assign(let->Name(), value);
+  letTypes.insert_or_assign(let, value);
+  pendingLets.push_back(let);
+
+  return types.Create<typesys::UnitType>();
+}
+
+TypeId TypeInference::TypeOf(const ExpressionNode *expr) const {
+  return exprTypes.at(expr);
+}
+
+TypeId TypeInference::TypeOf(const LetExpression *let) const {
+  return letTypes.at(let);
+}
+
+void TypeInference::WriteBackLiterals() {
+  for (auto &[literal, var] : literals) {
+    auto integer = unifier.Resolve(var).Resolve<IntType>();
+    if (!integer)
+      continue;
+
+    auto kind = integer->Signed() ? parser::TypeKind::Int8
+                                  : parser::TypeKind::UInt8;
+    kind = (parser::TypeKind)(kind + (int)integer->Size());
+
+    auto type = integer->Signed() ? new TypeNode(new SIntType(kind))
+                                  : new TypeNode(new UIntType(kind));
+    type->SetId(unifier.Resolve(var));
+    literal->SetType(type);
+  }
+}
+
+} // namespace aatbe::sema
@@ -0,0 +1,212 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <sema/resolve.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace aatbe::sema {
+
+namespace {
+
+// Walks one function body with a stack of lexical scopes, mirroring the
+// scoping rules of TypeInference.
+struct FunctionResolver {
+  const Resolver &resolver;
+  FunctionInfo &info;
+  std::vector<std::unordered_map<std::string, Symbol>> scopes{};
+
+  std::optional<Symbol> Lookup(const std::string &name) const {
+    for (auto scope = scopes.rbegin(); scope != scopes.rend(); scope++)
+      if (auto it = scope->find(name); it != scope->end())
+        return it->second;
+
+    if (auto index = resolver.FunctionIndex(name))
+      return Symbol{Symbol::Kind::Function, *index};
+
+    return std::nullopt;
+  }
+
+  void Error(std::string message) {
+    info.errors.push_back({info.decl->Name(), std::move(message)});
+  }
+
+  void Resolve(ExpressionNode *expr) {
+    switch (expr->Kind()) {
+    case ExpressionKind::Atom: {
+      auto terminal = expr->AsAtom()->Value();
+      if (terminal->Kind() != TerminalKind::Identifier)
+        break;
+
+      auto name = terminal->AsIdentifier()->Value();
+      if (auto symbol = Lookup(name))
+        info.uses.try_emplace(expr, *symbol);
+      else
+        Error("unknown identifier " + name);
+      break;
+    }
+    case ExpressionKind::Unary:
+      Resolve(const_cast<ExpressionNode *>(expr->AsUnary()->Value()));
+      break;
+    case ExpressionKind::Binary:
+      Resolve(expr->AsBinary()->Left().get());
+      Resolve(expr->AsBinary()->Right().get());
+      break;
+    case ExpressionKind::Tuple:
+      for (auto element : expr->AsTuple()->Value())
+        Resolve(element);
+      break;
+    case ExpressionKind::Call:
+      Resolve(expr->AsCall()->Callee());
+      Resolve(expr->AsCall()->Args());
+      break;
+    case ExpressionKind::Block:
+      scopes.emplace_back();
+      for (auto statement : expr->AsBlock()->Value())
+        Resolve(statement);
+      scopes.pop_back();
+      break;
+    case ExpressionKind::If:
+      for (auto &[condition, body] : expr->AsIf()->Branches()) {
+        if (condition)
+          Resolve(condition);
+        Resolve(body);
+      }
+      break;
+    case ExpressionKind::Loop:
+      Resolve(expr->AsLoop()->Value());
+      break;
+    case ExpressionKind::Accessor:
+      Resolve(expr->AsAccessor()->Object());
+      break;
+    case ExpressionKind::Let: {
+      auto let = expr->AsLet();
+      // The initializer cannot see the binding it defines.
+      Resolve(let->Value());
+
+      auto slot = info.localCount++;
+      info.locals.try_emplace(let, slot);
+      scopes.back().insert_or_assign(let->Name(),
+                                     Symbol{Symbol::Kind::Local, slot});
+      break;
+    }
+    default:
+      break;
+    }
+  }
+};
+
+} // namespace
+
+std::optional<uint32_t>
+Resolver::FunctionIndex(const std::string &name) const {
+  if (auto it = functionIndex.find(name); it != functionIndex.end())
+    return it->second;
+  return std::nullopt;
+}
+
+void Resolver::ResolveFunction(FunctionInfo &info) const {
+  auto decl = info.decl;
+  if (!decl->Body().has_value())
+    return;
+
+  FunctionResolver walker{*this, info};
+
+  walker.scopes.emplace_back();
+  auto bindings = decl->Parameters()->Bindings();
+  for (uint32_t i = 0; i < bindings.size(); i++)
+    walker.scopes.back().insert_or_assign(
+        bindings[i]->Name(), Symbol{Symbol::Kind::Parameter, i});
+
+  walker.Resolve(*decl->Body());
+}
+
+void Resolver::Declare(const std::vector<ModuleStatementNode *> &statements,
+                       bool redefine) {
+  for (auto statement : statements) {
+    if (statement->Kind() != ModuleStatementKind::Function)
+      continue;
+
+    auto decl = statement->AsFunction();
+    auto index = (uint32_t)functions.size();
+    auto previous = FunctionIndex(decl->Name());
+    if (previous && !redefine) {
+      errors.push_back({"", "duplicate function " + decl->Name()});
+      continue;
+    }
+    functionIndex.insert_or_assign(decl->Name(), index);
+
+    functions.push_back(decl);
+    replaced.push_back(previous);
+    infos.push_back(std::make_unique<FunctionInfo>());
+    infos.back()->decl = decl;
+  }
+}
+
+bool Resolver::ResolveModule(ModuleNode *mod, unsigned threads) {
+  Declare(mod->Value(), false);
+
+  if (threads <= 1) {
+    for (auto &info : infos)
+      ResolveFunction(*info);
+  } else {
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++)
+      workers.emplace_back([&] {
+        for (size_t index; (index = next++) < infos.size();)
+          ResolveFunction(*infos[index]);
+      });
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  return Errors().empty();
+}
+
+bool Resolver::ResolveStatements(
+    const std::vector<ModuleStatementNode *> &statements, bool redefine) {
+  auto begin = functions.size();
+  errors.clear();
+  Declare(statements, redefine);
+
+  auto failed = !errors.empty();
+  for (auto index = begin; index < infos.size(); index++) {
+    ResolveFunction(*infos[index]);
+    failed |= !infos[index]->errors.empty();
+  }
+
+  if (failed) {
+    // Keep the errors for Errors(), but none of the functions.
+    auto all = Errors();
+    Truncate(begin);
+    errors = std::move(all);
+  }
+  return !failed;
+}
+
+void Resolver::Truncate(size_t count) {
+  while (functions.size() > count) {
+    auto name = functions.back()->Name();
+    if (auto previous = replaced.back())
+      functionIndex.insert_or_assign(name, *previous);
+    else
+      functionIndex.erase(name);
+
+    functions.pop_back();
+    replaced.pop_back();
+    infos.pop_back();
+  }
+  errors.clear();
+}
+
+std::vector<TypeError> Resolver::Errors() const {
+  auto all = errors;
+  for (auto &info : infos)
+    all.insert(all.end(), info->errors.begin(), info->errors.end());
+  return all;
+}
+
+} // namespace aatbe::sema
@@ -0,0 +1,132 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <server/daemon.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdio_ext.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace aatbe::server {
+
+Daemon::~Daemon() {
+  if (listener < 0)
+    return;
+  close(listener);
+  unlink(path.c_str());
+}
+
+llvm::Error Daemon::Listen() {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path))
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "%s: socket path too long", path.c_str());
+  memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+  auto fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return llvm::createFileError(
+        path, std::error_code(errno, std::generic_category()));
+
+  // Nobody answers on the socket of a daemon that died, it can go.
+  if (connect(fd, (sockaddr *)&address, sizeof(address)) == 0) {
+    close(fd);
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "%s: a daemon is already listening",
+                                   path.c_str());
+  }
+  if (errno == ECONNREFUSED)
+    unlink(path.c_str());
+
+  if (bind(fd, (sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(fd, 16) != 0) {
+    auto error = std::error_code(errno, std::generic_category());
+    close(fd);
+    return llvm::createFileError(path, error);
+  }
+  listener = fd;
+  return llvm::Error::success();
+}
+
+void Daemon::Serve() {
+  while (!stopping) {
+    auto client = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      // Stop shuts the listener down, which fails the accept.
+      break;
+    }
+    Handle(client);
+    close(client);
+  }
+}
+
+void Daemon::Stop() {
+  stopping = true;
+  if (listener >= 0)
+    shutdown(listener, SHUT_RDWR);
+}
+
+// Writes out what the handler left in the stdio buffers, before the
+// descriptors under them change.
+static void Flush() {
+  std::cout.flush();
+  std::cerr.flush();
+  fflush(nullptr);
+}
+
+void Daemon::Handle(int client) {
+  Request request;
+  if (!SameUser(client) || !ReceiveRequest(client, request))
+    return;
+
+  Flush();
+  int saved[3];
+  for (int fd = 0; fd < 3; fd++) {
+    saved[fd] = fcntl(fd, F_DUPFD_CLOEXEC, 3);
+    if (request.Descriptors[fd] >= 0) {
+      dup2(request.Descriptors[fd], fd);
+      close(request.Descriptors[fd]);
+    }
+  }
+  auto directory = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+  int status;
+  if (chdir(request.Directory.c_str()) != 0) {
+    fprintf(stderr, "%s: %s\n", request.Directory.c_str(), strerror(errno));
+    status = 1;
+  } else {
+    status = handler(request);
+  }
+
+  Flush();
+  // Input the handler did not read belongs to the client.
+  std::cin.clear();
+  __fpurge(stdin);
+  clearerr(stdin);
+  for (int fd = 0; fd < 3; fd++) {
+    if (saved[fd] < 0)
+      continue;
+    dup2(saved[fd], fd);
+    close(saved[fd]);
+  }
+  if (directory >= 0) {
+    if (fchdir(directory) != 0)
+      perror("daemon");
+    close(directory);
+  }
+
+  served++;
+  SendStatus(client, status);
+}
+
+} // namespace aatbe::server
@@ -0,0 +1,237 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <server/protocol.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace aatbe::server {
+
+// Requests are small; anything larger is not from a client.
+static const uint32_t MaxRequestBytes = 1 << 20;
+
+std::string DefaultSocketPath() {
+  if (auto path = getenv("AATBE_SOCKET"))
+    return path;
+  if (auto runtime = getenv("XDG_RUNTIME_DIR"))
+    return std::string(runtime) + "/aatbe.sock";
+  return "/tmp/aatbe-" + std::to_string(getuid()) + ".sock";
+}
+
+bool SameUser(int fd) {
+  ucred peer{};
+  socklen_t size = sizeof(peer);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &size) != 0)
+    return false;
+  if (peer.uid != getuid()) {
+    errno = EACCES;
+    return false;
+  }
+  return true;
+}
+
+static bool WriteAll(int fd, const char *data, size_t size) {
+  while (size > 0) {
+    auto written = write(fd, data, size);
+    if (written < 0 && errno == EINTR)
+      continue;
+    if (written <= 0)
+      return false;
+    data += written;
+    size -= (size_t)written;
+  }
+  return true;
+}
+
+static bool ReadAll(int fd, char *data, size_t size) {
+  while (size > 0) {
+    auto got = read(fd, data, size);
+    if (got < 0 && errno == EINTR)
+      continue;
+    if (got == 0)
+      errno = ECONNRESET;
+    if (got <= 0)
+      return false;
+    data += got;
+    size -= (size_t)got;
+  }
+  return true;
+}
+
+static void Append(std::string &buffer, uint32_t value) {
+  buffer.append((const char *)&value, sizeof(value));
+}
+
+bool SendRequest(int fd, const Request &request) {
+  std::string payload;
+  Append(payload, (uint32_t)request.Args.size() + 1);
+  for (auto &arg : request.Args) {
+    Append(payload, (uint32_t)arg.size());
+    payload += arg;
+  }
+  Append(payload, (uint32_t)request.Directory.size());
+  payload += request.Directory;
+
+  uint32_t size = payload.size();
+  iovec header{&size, sizeof(size)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(request.Descriptors))]{};
+  msghdr message{};
+  message.msg_iov = &header;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  auto rights = CMSG_FIRSTHDR(&message);
+  rights->cmsg_level = SOL_SOCKET;
+  rights->cmsg_type = SCM_RIGHTS;
+  rights->cmsg_len = CMSG_LEN(sizeof(request.Descriptors));
+  memcpy(CMSG_DATA(rights), request.Descriptors.data(),
+         sizeof(request.Descriptors));
+
+  ssize_t sent;
+  do
+    sent = sendmsg(fd, &message, MSG_NOSIGNAL);
+  while (sent < 0 && errno == EINTR);
+  if (sent != sizeof(size))
+    return false;
+  return WriteAll(fd, payload.data(), payload.size());
+}
+
+bool ReceiveRequest(int fd, Request &request) {
+  uint32_t size = 0;
+  iovec header{&size, sizeof(size)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(request.Descriptors))]{};
+  msghdr message{};
+  message.msg_iov = &header;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  ssize_t got;
+  do
+    got = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+  while (got < 0 && errno == EINTR);
+  if (got < 0)
+    return false;
+
+  request.Descriptors = {-1, -1, -1};
+  for (auto rights = CMSG_FIRSTHDR(&message); rights;
+       rights = CMSG_NXTHDR(&message, rights))
+    if (rights->cmsg_level == SOL_SOCKET && rights->cmsg_type == SCM_RIGHTS &&
+        rights->cmsg_len == CMSG_LEN(sizeof(request.Descriptors)))
+      memcpy(request.Descriptors.data(), CMSG_DATA(rights),
+             sizeof(request.Descriptors));
+
+  auto closeDescriptors = [&] {
+    for (auto &descriptor : request.Descriptors)
+      if (descriptor >= 0)
+        close(descriptor);
+    request.Descriptors = {-1, -1, -1};
+  };
+  if (got != sizeof(size) || size > MaxRequestBytes ||
+      (message.msg_flags & MSG_CTRUNC)) {
+    closeDescriptors();
+    errno = EPROTO;
+    return false;
+  }
+
+  std::string payload(size, '\0');
+  if (!ReadAll(fd, payload.data(), size)) {
+    closeDescriptors();
+    return false;
+  }
+
+  // Every string is checked against what is left of the payload.
+  size_t offset = 0;
+  auto next = [&](uint32_t &value) {
+    if (payload.size() - offset < sizeof(value))
+      return false;
+    memcpy(&value, payload.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+  };
+  uint32_t count = 0;
+  std::vector<std::string> strings;
+  auto valid = next(count) && count > 0;
+  for (uint32_t i = 0; valid && i < count; i++) {
+    uint32_t length = 0;
+    valid = next(length) && payload.size() - offset >= length;
+    if (valid) {
+      strings.push_back(payload.substr(offset, length));
+      offset += length;
+    }
+  }
+  if (!valid) {
+    closeDescriptors();
+    errno = EPROTO;
+    return false;
+  }
+
+  request.Directory = std::move(strings.back());
+  strings.pop_back();
+  request.Args = std::move(strings);
+  return true;
+}
+
+bool SendStatus(int fd, int status) {
+  int32_t value = status;
+  return WriteAll(fd, (const char *)&value, sizeof(value));
+}
+
+bool ReceiveStatus(int fd, int &status) {
+  int32_t value = 0;
+  if (!ReadAll(fd, (char *)&value, sizeof(value)))
+    return false;
+  status = value;
+  return true;
+}
+
+int Forward(const std::string &path, const std::vector<std::string> &args,
+            std::string &error) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    error = path + ": socket path too long";
+    return -1;
+  }
+  memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+  auto fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 || connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+    error = path + ": " + strerror(errno);
+    if (fd >= 0)
+      close(fd);
+    return -1;
+  }
+
+  // A socket in /tmp may have been put there by another user.
+  if (!SameUser(fd)) {
+    error = path + ": " + strerror(errno);
+    close(fd);
+    return -1;
+  }
+
+  Request request;
+  request.Args = args;
+  if (auto directory = getcwd(nullptr, 0)) {
+    request.Directory = directory;
+    free(directory);
+  }
+  request.Descriptors = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+
+  auto status = -1;
+  if (!SendRequest(fd, request) || !ReceiveStatus(fd, status)) {
+    error = path + ": " + strerror(errno);
+    status = -1;
+  }
+  close(fd);
+  return status;
+}
+
+} // namespace aatbe::server
@@ -3,7 +3,6 @@
 //
 
 #include <fstream>
-#include <iostream>
 #include <source/source_file.hpp>
 #include <sstream>
 
@@ -22,10 +21,8 @@ std::unique_ptr<SrcFile> SrcFile::FromString(const char *content) {
 std::unique_ptr<SrcFile> SrcFile::FromFile(const std::string &path) {
   std::ifstream input(path);
 
-  if (!input.is_open()) {
-    std::cerr << "Could not open the file - '" << path << "'" << std::endl;
-    exit(EXIT_FAILURE);
-  }
+  if (!input.is_open())
+    return nullptr;
 
   auto content = new std::string((std::istreambuf_iterator<char>(input)),
                                  std::istreambuf_iterator<char>());
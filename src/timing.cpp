@@ -0,0 +1,203 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <timing.hpp>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/JSON.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace aatbe::timing {
+
+namespace detail {
+std::atomic<bool> recording = false;
+} // namespace detail
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Event {
+  std::string name, detail;
+  Clock::time_point start;
+  Clock::duration duration{};
+};
+
+// The scopes of one thread. Only that thread adds to it; the lock is for
+// Start, Report and WriteTrace, which read or clear it from another.
+struct ThreadLog {
+  size_t id;
+  std::mutex lock{};
+  std::vector<Event> events{};
+  std::vector<Event> open{};
+};
+
+} // namespace
+
+static std::mutex logsLock;
+// Logs outlive their threads, a worker's scopes are reported after it
+// was joined.
+static std::vector<std::shared_ptr<ThreadLog>> logs;
+static size_t nextThread = 1;
+static Clock::time_point started, stopped;
+
+static ThreadLog &Log() {
+  thread_local std::shared_ptr<ThreadLog> log;
+  if (!log) {
+    log = std::make_shared<ThreadLog>();
+    std::lock_guard guard(logsLock);
+    log->id = nextThread++;
+    logs.push_back(log);
+  }
+  return *log;
+}
+
+void Start() {
+  std::lock_guard guard(logsLock);
+  // Logs of threads that are gone have been reported already.
+  logs.erase(std::remove_if(logs.begin(), logs.end(),
+                            [](auto &log) { return log.use_count() == 1; }),
+             logs.end());
+  for (auto &log : logs) {
+    std::lock_guard logGuard(log->lock);
+    log->events.clear();
+    log->open.clear();
+  }
+  started = stopped = Clock::now();
+  detail::recording = true;
+}
+
+void Stop() {
+  std::lock_guard guard(logsLock);
+  stopped = Clock::now();
+  detail::recording = false;
+}
+
+void Begin(llvm::StringRef name, std::string detail) {
+  auto &log = Log();
+  std::lock_guard guard(log.lock);
+  log.open.push_back({name.str(), std::move(detail), Clock::now()});
+}
+
+void End() {
+  auto end = Clock::now();
+  auto &log = Log();
+  std::lock_guard guard(log.lock);
+  // Start cleared the scope, or Stop came before its end.
+  if (log.open.empty())
+    return;
+  auto event = std::move(log.open.back());
+  log.open.pop_back();
+  if (!Recording())
+    return;
+  event.duration = end - event.start;
+  log.events.push_back(std::move(event));
+}
+
+// Calls `each` with every thread's log locked.
+template <typename F> static Clock::duration ForEachLog(F each) {
+  std::lock_guard guard(logsLock);
+  for (auto &log : logs) {
+    std::lock_guard logGuard(log->lock);
+    each(*log);
+  }
+  return (Recording() ? Clock::now() : stopped) - started;
+}
+
+static double Milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void Report(llvm::raw_ostream &os) {
+  struct Total {
+    Clock::duration time{};
+    size_t count = 0;
+  };
+  llvm::StringMap<Total> totals;
+  auto wall = ForEachLog([&](ThreadLog &log) {
+    for (auto &event : log.events) {
+      auto &total = totals[event.name];
+      total.time += event.duration;
+      total.count++;
+    }
+  });
+
+  std::vector<std::pair<llvm::StringRef, Total>> sorted;
+  for (auto &entry : totals)
+    sorted.emplace_back(entry.getKey(), entry.getValue());
+  std::sort(sorted.begin(), sorted.end(), [](auto &a, auto &b) {
+    return a.second.time > b.second.time;
+  });
+
+  os << "===--- Time report: " << llvm::format("%.3f", Milliseconds(wall))
+     << " ms wall time ---===\n";
+  os << "          ms       %    count  scope\n";
+  for (auto &[name, total] : sorted)
+    os << llvm::format("%12.3f %6.1f%% %8zu  ", Milliseconds(total.time),
+                       100 * Milliseconds(total.time) /
+                           std::max(Milliseconds(wall), 1e-9),
+                       total.count)
+       << name << "\n";
+}
+
+llvm::Error WriteTrace(const std::string &path) {
+  std::error_code EC;
+  llvm::raw_fd_ostream file(path, EC);
+  if (EC)
+    return llvm::createFileError(path, EC);
+
+  auto microseconds = [](Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+  };
+  auto pid = (int64_t)getpid();
+
+  llvm::json::OStream json(file);
+  json.object([&] {
+    json.attributeArray("traceEvents", [&] {
+      ForEachLog([&](ThreadLog &log) {
+        for (auto &event : log.events)
+          json.object([&] {
+            json.attribute("ph", "X");
+            json.attribute("name", event.name);
+            json.attribute("ts", microseconds(event.start - started));
+            json.attribute("dur", microseconds(event.duration));
+            json.attribute("pid", pid);
+            json.attribute("tid", (int64_t)log.id);
+            if (!event.detail.empty())
+              json.attributeObject(
+                  "args", [&] { json.attribute("detail", event.detail); });
+          });
+
+        json.object([&] {
+          json.attribute("ph", "M");
+          json.attribute("name", "thread_name");
+          json.attribute("pid", pid);
+          json.attribute("tid", (int64_t)log.id);
+          json.attributeObject("args", [&] {
+            json.attribute("name", "thread " + std::to_string(log.id));
+          });
+        });
+      });
+    });
+    json.attribute("displayTimeUnit", "ms");
+  });
+  file << "\n";
+
+  file.close();
+  if (auto error = file.error()) {
+    file.clear_error();
+    return llvm::createFileError(path, error);
+  }
+  return llvm::Error::success();
+}
+
+} // namespace aatbe::timing
@@ -0,0 +1,122 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <typesys/layout.hpp>
+
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace aatbe::typesys {
+
+std::vector<size_t>
+PackedFieldOrder(std::vector<std::pair<uint64_t, uint64_t>> const &sizeAlign) {
+  std::vector<size_t> order(sizeAlign.size());
+  std::iota(order.begin(), order.end(), 0);
+
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    auto &[lsize, lalign] = sizeAlign[lhs];
+    auto &[rsize, ralign] = sizeAlign[rhs];
+    if (lalign != ralign)
+      return lalign > ralign;
+    return lsize > rsize;
+  });
+
+  return order;
+}
+
+const TypeLayout &LayoutEngine::Get(TypeId const &id) {
+  auto index = id.Value();
+  if (index >= cache.size()) {
+    cache.resize(types.Count());
+    inProgress.resize(types.Count());
+  }
+
+  if (!cache[index]) {
+    assert(!inProgress[index] && "type contains itself by value");
+    inProgress[index] = true;
+    auto computed = std::make_unique<TypeLayout>(Compute(id));
+    inProgress[index] = false;
+    cache[index] = std::move(computed);
+  }
+
+  return *cache[index];
+}
+
+TypeLayout LayoutEngine::Primitive(llvm::Type *type) const {
+  return {layout.getTypeAllocSize(type).getFixedSize(),
+          layout.getABITypeAlign(type).value()};
+}
+
+TypeLayout LayoutEngine::Compute(TypeId const &id) {
+  auto type = types.GetType(id);
+
+  switch (type->Kind()) {
+  case TypeKind::TyInt: {
+    auto bits = 8u << (unsigned)type->As<IntType>()->Size();
+    return Primitive(llvm::IntegerType::get(context, bits));
+  }
+  case TypeKind::TyFloat:
+    return Primitive(type->As<FloatType>()->Size() ==
+                             FloatType::FloatSize::Float32
+                         ? llvm::Type::getFloatTy(context)
+                         : llvm::Type::getDoubleTy(context));
+  case TypeKind::TyBool:
+    return Primitive(llvm::Type::getInt1Ty(context));
+  case TypeKind::TyChar:
+    return Primitive(llvm::Type::getInt8Ty(context));
+  case TypeKind::TyPointer:
+  case TypeKind::TyFunction:
+    return {layout.getPointerSize(), layout.getPointerABIAlignment(0).value()};
+  case TypeKind::TyArray: {
+    auto array = type->As<ArrayType>();
+    auto &element = Get(array->Type());
+    return {element.size * array->Size(), element.align};
+  }
+  case TypeKind::TyStruct:
+    return ComputeStruct(type->As<StructType>());
+  case TypeKind::TyUnit:
+  case TypeKind::TyVoid:
+  case TypeKind::TyUnknown:
+  default:
+    return {0, 1};
+  }
+}
+
+TypeLayout LayoutEngine::ComputeStruct(StructType *type) {
+  auto &fields = type->Fields();
+
+  std::vector<std::pair<uint64_t, uint64_t>> sizeAlign;
+  sizeAlign.reserve(fields.size());
+  for (auto &[_, field] : fields) {
+    auto &fieldLayout = Get(field);
+    sizeAlign.emplace_back(fieldLayout.size, fieldLayout.align);
+  }
+
+  std::vector<size_t> order(fields.size());
+  if (type->Reorder())
+    order = PackedFieldOrder(sizeAlign);
+  else
+    std::iota(order.begin(), order.end(), 0);
+
+  TypeLayout result{0, 1};
+  result.fields.reserve(fields.size());
+
+  for (auto index : order) {
+    auto [size, align] = sizeAlign[index];
+    auto offset = llvm::alignTo(result.size, align);
+
+    result.fields.push_back({index, offset, size});
+    result.size = offset + size;
+    result.align = std::max(result.align, align);
+  }
+
+  result.size = llvm::alignTo(result.size, result.align);
+
+  return result;
+}
+
+} // namespace aatbe::typesys
@@ -1,26 +1,53 @@
-#include <atomic>
 #include <typesys/type_system.hpp>
 
+#include <thread>
+
 namespace aatbe::typesys {
 
-static std::atomic<size_t> next_tid{};
+TypeSystem::~TypeSystem() {
+  auto count = this->Count();
+  for (size_t i = 0; i < count; i++)
+    std::destroy_at(this->Slot(i));
+
+  for (size_t s = 0; s < SegmentCount; s++)
+    if (auto segment = this->segments[s].load(std::memory_order_acquire))
+      std::allocator<Type>{}.deallocate(
+          segment, (size_t)1 << (FirstSegmentBits + s));
+}
+
+Type *TypeSystem::Segment(size_t segment) {
+  auto storage = this->segments[segment].load(std::memory_order_acquire);
+  if (storage)
+    return storage;
+
+  auto size = (size_t)1 << (FirstSegmentBits + segment);
+  auto fresh = std::allocator<Type>{}.allocate(size);
+
+  if (this->segments[segment].compare_exchange_strong(
+          storage, fresh, std::memory_order_acq_rel))
+    return fresh;
+
+  // Another thread installed the segment first.
+  std::allocator<Type>{}.deallocate(fresh, size);
+  return storage;
+}
+
+TypeId TypeSystem::AddType(Type &&type) {
+  auto index = this->next.fetch_add(1, std::memory_order_acq_rel);
+  auto [segment, offset] = Locate(index);
 
-TypeId TypeId::GetNext(TypeSystem *ts) { return {ts, next_tid.fetch_add(1)}; }
+  std::construct_at(this->Segment(segment) + offset, std::move(type));
 
-#define Resolve(T)                                                             \
-  template <> T *TypeId::Resolve<T>() const {                                  \
-    return type_system->GetType(*this)->As<T>();                               \
+  // Publishes in order of index, after the types before this one; they are
+  // being constructed already, so the wait is short.
+  auto expected = index;
+  while (!this->published.compare_exchange_weak(expected, index + 1,
+                                                std::memory_order_acq_rel)) {
+    expected = index;
+    std::this_thread::yield();
   }
 
-Resolve(StructType);
-Resolve(IntType);
-Resolve(FloatType);
-Resolve(BoolType);
-Resolve(CharType);
-Resolve(UnitType);
-Resolve(ArrayType);
-Resolve(PointerType);
-Resolve(VoidType);
-Resolve(UnknownType);
+  return {this, index};
+}
 
 } // namespace aatbe::typesys
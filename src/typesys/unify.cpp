@@ -0,0 +1,177 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <typesys/unify.hpp>
+
+namespace aatbe::typesys {
+
+void Unifier::Track(size_t index) {
+  if (index < parent.size())
+    return;
+
+  auto size = std::max(index + 1, types.Count());
+  for (auto i = parent.size(); i < size; i++)
+    parent.push_back(i);
+  rank.resize(size);
+  classes.resize(size, VarClass::Any);
+}
+
+TypeId Unifier::Fresh(VarClass varClass) {
+  auto id = types.Create<TypeVarType>();
+  Track(id.Value());
+  classes[id.Value()] = varClass;
+  return id;
+}
+
+TypeId Unifier::Find(TypeId const &id) {
+  Track(id.Value());
+
+  auto root = id.Value();
+  while (parent[root] != root)
+    root = parent[root];
+
+  for (auto node = id.Value(); parent[node] != root;) {
+    auto next = parent[node];
+    parent[node] = root;
+    node = next;
+  }
+
+  return {&types, root};
+}
+
+bool Unifier::Occurs(TypeId const &var, TypeId const &type) {
+  auto root = Find(type);
+  if (root == var)
+    return true;
+
+  auto resolved = types.GetType(root);
+  switch (resolved->Kind()) {
+  case TypeKind::TyPointer:
+    return Occurs(var, resolved->As<PointerType>()->Type());
+  case TypeKind::TyArray:
+    return Occurs(var, resolved->As<ArrayType>()->Type());
+  case TypeKind::TyFunction: {
+    auto function = resolved->As<FunctionType>();
+    for (auto &param : function->Params())
+      if (Occurs(var, param))
+        return true;
+    return Occurs(var, function->Return());
+  }
+  default:
+    return false;
+  }
+}
+
+bool Unifier::Bind(TypeId const &var, TypeId const &type) {
+  auto kind = types.GetType(type)->Kind();
+
+  if (kind == TypeKind::TyVar) {
+    auto &varRank = rank[var.Value()];
+    auto &typeRank = rank[type.Value()];
+    auto &varClass = classes[var.Value()];
+    auto &typeClass = classes[type.Value()];
+    auto merged = std::max(varClass, typeClass);
+
+    if (varRank < typeRank) {
+      parent[var.Value()] = type.Value();
+      typeClass = merged;
+    } else {
+      parent[type.Value()] = var.Value();
+      varClass = merged;
+      if (varRank == typeRank)
+        varRank++;
+    }
+    return true;
+  }
+
+  if (classes[var.Value()] == VarClass::Integer && kind != TypeKind::TyInt)
+    return false;
+
+  if (Occurs(var, type))
+    return false;
+
+  parent[var.Value()] = type.Value();
+  return true;
+}
+
+bool Unifier::Unify(TypeId const &lhs, TypeId const &rhs) {
+  auto left = Find(lhs);
+  auto right = Find(rhs);
+
+  if (left == right)
+    return true;
+
+  auto leftType = types.GetType(left);
+  auto rightType = types.GetType(right);
+
+  if (leftType->Kind() == TypeKind::TyVar)
+    return Bind(left, right);
+  if (rightType->Kind() == TypeKind::TyVar)
+    return Bind(right, left);
+
+  // Structural types are interned, so two distinct concrete ids can only be
+  // made equal through the variables they contain.
+  if (leftType->Kind() != rightType->Kind())
+    return false;
+
+  switch (leftType->Kind()) {
+  case TypeKind::TyPointer:
+    return Unify(leftType->As<PointerType>()->Type(),
+                 rightType->As<PointerType>()->Type());
+  case TypeKind::TyArray: {
+    auto leftArray = leftType->As<ArrayType>();
+    auto rightArray = rightType->As<ArrayType>();
+    return leftArray->Size() == rightArray->Size() &&
+           Unify(leftArray->Type(), rightArray->Type());
+  }
+  case TypeKind::TyFunction: {
+    auto leftFunction = leftType->As<FunctionType>();
+    auto rightFunction = rightType->As<FunctionType>();
+    auto &leftParams = leftFunction->Params();
+    auto &rightParams = rightFunction->Params();
+
+    if (leftParams.size() != rightParams.size() ||
+        leftFunction->Variadic() != rightFunction->Variadic())
+      return false;
+
+    for (size_t i = 0; i < leftParams.size(); i++)
+      if (!Unify(leftParams[i], rightParams[i]))
+        return false;
+
+    return Unify(leftFunction->Return(), rightFunction->Return());
+  }
+  default:
+    return false;
+  }
+}
+
+TypeId Unifier::Resolve(TypeId const &id) {
+  auto root = Find(id);
+  auto type = types.GetType(root);
+
+  switch (type->Kind()) {
+  case TypeKind::TyVar:
+    if (classes[root.Value()] == VarClass::Integer)
+      return types.Create<IntType>(IntType::IntSize::Int64);
+    return root;
+  case TypeKind::TyPointer:
+    return types.Create<PointerType>(Resolve(type->As<PointerType>()->Type()));
+  case TypeKind::TyArray: {
+    auto array = type->As<ArrayType>();
+    return types.Create<ArrayType>(Resolve(array->Type()), array->Size());
+  }
+  case TypeKind::TyFunction: {
+    auto function = type->As<FunctionType>();
+    std::vector<TypeId> params;
+    for (auto &param : function->Params())
+      params.push_back(Resolve(param));
+    return types.Create<FunctionType>(Resolve(function->Return()), params,
+                                      function->Variadic());
+  }
+  default:
+    return root;
+  }
+}
+
+} // namespace aatbe::typesys
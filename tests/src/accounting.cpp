@@ -0,0 +1,171 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "jit/base.hpp"
+
+#include <accounting.hpp>
+#include <engine.hpp>
+#include <lexer/lexer.hpp>
+
+using namespace aatbe;
+using namespace aatbe::accounting;
+using namespace aatbe::lexer;
+
+class Accounting : public JitTest {
+protected:
+  void TearDown() override { Stop(); }
+};
+
+TEST_F(Accounting, CountsNothingUnlessStarted) {
+  Start();
+  Stop();
+  {
+    Arena arena(Phase::Parser);
+    arena.Allocate(100, 8);
+    delete new int(1);
+  }
+
+  EXPECT_EQ(Total().Bytes, 0u);
+  EXPECT_EQ(Total().Allocations, 0u);
+}
+
+TEST_F(Accounting, ScopesNest) {
+  EXPECT_EQ(Current(), Phase::Other);
+  {
+    PhaseScope parser(Phase::Parser);
+    EXPECT_EQ(Current(), Phase::Parser);
+    {
+      PhaseScope jit(Phase::Jit);
+      EXPECT_EQ(Current(), Phase::Jit);
+    }
+    EXPECT_EQ(Current(), Phase::Parser);
+  }
+  EXPECT_EQ(Current(), Phase::Other);
+}
+
+TEST_F(Accounting, CountsArenaSlabsAgainstItsPhase) {
+  struct Counted {
+    explicit Counted(int &destroyed) : destroyed(destroyed) {}
+    ~Counted() { destroyed++; }
+    int &destroyed;
+  };
+
+  Start();
+  int destroyed = 0;
+  size_t bytes;
+  {
+    PhaseScope codegen(Phase::Codegen);
+    Arena arena(Phase::Parser);
+    for (size_t i = 0; i < 10000; i++)
+      arena.Make<uint64_t>(i);
+    arena.Make<Counted>(destroyed);
+    bytes = arena.Bytes();
+
+    EXPECT_GE(bytes, 10000 * sizeof(uint64_t));
+    EXPECT_EQ(Get(Phase::Parser).Bytes, bytes);
+    EXPECT_EQ(Get(Phase::Parser).Live, bytes);
+  }
+
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_EQ(Get(Phase::Parser).Live, 0u);
+  EXPECT_EQ(Get(Phase::Parser).Peak, bytes);
+  EXPECT_GE(Total().Peak, bytes);
+}
+
+TEST_F(Accounting, CountsTheHeapByPhase) {
+  ASSERT_TRUE(Interposed());
+
+  // Called directly, as a new expression whose block is not used may be
+  // left out.
+  Start();
+  void *block;
+  {
+    PhaseScope typesys(Phase::Typesys);
+    block = ::operator new(4096);
+  }
+  auto allocated = Get(Phase::Typesys);
+  EXPECT_GE(allocated.Bytes, 4096u);
+  EXPECT_GE(allocated.Allocations, 1u);
+  EXPECT_GE(allocated.Live, 4096u);
+
+  // Released in another phase, it is still the typesys' block.
+  {
+    PhaseScope jit(Phase::Jit);
+    ::operator delete(block);
+  }
+  EXPECT_EQ(Get(Phase::Typesys).Live, allocated.Live - 4096);
+  EXPECT_GE(Get(Phase::Typesys).Peak, 4096u);
+
+  // A block of an earlier epoch is not released again.
+  {
+    PhaseScope typesys(Phase::Typesys);
+    block = ::operator new(4096);
+  }
+  Start();
+  ::operator delete(block);
+  EXPECT_EQ(Get(Phase::Typesys).Live, 0u);
+}
+
+TEST_F(Accounting, AlignsLargeAlignments) {
+  ASSERT_TRUE(Interposed());
+  struct alignas(1 << 16) Page {
+    char byte;
+  };
+
+  Start();
+  for (int i = 0; i < 4; i++) {
+    auto page = new Page();
+    EXPECT_EQ((uintptr_t)page % alignof(Page), 0u);
+    EXPECT_GE(Get(Phase::Other).Live, sizeof(Page));
+    delete page;
+  }
+  EXPECT_EQ(Get(Phase::Other).Live, 0u);
+}
+
+TEST_F(Accounting, RefusesSizesThatWrapAround) {
+  ASSERT_TRUE(Interposed());
+
+  EXPECT_EQ(::operator new(SIZE_MAX - 8, std::nothrow), nullptr);
+  EXPECT_EQ(::operator new(SIZE_MAX - 8, std::align_val_t(4096),
+                           std::nothrow),
+            nullptr);
+}
+
+TEST_F(Accounting, ReleasesTokensWithTheLexer) {
+  Start();
+  {
+    Lexer lexer(SrcFile::FromString("fn f (a: int32) -> int32 = a + 1"));
+    EXPECT_EQ(lexer.Lex().size(), 13u);
+    EXPECT_GT(Get(Phase::Lexer).Live, 0u);
+  }
+
+  EXPECT_GT(Get(Phase::Lexer).Allocations, 0u);
+  EXPECT_EQ(Get(Phase::Lexer).Live, 0u);
+}
+
+TEST_F(Accounting, CoversTheCompiler) {
+  auto engine = llvm::cantFail(Engine::Create());
+
+  Start();
+  llvm::cantFail(
+      engine->compile("fn twice (n: int64) -> int64 = n * 2", "twice"));
+  auto twice = llvm::cantFail(engine->get<int64_t(int64_t)>("twice"));
+  EXPECT_EQ(twice(21), 42);
+  Stop();
+
+  auto usage = Engine::memoryUsage();
+  for (auto phase : {Phase::Lexer, Phase::Parser, Phase::Typesys,
+                     Phase::Codegen, Phase::Jit}) {
+    EXPECT_GT(usage[(size_t)phase].Allocations, 0u) << Name(phase).str();
+    EXPECT_GE(usage[(size_t)phase].Peak, usage[(size_t)phase].Live);
+  }
+
+  std::string report;
+  llvm::raw_string_ostream os(report);
+  Report(os);
+  for (auto name : {"lexer", "parser", "typesys", "codegen", "jit", "total"})
+    EXPECT_NE(os.str().find("\n" + std::string(name) + " "),
+              std::string::npos)
+        << name;
+}
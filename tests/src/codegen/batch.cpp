@@ -0,0 +1,143 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <codegen/batch.hpp>
+#include <codegen/emit.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace aatbe::codegen;
+
+class Batch : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+  }
+
+  void SetUp() override {
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("aatbe-batch",
+                                                      directory));
+  }
+
+  void TearDown() override { llvm::sys::fs::remove_directories(directory); }
+
+  std::string Path(const std::string &name) {
+    llvm::SmallString<128> path(directory);
+    llvm::sys::path::append(path, name);
+    return path.str().str();
+  }
+
+  std::string Write(const std::string &name, const std::string &source) {
+    auto path = Path(name);
+    std::error_code EC;
+    llvm::raw_fd_ostream(path, EC) << source;
+    EXPECT_FALSE(EC);
+    return path;
+  }
+
+  llvm::SmallString<128> directory;
+};
+
+// fib and main live in separate files, so only the linked objects run.
+static const char *Fib = R"(
+  fn fib (n: int32) -> int32 = if n < 2 then n else fib(n - 1) + fib(n - 2)
+)";
+static const char *Main = R"(
+  fn fib (n: int32) -> int32
+  fn main (argc: int32, argv: ptr str) -> int32 = fib(10)
+)";
+
+static int Execute(const std::string &executable) {
+  return llvm::sys::ExecuteAndWait(executable, {executable});
+}
+
+TEST_F(Batch, CompilesEveryFileToItsObject) {
+  std::vector<std::string> files{Write("fib.aat", Fib),
+                                 Write("main.aat", Main),
+                                 Write("broken.aat", "fn f () -> int32 = g()")};
+  std::vector<std::string> objects{Path("fib.o"), Path("main.o"),
+                                   Path("broken.o")};
+
+  BatchOptions options;
+  options.Level = OptLevel::O2;
+  options.Jobs = 2;
+  auto results = BatchCompile(files, objects, options);
+  ASSERT_TRUE(!!results) << llvm::toString(results.takeError());
+  ASSERT_EQ(results->size(), 3u);
+
+  // Results are in the order of the files, whichever worker took them.
+  for (size_t i = 0; i < 2; i++) {
+    EXPECT_EQ((*results)[i].File, files[i]);
+    EXPECT_EQ((*results)[i].Object, objects[i]);
+    EXPECT_TRUE((*results)[i].Diagnostics.empty());
+    EXPECT_TRUE(llvm::sys::fs::exists(objects[i]));
+  }
+
+  // A file that fails is reported and does not stop the others.
+  EXPECT_TRUE((*results)[2].Object.empty());
+  ASSERT_FALSE((*results)[2].Diagnostics.empty());
+  EXPECT_NE((*results)[2].Diagnostics[0].find(files[2]), std::string::npos);
+  EXPECT_FALSE(llvm::sys::fs::exists(objects[2]));
+
+  auto executable = Path("fib");
+  ASSERT_FALSE(llvm::errorToBool(
+      LinkExecutable({objects[0], objects[1]}, executable)));
+  EXPECT_EQ(Execute(executable), 55);
+}
+
+TEST_F(Batch, LinksACombinedObject) {
+  std::vector<std::string> files{Write("fib.aat", Fib),
+                                 Write("main.aat", Main)};
+  std::vector<std::string> objects{Path("fib.o"), Path("main.o")};
+
+  BatchOptions options;
+  options.Jobs = 0;
+  auto results = BatchCompile(files, objects, options);
+  ASSERT_TRUE(!!results) << llvm::toString(results.takeError());
+
+  auto combined = Path("combined.o");
+  ASSERT_FALSE(llvm::errorToBool(LinkRelocatable(objects, combined)));
+  auto executable = Path("fib");
+  ASSERT_FALSE(llvm::errorToBool(LinkExecutable({combined}, executable)));
+  EXPECT_EQ(Execute(executable), 55);
+}
+
+TEST_F(Batch, LinksThePreludeIntoEveryObject) {
+  auto prelude = Prelude::Load(Prelude::DefaultPath());
+  if (!prelude) {
+    llvm::consumeError(prelude.takeError());
+    GTEST_SKIP() << "no prelude";
+  }
+
+  // Both objects call abs, each gets an internal copy.
+  std::vector<std::string> files{
+      Write("a.aat", "fn a (n: int64) -> int64 = abs(n)"),
+      Write("main.aat", R"(
+        fn a (n: int64) -> int64
+        fn main (argc: int32, argv: ptr str) -> int32 = {
+          val x = a(0 - 20) + abs(0 - 1);
+          21
+        }
+      )")};
+  std::vector<std::string> objects{Path("a.o"), Path("main.o")};
+
+  BatchOptions options;
+  options.Jobs = 2;
+  options.Runtime = std::move(*prelude);
+  auto results = BatchCompile(files, objects, options);
+  ASSERT_TRUE(!!results) << llvm::toString(results.takeError());
+  for (auto &result : *results)
+    EXPECT_TRUE(result.Diagnostics.empty()) << result.Diagnostics[0];
+
+  auto executable = Path("main");
+  ASSERT_FALSE(llvm::errorToBool(LinkExecutable(objects, executable)));
+  EXPECT_EQ(Execute(executable), 21);
+}
@@ -0,0 +1,159 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <codegen.hpp>
+
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <atomic>
+#include <map>
+#include <thread>
+
+using namespace aatbe::codegen;
+
+static bool verify(llvm::orc::ThreadSafeModule &module) {
+  return module.withModuleDo(
+      [](llvm::Module &M) { return !llvm::verifyModule(M, &llvm::errs()); });
+}
+
+TEST(Codegen, Fib) {
+  CompilationSession session("fib");
+  ASSERT_TRUE(session.AnalyzeSource(R"(
+    fn fib (n: uint64) -> uint64 =
+      if n == 0 || n == 1 then n else fib(n - 1) + fib(n - 2)
+  )"));
+
+  auto module = session.Codegen();
+  EXPECT_TRUE(verify(module));
+  module.withModuleDo([](llvm::Module &M) {
+    EXPECT_NE(M.getFunction("fib"), nullptr);
+  });
+}
+
+TEST(Codegen, Locals) {
+  CompilationSession session("locals");
+  ASSERT_TRUE(session.AnalyzeSource(R"(
+    fn scale (a: int32, b: int32) -> int32 = { val x = a * 2; val y = x / b; y - 1 }
+  )"));
+
+  auto module = session.Codegen();
+  EXPECT_TRUE(verify(module));
+}
+
+TEST(Codegen, IfChains) {
+  CompilationSession session("if");
+  ASSERT_TRUE(session.AnalyzeSource(R"(
+    fn sign (a: int64) -> int64 =
+      if a < 0 then 0 - 1 else if a > 0 then 1 else 0
+  )"));
+
+  auto module = session.Codegen();
+  EXPECT_TRUE(verify(module));
+}
+
+TEST(Codegen, RejectsUnknownNames) {
+  CompilationSession session("unknown");
+  EXPECT_FALSE(session.AnalyzeSource(R"(fn main () -> int32 = nope)"));
+  ASSERT_EQ(session.Diagnostics().size(), 1);
+}
+
+static std::string Chain(size_t count, size_t seed) {
+  std::string source = "fn f0 (a: int64) -> int64 = a\n";
+  for (size_t i = 1; i < count; i++)
+    source += "fn f" + std::to_string(i) +
+              " (a: int64) -> int64 = { val x = a + " +
+              std::to_string(seed + i) + "; f" + std::to_string(i - 1) +
+              "(x) }\n";
+  return source;
+}
+
+TEST(Codegen, ParallelShards) {
+  CompilationSession session("parallel");
+  ASSERT_TRUE(session.AnalyzeSource(Chain(100, 0)));
+
+  auto shards = session.CodegenParallel(4);
+  ASSERT_EQ(shards.size(), 4);
+
+  std::map<std::string, int> definitions;
+  for (auto &shard : shards) {
+    EXPECT_TRUE(verify(shard));
+    shard.withModuleDo([&](llvm::Module &module) {
+      for (auto &function : module)
+        if (!function.isDeclaration())
+          definitions[function.getName().str()]++;
+    });
+  }
+
+  EXPECT_EQ(definitions.size(), 100);
+  for (auto &[name, count] : definitions)
+    EXPECT_EQ(count, 1) << name;
+}
+
+static std::string Compile(const std::string &name, const std::string &source) {
+  CompilationSession session(name);
+  if (!session.AnalyzeSource(source))
+    return "";
+
+  std::string ir;
+  llvm::raw_string_ostream out(ir);
+  session.Codegen().withModuleDo(
+      [&](llvm::Module &M) { M.print(out, nullptr); });
+  return out.str();
+}
+
+TEST(Codegen, ConcurrentSessions) {
+  const size_t files = 32;
+
+  std::vector<std::string> sources;
+  for (size_t i = 0; i < files; i++)
+    sources.push_back(Chain(50, i * 1000));
+
+  std::vector<std::string> serial;
+  for (size_t i = 0; i < files; i++)
+    serial.push_back(Compile("file" + std::to_string(i), sources[i]));
+
+  std::vector<std::string> concurrent(files);
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < 8; t++)
+    pool.emplace_back([&] {
+      for (size_t i; (i = next++) < files;)
+        concurrent[i] = Compile("file" + std::to_string(i), sources[i]);
+    });
+  for (auto &worker : pool)
+    worker.join();
+
+  for (size_t i = 0; i < files; i++) {
+    EXPECT_FALSE(serial[i].empty());
+    EXPECT_EQ(concurrent[i], serial[i]) << "file" << i;
+  }
+}
+
+TEST(Codegen, DebugInfo) {
+  CompilationSession session("dir/debug.aat");
+  session.SetDebugInfo(true);
+  ASSERT_TRUE(session.AnalyzeSource(R"(
+    fn inc (a: int64) -> int64 = a + 1
+
+    fn twice (a: int64) -> int64 =
+      inc(inc(a))
+  )"));
+
+  // Optimizing inlines inc into twice, which needs every call located.
+  auto module = session.Codegen(OptLevel::O2);
+  EXPECT_TRUE(verify(module));
+  module.withModuleDo([](llvm::Module &M) {
+    auto inc = M.getFunction("inc")->getSubprogram();
+    auto twice = M.getFunction("twice")->getSubprogram();
+    ASSERT_NE(inc, nullptr);
+    ASSERT_NE(twice, nullptr);
+    EXPECT_EQ(inc->getLine(), 2);
+    EXPECT_EQ(twice->getLine(), 4);
+    EXPECT_EQ(twice->getFilename(), "debug.aat");
+    EXPECT_EQ(twice->getDirectory(), "dir");
+  });
+}
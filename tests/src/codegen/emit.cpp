@@ -0,0 +1,136 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <codegen.hpp>
+#include <codegen/emit.hpp>
+
+#include <llvm/BinaryFormat/Magic.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/TargetSelect.h>
+
+using namespace aatbe::codegen;
+
+class Emit : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+  }
+
+  void TearDown() override {
+    for (auto &path : paths)
+      llvm::sys::fs::remove(path);
+  }
+
+  std::string TempPath(const char *suffix) {
+    llvm::SmallString<128> path;
+    EXPECT_FALSE(llvm::sys::fs::createTemporaryFile("emit", suffix, path));
+    paths.push_back(path.str().str());
+    return paths.back();
+  }
+
+  std::vector<std::string> paths{};
+};
+
+// main exits with fib(10), so running the executable checks the code too.
+static const char *Source = R"(
+  fn fib (n: int32) -> int32 = if n < 2 then n else fib(n - 1) + fib(n - 2)
+  fn main (argc: int32, argv: ptr str) -> int32 = fib(10)
+)";
+
+static int Execute(const std::string &executable) {
+  return llvm::sys::ExecuteAndWait(executable, {executable});
+}
+
+TEST_F(Emit, WritesNativeObject) {
+  CompilationSession session("object");
+  ASSERT_TRUE(session.AnalyzeSource(Source));
+
+  auto machine = CreateHostMachine();
+  ASSERT_TRUE(!!machine) << llvm::toString(machine.takeError());
+
+  auto path = TempPath("o");
+  auto module = session.Codegen();
+  module.withModuleDo([&](llvm::Module &M) {
+    EXPECT_FALSE(llvm::errorToBool(EmitObject(M, **machine, path)));
+  });
+
+  llvm::file_magic magic;
+  ASSERT_FALSE(llvm::identify_magic(path, magic));
+  EXPECT_TRUE(magic == llvm::file_magic::elf_relocatable ||
+              magic == llvm::file_magic::macho_object ||
+              magic == llvm::file_magic::coff_object);
+}
+
+TEST_F(Emit, LinksExecutable) {
+  CompilationSession session("executable");
+  ASSERT_TRUE(session.AnalyzeSource(Source));
+
+  std::vector<llvm::orc::ThreadSafeModule> modules;
+  modules.push_back(session.Codegen(OptLevel::O2));
+
+  auto objects = EmitObjects(modules, OptLevel::O2, "executable");
+  ASSERT_TRUE(!!objects) << llvm::toString(objects.takeError());
+  paths.insert(paths.end(), objects->begin(), objects->end());
+
+  auto executable = TempPath("out");
+  auto linked = LinkExecutable(*objects, executable);
+  ASSERT_FALSE(!!linked) << llvm::toString(std::move(linked));
+  EXPECT_EQ(Execute(executable), 55);
+}
+
+// `lang build -o sub/hello.app`: the objects are temporaries wherever the
+// output goes, named after all of its file name.
+TEST_F(Emit, LinksIntoRelativeDirectory) {
+  CompilationSession session("relative");
+  ASSERT_TRUE(session.AnalyzeSource(Source));
+  auto modules = session.CodegenParallel(2);
+
+  llvm::SmallString<128> dir, cwd;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("emit", dir));
+  ASSERT_FALSE(llvm::sys::fs::current_path(cwd));
+  ASSERT_FALSE(llvm::sys::fs::set_current_path(dir));
+  ASSERT_FALSE(llvm::sys::fs::create_directory("sub"));
+
+  auto objects = EmitObjects(modules, OptLevel::O0, "sub/hello.app");
+  llvm::Error linked = llvm::Error::success();
+  if (objects) {
+    paths.insert(paths.end(), objects->begin(), objects->end());
+    linked = LinkExecutable(*objects, "sub/hello.app");
+  }
+  ASSERT_FALSE(llvm::sys::fs::set_current_path(cwd));
+
+  ASSERT_FALSE(!!linked) << llvm::toString(std::move(linked));
+  ASSERT_TRUE(!!objects) << llvm::toString(objects.takeError());
+  for (auto &object : *objects)
+    EXPECT_TRUE(llvm::sys::path::filename(object).startswith("hello.app."))
+        << object;
+  EXPECT_EQ(Execute((dir + "/sub/hello.app").str()), 55);
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST_F(Emit, LinksShards) {
+  CompilationSession session("shards");
+  ASSERT_TRUE(session.AnalyzeSource(Source));
+
+  auto modules = session.CodegenParallel(2);
+  auto objects = EmitObjects(modules, OptLevel::O0, "shards");
+  ASSERT_TRUE(!!objects) << llvm::toString(objects.takeError());
+  ASSERT_EQ(objects->size(), 2);
+  paths.insert(paths.end(), objects->begin(), objects->end());
+
+  auto executable = TempPath("out");
+  auto linked = LinkExecutable(*objects, executable);
+  ASSERT_FALSE(!!linked) << llvm::toString(std::move(linked));
+  EXPECT_EQ(Execute(executable), 55);
+}
+
+TEST_F(Emit, ReportsLinkErrors) {
+  auto linked = LinkExecutable({"/nonexistent/object.o"}, TempPath("out"));
+  EXPECT_TRUE(llvm::errorToBool(std::move(linked)));
+}
@@ -0,0 +1,104 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <codegen/lowering.hpp>
+
+using namespace aatbe::codegen;
+using namespace aatbe::typesys;
+
+static llvm::DataLayout X86_64() {
+  return llvm::DataLayout(
+      "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128");
+}
+
+TEST(TypeLowering, Primitives) {
+  TypeSystem ts{};
+  llvm::LLVMContext context{};
+  TypeLowering lowering(ts, context, X86_64());
+
+  EXPECT_EQ(lowering.Lower(ts.Create<IntType>(IntType::IntSize::Int8)),
+            llvm::Type::getInt8Ty(context));
+  EXPECT_EQ(lowering.Lower(ts.Create<IntType>(IntType::IntSize::Int64, false)),
+            llvm::Type::getInt64Ty(context));
+  EXPECT_EQ(lowering.Lower(ts.Create<BoolType>()),
+            llvm::Type::getInt1Ty(context));
+  EXPECT_EQ(lowering.Lower(ts.Create<FloatType>(FloatType::FloatSize::Float64)),
+            llvm::Type::getDoubleTy(context));
+  EXPECT_EQ(lowering.Lower(ts.Create<PointerType>(ts.Create<CharType>())),
+            llvm::Type::getInt8PtrTy(context));
+  EXPECT_EQ(lowering.Lower(ts.Create<UnitType>()),
+            llvm::Type::getVoidTy(context));
+}
+
+TEST(TypeLowering, Function) {
+  TypeSystem ts{};
+  llvm::LLVMContext context{};
+  TypeLowering lowering(ts, context, X86_64());
+
+  auto int32 = ts.Create<IntType>(IntType::IntSize::Int32);
+  auto str = ts.Create<PointerType>(ts.Create<CharType>());
+  auto printf = lowering.LowerFunction(
+      ts.Create<FunctionType>(int32, std::vector<TypeId>{str}, true));
+
+  EXPECT_TRUE(printf->isVarArg());
+  EXPECT_EQ(printf->getReturnType(), llvm::Type::getInt32Ty(context));
+  ASSERT_EQ(printf->getNumParams(), 1);
+  EXPECT_EQ(printf->getParamType(0), llvm::Type::getInt8PtrTy(context));
+}
+
+TEST(TypeLowering, StructLoweredOnce) {
+  TypeSystem ts{};
+  llvm::LLVMContext context{};
+  TypeLowering lowering(ts, context, X86_64());
+
+  auto tid = ts.Create<StructType>("String");
+  auto ty_struct = tid.Resolve<StructType>();
+  ty_struct->AddField("len", ts.Create<IntType>(IntType::IntSize::Int32));
+  ty_struct->AddField("data", ts.Create<PointerType>(ts.Create<CharType>()));
+
+  auto first = lowering.Lower(tid);
+  auto pointer = lowering.Lower(ts.Create<PointerType>(tid));
+
+  EXPECT_EQ(lowering.Lower(tid), first);
+  EXPECT_EQ(pointer->getPointerElementType(), first);
+  EXPECT_EQ(first->getStructName(), "String");
+  EXPECT_EQ(llvm::StructType::getTypeByName(context, "String.0"), nullptr);
+}
+
+TEST(TypeLowering, SelfReferentialStruct) {
+  TypeSystem ts{};
+  llvm::LLVMContext context{};
+  TypeLowering lowering(ts, context, X86_64());
+
+  auto tid = ts.Create<StructType>("Node");
+  auto ty_struct = tid.Resolve<StructType>();
+  ty_struct->AddField("value", ts.Create<IntType>(IntType::IntSize::Int64));
+  ty_struct->AddField("next", ts.Create<PointerType>(tid));
+
+  auto lowered = llvm::cast<llvm::StructType>(lowering.Lower(tid));
+
+  ASSERT_EQ(lowered->getNumElements(), 2);
+  EXPECT_EQ(lowered->getElementType(1)->getPointerElementType(), lowered);
+}
+
+TEST(TypeLowering, ReorderedFields) {
+  TypeSystem ts{};
+  llvm::LLVMContext context{};
+  TypeLowering lowering(ts, context, X86_64());
+
+  auto tid = ts.Create<StructType>("Packed", true);
+  auto ty_struct = tid.Resolve<StructType>();
+  ty_struct->AddField("a", ts.Create<CharType>());
+  ty_struct->AddField("b", ts.Create<IntType>(IntType::IntSize::Int64));
+  ty_struct->AddField("c", ts.Create<CharType>());
+
+  auto lowered = llvm::cast<llvm::StructType>(lowering.Lower(tid));
+
+  EXPECT_EQ(lowered->getElementType(0), llvm::Type::getInt64Ty(context));
+  EXPECT_EQ(lowering.FieldIndex(tid, 0), 1);
+  EXPECT_EQ(lowering.FieldIndex(tid, 1), 0);
+  EXPECT_EQ(lowering.FieldIndex(tid, 2), 2);
+}
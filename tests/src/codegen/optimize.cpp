@@ -0,0 +1,68 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <codegen.hpp>
+#include <codegen/optimize.hpp>
+
+#include <llvm/IR/Verifier.h>
+
+using namespace aatbe::codegen;
+
+TEST(Optimize, ParseLevels) {
+  EXPECT_EQ(ParseOptLevel("0"), OptLevel::O0);
+  EXPECT_EQ(ParseOptLevel("1"), OptLevel::O1);
+  EXPECT_EQ(ParseOptLevel("2"), OptLevel::O2);
+  EXPECT_EQ(ParseOptLevel("3"), OptLevel::O3);
+  EXPECT_EQ(ParseOptLevel("s"), OptLevel::Os);
+  EXPECT_EQ(ParseOptLevel("4"), std::nullopt);
+  EXPECT_EQ(ParseOptLevel(""), std::nullopt);
+
+  for (auto level : {OptLevel::O0, OptLevel::O1, OptLevel::O2, OptLevel::O3,
+                     OptLevel::Os})
+    EXPECT_EQ(ParseOptLevel(FormatOptLevel(level)), level);
+}
+
+static size_t InstructionCount(llvm::orc::ThreadSafeModule &module,
+                               const char *function) {
+  return module.withModuleDo([&](llvm::Module &M) {
+    EXPECT_FALSE(llvm::verifyModule(M, &llvm::errs()));
+    return (size_t)M.getFunction(function)->getInstructionCount();
+  });
+}
+
+static const char *Source = R"(
+  fn inc (a: int64) -> int64 = a + 1
+  fn roundtrip (a: int64) -> int64 =
+    { val x = inc(a); val y = x * 2; y - x - 1 }
+)";
+
+TEST(Optimize, O0KeepsCode) {
+  CompilationSession session("o0");
+  ASSERT_TRUE(session.AnalyzeSource(Source));
+
+  auto module = session.Codegen(OptLevel::O0);
+  EXPECT_GT(InstructionCount(module, "roundtrip"), 3);
+}
+
+TEST(Optimize, O2SimplifiesCode) {
+  CompilationSession session("o2");
+  ASSERT_TRUE(session.AnalyzeSource(Source));
+
+  auto unoptimized = session.Codegen(OptLevel::O0);
+  auto optimized = session.Codegen(OptLevel::O2);
+  EXPECT_LT(InstructionCount(optimized, "roundtrip"),
+            InstructionCount(unoptimized, "roundtrip"));
+}
+
+TEST(Optimize, ParallelShards) {
+  CompilationSession session("shards");
+  ASSERT_TRUE(session.AnalyzeSource(Source));
+
+  for (auto &shard : session.CodegenParallel(2, OptLevel::O3))
+    shard.withModuleDo([](llvm::Module &M) {
+      EXPECT_FALSE(llvm::verifyModule(M, &llvm::errs()));
+    });
+}
@@ -0,0 +1,139 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "../jit/base.hpp"
+
+#include <codegen/prelude.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+static const char *PreludeSource = R"(
+  fn printf (fmt: str, ...) -> int32
+  fn sum (values: ptr int64, count: int64) -> int64
+  fn twice (a: int64) -> int64 = a * 2
+  fn thrice (a: int64) -> int64 = a * 3
+)";
+
+static const char *Program = R"(
+  fn main (argc: int32, argv: ptr str) -> int32 = {
+    val x = twice(20) + 2;
+    0
+  }
+  fn answer (a: int64) -> int64 = twice(a) + 2
+)";
+
+class PreludeTest : public JitTest {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("aatbe-prelude",
+                                                      directory));
+    llvm::SmallString<128> path(directory);
+    llvm::sys::path::append(path, "prelude.bc");
+
+    CompilationSession session("prelude");
+    ASSERT_TRUE(session.AnalyzeSource(PreludeSource));
+    ASSERT_FALSE(llvm::errorToBool(
+        Prelude::Write(session, OptLevel::O2, path.str().str())));
+
+    auto loaded = Prelude::Load(path.str().str());
+    ASSERT_TRUE(!!loaded) << llvm::toString(loaded.takeError());
+    prelude = *loaded;
+  }
+
+  void TearDown() override { llvm::sys::fs::remove_directories(directory); }
+
+  llvm::SmallString<128> directory;
+  std::shared_ptr<const Prelude> prelude;
+};
+
+TEST_F(PreludeTest, WritesInterface) {
+  EXPECT_EQ(prelude->Interface(),
+            "fn printf (fmt: str, ...) -> int32\n"
+            "fn sum (values: ptr int64, count: int64) -> int64\n"
+            "fn twice (a: int64) -> int64\n"
+            "fn thrice (a: int64) -> int64\n");
+  EXPECT_EQ(Prelude::InterfacePath("/x/prelude.bc"), "/x/prelude.aati");
+}
+
+TEST_F(PreludeTest, DeclaresFunctions) {
+  CompilationSession without("program");
+  EXPECT_FALSE(without.AnalyzeSource(Program));
+
+  CompilationSession session("program");
+  session.SetPrelude(prelude);
+  ASSERT_TRUE(session.AnalyzeSource(Program));
+
+  // Only the declaration is emitted, the JIT finds the body.
+  session.Codegen().withModuleDo([](llvm::Module &M) {
+    ASSERT_NE(M.getFunction("twice"), nullptr);
+    EXPECT_TRUE(M.getFunction("twice")->isDeclaration());
+  });
+}
+
+TEST_F(PreludeTest, ProgramsMayRedeclare) {
+  CompilationSession session("program");
+  session.SetPrelude(prelude);
+  EXPECT_TRUE(session.AnalyzeSource(R"(
+    fn printf (fmt: str, ...) -> int32
+    fn twice (a: int64) -> int64 = a + a + 1
+  )"));
+}
+
+TEST_F(PreludeTest, LinksWhatExecutablesCall) {
+  CompilationSession session("program");
+  session.SetPrelude(prelude, true);
+  ASSERT_TRUE(session.AnalyzeSource(Program));
+
+  // Unoptimized, so the linked in body of twice stays, made internal.
+  session.Codegen().withModuleDo([](llvm::Module &M) {
+    auto *twice = M.getFunction("twice");
+    ASSERT_NE(twice, nullptr);
+    EXPECT_FALSE(twice->isDeclaration());
+    EXPECT_TRUE(twice->hasLocalLinkage());
+    EXPECT_EQ(M.getFunction("thrice"), nullptr);
+  });
+}
+
+TEST_F(PreludeTest, JitCompilesOnFirstCall) {
+  auto jit = llvm::cantFail(AatbeJit::Create({.PreludePath = prelude->Path()}));
+  ASSERT_NE(jit->getPreludeJITDylib(), nullptr);
+
+  CompilationSession session("program");
+  session.SetPrelude(prelude);
+  ASSERT_TRUE(session.AnalyzeSource(Program));
+  llvm::cantFail(jit->addModule(session.Codegen()));
+  EXPECT_EQ(jit->compiledModules(), 0);
+
+  EXPECT_EQ(Call(*jit, "answer", 20), 42);
+  EXPECT_EQ(jit->compiledModules(), 2);
+}
+
+TEST_F(PreludeTest, JitCachesThePrelude) {
+  llvm::SmallString<128> cache(directory);
+  llvm::sys::path::append(cache, "cache");
+
+  for (auto run = 0; run < 2; run++) {
+    auto jit = llvm::cantFail(AatbeJit::Create(
+        {.CacheDir = cache.str().str(), .PreludePath = prelude->Path()}));
+    CompilationSession session("program");
+    session.SetPrelude(prelude);
+    ASSERT_TRUE(session.AnalyzeSource(Program));
+    llvm::cantFail(jit->addModule(session.Codegen()));
+
+    EXPECT_EQ(Call(*jit, "answer", 1), 4);
+    // The program and the prelude come from the cache the second time.
+    EXPECT_EQ(jit->getObjectCache()->Hits(), run == 0 ? 0 : 2);
+  }
+}
+
+TEST_F(PreludeTest, MissingFiles) {
+  auto missing = Prelude::Load("/nonexistent/prelude.bc");
+  EXPECT_FALSE(!!missing);
+  llvm::consumeError(missing.takeError());
+
+  auto jit = AatbeJit::Create({.PreludePath = "/nonexistent/prelude.bc"});
+  EXPECT_FALSE(!!jit);
+  llvm::consumeError(jit.takeError());
+}
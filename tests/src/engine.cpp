@@ -0,0 +1,129 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "jit/base.hpp"
+
+#include <engine.hpp>
+
+using namespace aatbe;
+
+static const std::string Source = FibSource + R"(
+  fn scale (x: float64, by: int32) -> float64 = x * x
+  fn first (values: ptr int64) -> int64 = 7
+  fn length (s: str) -> int64 = 5
+  fn answer () -> int32 = 42
+)";
+
+class EngineTest : public JitTest {
+protected:
+  void SetUp() override { engine = llvm::cantFail(Engine::Create()); }
+
+  template <typename Sig> std::string Error(llvm::StringRef name) {
+    auto function = engine->get<Sig>(name);
+    if (function) {
+      ADD_FAILURE() << name.str() << " was found";
+      return "";
+    }
+    return llvm::toString(function.takeError());
+  }
+
+  std::unique_ptr<Engine> engine;
+};
+
+TEST(EngineTypes, SpellsSignatures) {
+  EXPECT_EQ(TypeName<int64_t>(), "int64");
+  EXPECT_EQ(TypeName<uint8_t>(), "uint8");
+  EXPECT_EQ(TypeName<const char *>(), "str");
+  EXPECT_EQ(TypeName<char **>(), "ptr str");
+  EXPECT_EQ(TypeName<int32_t *>(), "ptr int32");
+  EXPECT_EQ(TypeName<double &>(), "ref float64");
+  EXPECT_EQ(Signature<void()>::Name(), "()()");
+  EXPECT_EQ(Signature<int32_t(int32_t, char **)>::Name(),
+            "int32(int32, ptr str)");
+}
+
+TEST_F(EngineTest, CallsFunctions) {
+  llvm::cantFail(engine->compile(Source));
+
+  auto fib = llvm::cantFail(engine->get<int64_t(int64_t)>("fib"));
+  EXPECT_EQ(fib(20), 6765);
+  auto scale = llvm::cantFail(engine->get<double(double, int32_t)>("scale"));
+  EXPECT_EQ(scale(1.5, 0), 2.25);
+  int64_t values[] = {1, 2};
+  EXPECT_EQ(llvm::cantFail(engine->get<int64_t(int64_t *)>("first"))(values),
+            7);
+  EXPECT_EQ(
+      llvm::cantFail(engine->get<int64_t(const char *)>("length"))("hello"),
+      5);
+  EXPECT_EQ(llvm::cantFail(engine->get<int32_t()>("answer"))(), 42);
+}
+
+TEST_F(EngineTest, CachesAddresses) {
+  llvm::cantFail(engine->compile(Source));
+  auto first = llvm::cantFail(engine->get<int64_t(int64_t)>("fib"));
+  auto modules = engine->getJit().compiledModules();
+  auto second = llvm::cantFail(engine->get<int64_t(int64_t)>("fib"));
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(engine->getJit().compiledModules(), modules);
+}
+
+TEST_F(EngineTest, ChecksSignatures) {
+  llvm::cantFail(engine->compile(Source));
+  EXPECT_EQ(llvm::cantFail(engine->signature("scale")),
+            "float64(float64, int32)");
+
+  EXPECT_EQ(Error<int32_t(int32_t)>("fib"),
+            "`fib` is int64(int64), not int32(int32)");
+  EXPECT_EQ(Error<int64_t(int64_t, int64_t)>("fib"),
+            "`fib` is int64(int64), not int64(int64, int64)");
+  EXPECT_EQ(Error<int64_t(int64_t)>("missing"), "no function `missing`");
+}
+
+TEST_F(EngineTest, ReportsDiagnostics) {
+  auto id = engine->compile("fn broken () -> int64 = nope", "broken");
+  ASSERT_FALSE(!!id);
+  EXPECT_NE(llvm::toString(id.takeError()), "");
+  EXPECT_EQ(Error<int64_t()>("broken"), "no function `broken`");
+}
+
+TEST_F(EngineTest, Unloads) {
+  auto id = llvm::cantFail(engine->compile(Source, "first"));
+  EXPECT_EQ(llvm::cantFail(engine->get<int32_t()>("answer"))(), 42);
+
+  // A second definition must wait until the first is unloaded.
+  auto duplicate = engine->compile("fn answer () -> int32 = 43", "second");
+  ASSERT_FALSE(!!duplicate);
+  EXPECT_EQ(llvm::toString(duplicate.takeError()),
+            "second: `answer` is already defined");
+
+  llvm::cantFail(engine->unload(id));
+  EXPECT_EQ(Error<int32_t()>("answer"), "no function `answer`");
+  auto unloaded = engine->unload(id);
+  EXPECT_TRUE(!!unloaded);
+  llvm::consumeError(std::move(unloaded));
+
+  llvm::cantFail(engine->compile("fn answer () -> int32 = 43", "second"));
+  EXPECT_EQ(llvm::cantFail(engine->get<int32_t()>("answer"))(), 43);
+}
+
+TEST_F(EngineTest, CallsAcrossModules) {
+  llvm::cantFail(engine->compile(Source, "library"));
+  llvm::cantFail(engine->compile(R"(
+    fn fib (n: int64) -> int64
+    fn fib_twice (n: int64) -> int64 = fib(n) * 2
+  )",
+                                 "client"));
+  EXPECT_EQ(llvm::cantFail(engine->get<int64_t(int64_t)>("fib_twice"))(10),
+            110);
+}
+
+TEST_F(EngineTest, Lazy) {
+  engine = llvm::cantFail(Engine::Create({.Mode = jit::JitMode::Lazy}));
+  auto id = llvm::cantFail(engine->compile(Source));
+  auto fib = llvm::cantFail(engine->get<int64_t(int64_t)>("fib"));
+  EXPECT_EQ(engine->getJit().compiledModules(), 0);
+  EXPECT_EQ(fib(10), 55);
+  EXPECT_EQ(engine->getJit().compiledModules(), 1);
+  llvm::cantFail(engine->unload(id));
+}
@@ -0,0 +1,49 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <codegen.hpp>
+#include <jit.hpp>
+
+#include <llvm/Support/TargetSelect.h>
+
+using namespace aatbe::codegen;
+using namespace aatbe::jit;
+
+// Suites that run compiled code set up the native target first.
+class JitTest : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+  }
+};
+
+// fib, and entry calling it.
+inline const std::string FibSource = R"(
+  fn fib (n: int64) -> int64 = if n < 2 then n else fib(n - 1) + fib(n - 2)
+  fn entry (n: int64) -> int64 = fib(n)
+)";
+
+// Compiles `source` as one module into a new JIT.
+inline std::unique_ptr<AatbeJit> Load(const std::string &source,
+                                      JitOptions options = {}) {
+  CompilationSession session("test");
+  session.SetDebugInfo(options.DebuggerSupport);
+  EXPECT_TRUE(session.AnalyzeSource(source));
+
+  auto jit = llvm::cantFail(AatbeJit::Create(options));
+  llvm::cantFail(jit->addModule(session.Codegen()));
+  return jit;
+}
+
+// Calls `name`, which takes and returns an int64.
+inline int64_t Call(AatbeJit &jit, llvm::StringRef name, int64_t argument) {
+  auto symbol = llvm::cantFail(jit.lookup(name));
+  return ((int64_t(*)(int64_t))symbol.getAddress())(argument);
+}
@@ -0,0 +1,137 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "base.hpp"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+class Cache : public JitTest {
+protected:
+  void SetUp() override {
+    llvm::SmallString<128> path;
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("aatbe-cache", path));
+    directory = path.str().str();
+  }
+
+  void TearDown() override { llvm::sys::fs::remove_directories(directory); }
+
+  // Compiles `source` in a new JIT using the cache and returns entry(n).
+  int64_t Run(const std::string &source, int64_t n, size_t *hits = nullptr,
+              uint64_t bytes = 1 << 20, JitMode mode = JitMode::Eager) {
+    auto jit = Load(source, {.Level = OptLevel::O2,
+                             .Mode = mode,
+                             .CacheDir = directory,
+                             .CacheBytes = bytes});
+    auto result = Call(*jit, "entry", n);
+
+    if (hits)
+      *hits = jit->getObjectCache()->Hits();
+    compiled = jit->compiledModules();
+    return result;
+  }
+
+  size_t Objects() {
+    size_t count = 0;
+    std::error_code EC;
+    for (llvm::sys::fs::directory_iterator it(directory, EC), end;
+         it != end && !EC; it.increment(EC))
+      count += llvm::sys::path::extension(it->path()) == ".o";
+    return count;
+  }
+
+  std::string directory{};
+  size_t compiled = 0;
+};
+
+static const char *Square = R"(
+  fn entry (n: int64) -> int64 = n * n
+)";
+
+TEST_F(Cache, MissThenHit) {
+  size_t hits = 0;
+  EXPECT_EQ(Run(FibSource, 10, &hits), 55);
+  EXPECT_EQ(hits, 0);
+  EXPECT_EQ(Objects(), 1);
+
+  EXPECT_EQ(Run(FibSource, 20, &hits), 6765);
+  EXPECT_EQ(hits, 1);
+  EXPECT_EQ(compiled, 0);
+  EXPECT_EQ(Objects(), 1);
+}
+
+TEST_F(Cache, LazyFunctions) {
+  size_t hits = 0;
+  EXPECT_EQ(Run(FibSource, 10, &hits, 1 << 20, JitMode::Lazy), 55);
+  EXPECT_EQ(hits, 0);
+  EXPECT_EQ(Objects(), 2);
+
+  EXPECT_EQ(Run(FibSource, 10, &hits, 1 << 20, JitMode::Lazy), 55);
+  EXPECT_EQ(hits, 2);
+  EXPECT_EQ(Objects(), 2);
+}
+
+TEST_F(Cache, KeysDependOnCode) {
+  size_t hits = 0;
+  EXPECT_EQ(Run(FibSource, 10, &hits), 55);
+  EXPECT_EQ(Run(Square, 10, &hits), 100);
+  EXPECT_EQ(hits, 0);
+  EXPECT_EQ(Objects(), 2);
+}
+
+TEST_F(Cache, KeysDependOnTarget) {
+  CompilationSession session("cache");
+  ASSERT_TRUE(session.AnalyzeSource(Square));
+  auto module = session.Codegen();
+
+  auto JTMB = llvm::cantFail(JITTargetMachineBuilder::detectHost());
+  DiskObjectCache host(directory, 1 << 20, JTMB);
+  JTMB.setCPU("generic");
+  DiskObjectCache generic(directory, 1 << 20, JTMB);
+
+  module.withModuleDo([&](llvm::Module &M) {
+    EXPECT_EQ(host.Key(M), host.Key(M));
+    EXPECT_NE(host.Key(M), generic.Key(M));
+  });
+}
+
+// A module that missed and failed to compile must not have a later object
+// of the same module stored under its key.
+TEST_F(Cache, ForgetsKeysOfFailedCompiles) {
+  CompilationSession session("cache");
+  ASSERT_TRUE(session.AnalyzeSource(Square));
+  auto failed = session.Codegen();
+  auto compiled = session.Codegen();
+
+  auto JTMB = llvm::cantFail(JITTargetMachineBuilder::detectHost());
+  DiskObjectCache cache(directory, 1 << 20, JTMB);
+  failed.withModuleDo([&](llvm::Module &F) {
+    compiled.withModuleDo([&](llvm::Module &C) {
+      ASSERT_EQ(cache.Key(F), cache.Key(C));
+      EXPECT_EQ(cache.getObject(&F), nullptr);
+
+      EXPECT_EQ(cache.getObject(&C), nullptr);
+      cache.notifyObjectCompiled(
+          &C, llvm::MemoryBufferRef("object", "compiled"));
+
+      auto object = cache.getObject(&F);
+      ASSERT_NE(object, nullptr);
+      cache.notifyObjectCompiled(&F, llvm::MemoryBufferRef("stale", "failed"));
+      EXPECT_EQ(cache.Lookup(cache.Key(F))->getBuffer(), "object");
+    });
+  });
+}
+
+TEST_F(Cache, EvictsLeastRecentlyUsed) {
+  // Room for a single object: storing a new one evicts the older.
+  EXPECT_EQ(Run(FibSource, 10, nullptr, 1), 55);
+  EXPECT_EQ(Run(Square, 10, nullptr, 1), 100);
+  EXPECT_EQ(Objects(), 1);
+
+  size_t hits = 0;
+  EXPECT_EQ(Run(Square, 10, &hits, 1), 100);
+  EXPECT_EQ(hits, 1);
+  EXPECT_EQ(Run(FibSource, 10, &hits, 1), 55);
+  EXPECT_EQ(hits, 0);
+}
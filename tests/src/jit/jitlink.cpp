@@ -0,0 +1,105 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "base.hpp"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+// GDB's JIT interface, defined by LLVM.
+struct jit_code_entry {
+  jit_code_entry *next_entry;
+  jit_code_entry *prev_entry;
+  const char *symfile_addr;
+  uint64_t symfile_size;
+};
+
+struct jit_descriptor {
+  uint32_t version;
+  uint32_t action_flag;
+  jit_code_entry *relevant_entry;
+  jit_code_entry *first_entry;
+};
+
+extern "C" jit_descriptor __jit_debug_descriptor;
+
+class JITLink : public JitTest {
+protected:
+  void TearDown() override {
+    if (!perfMap.empty())
+      llvm::sys::fs::remove(perfMap);
+  }
+
+  std::unique_ptr<AatbeJit> Load(JitOptions options) {
+    options.Linker = ObjectLinker::JITLink;
+    return ::Load(Source, options);
+  }
+
+  std::string TempPerfMap() {
+    llvm::SmallString<128> path;
+    EXPECT_FALSE(llvm::sys::fs::createTemporaryFile("perf", "map", path));
+    perfMap = path.str().str();
+    return perfMap;
+  }
+
+  inline static const std::string Source = FibSource + R"(
+    fn printf (fmt: str, ...) -> int32
+    fn say (n: int64) -> int32 = printf("")
+  )";
+
+  std::string perfMap{};
+};
+
+TEST_F(JITLink, RunsCode) {
+  auto jit = Load({});
+  EXPECT_EQ(Call(*jit, "entry", 10), 55);
+  EXPECT_EQ(Call(*jit, "say", 0), 0);
+}
+
+TEST_F(JITLink, LazyAndTiered) {
+  auto lazy = Load({.Mode = JitMode::Lazy});
+  EXPECT_EQ(Call(*lazy, "entry", 15), 610);
+
+  auto tiered = Load({.Mode = JitMode::Tiered, .TierUpThreshold = 10});
+  EXPECT_EQ(Call(*tiered, "entry", 15), 610);
+  tiered->waitForTierUps();
+  EXPECT_EQ(Call(*tiered, "entry", 20), 6765);
+}
+
+TEST_F(JITLink, WritesPerfMap) {
+  auto path = TempPerfMap();
+  auto jit = Load({.PerfMapPath = path});
+  EXPECT_EQ(Call(*jit, "entry", 10), 55);
+  EXPECT_EQ(jit->getPerfMap()->Entries(), 3);
+
+  auto map = llvm::cantFail(llvm::errorOrToExpected(
+      llvm::MemoryBuffer::getFile(path, false, false)));
+  auto symbol = llvm::cantFail(jit->lookup("fib"));
+
+  char line[64];
+  snprintf(line, sizeof(line), "%llx ",
+           (unsigned long long)symbol.getAddress());
+  auto at = map->getBuffer().find(line);
+  ASSERT_NE(at, llvm::StringRef::npos) << map->getBuffer().str();
+  EXPECT_TRUE(map->getBuffer()
+                  .substr(at)
+                  .split('\n')
+                  .first.endswith(" fib"));
+}
+
+TEST_F(JITLink, RegistersWithDebugger) {
+  auto before = __jit_debug_descriptor.first_entry;
+  auto jit = Load({.DebuggerSupport = true});
+  EXPECT_EQ(Call(*jit, "entry", 10), 55);
+
+  ASSERT_NE(__jit_debug_descriptor.first_entry, nullptr);
+  EXPECT_NE(__jit_debug_descriptor.first_entry, before);
+  EXPECT_GT(__jit_debug_descriptor.first_entry->symfile_size, 0);
+}
+
+TEST_F(JITLink, PluginsNeedJITLink) {
+  auto jit = AatbeJit::Create({.PerfMapPath = "/dev/null"});
+  EXPECT_FALSE(!!jit);
+  llvm::consumeError(jit.takeError());
+}
@@ -0,0 +1,35 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "base.hpp"
+
+class Lazy : public JitTest {};
+
+static const std::string Source = FibSource + R"(
+  fn twice (n: int64) -> int64 = n * 2
+  fn unused (n: int64) -> int64 = twice(n) + 1
+)";
+
+TEST_F(Lazy, EagerCompilesWholeModule) {
+  auto jit = Load(Source, {.Mode = JitMode::Eager});
+  EXPECT_EQ(Call(*jit, "entry", 10), 55);
+  EXPECT_EQ(jit->compiledModules(), 1);
+}
+
+TEST_F(Lazy, CompilesOnlyCalledFunctions) {
+  auto jit = Load(Source, {.Mode = JitMode::Lazy});
+  EXPECT_EQ(jit->compiledModules(), 0);
+
+  EXPECT_EQ(Call(*jit, "entry", 10), 55);
+  EXPECT_EQ(jit->compiledModules(), 2);
+
+  EXPECT_EQ(Call(*jit, "unused", 3), 7);
+  EXPECT_EQ(jit->compiledModules(), 4);
+}
+
+TEST_F(Lazy, Optimized) {
+  auto jit = Load(Source, {.Level = OptLevel::O2, .Mode = JitMode::Lazy});
+  EXPECT_EQ(Call(*jit, "entry", 20), 6765);
+  EXPECT_EQ(Call(*jit, "unused", 20), 41);
+}
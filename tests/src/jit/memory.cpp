@@ -0,0 +1,119 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "base.hpp"
+
+#include <llvm/Support/Process.h>
+
+class SlabMemory : public JitTest {
+protected:
+  // `count` functions where f<i>(a) = a + i, one module each.
+  static void Add(AatbeJit &jit, size_t count, ResourceTrackerSP RT = nullptr) {
+    std::string source;
+    for (size_t i = 0; i < count; i++) {
+      auto n = std::to_string(i);
+      source += "fn f" + n + " (a: int64) -> int64 = a + " + n + "\n";
+    }
+
+    CompilationSession session("slabs");
+    ASSERT_TRUE(session.AnalyzeSource(source));
+    for (auto &module : session.CodegenParallel((unsigned)count))
+      llvm::cantFail(jit.addModule(std::move(module), RT));
+  }
+};
+
+TEST_F(SlabMemory, PacksBlocks) {
+  SlabPool pool(1 << 20);
+  auto page = llvm::sys::Process::getPageSizeEstimate();
+
+  auto a = llvm::cantFail(pool.Allocate(SlabPool::Kind::Code, 100, 16));
+  auto b = llvm::cantFail(pool.Allocate(SlabPool::Kind::Code, 100, 16));
+  EXPECT_EQ(b.write, a.write + 112);
+  EXPECT_NE(a.write, a.target);
+  EXPECT_EQ((uintptr_t)a.target % page, (uintptr_t)a.write % page);
+
+  auto data = llvm::cantFail(pool.Allocate(SlabPool::Kind::ReadWrite, 8, 8));
+  EXPECT_EQ(data.write, data.target);
+
+  auto stats = pool.Stats();
+  EXPECT_EQ(stats.Slabs, 2);
+  EXPECT_EQ(stats.Pages, 2);
+  EXPECT_EQ(stats.Bytes, 208);
+
+  // The writable view and the executable view share memory.
+  a.write[0] = 0xc3;
+  EXPECT_EQ(a.target[0], 0xc3);
+}
+
+TEST_F(SlabMemory, ReusesReleasedBlocks) {
+  SlabPool pool(1 << 20);
+
+  auto a = llvm::cantFail(pool.Allocate(SlabPool::Kind::Code, 64, 16));
+  auto b = llvm::cantFail(pool.Allocate(SlabPool::Kind::Code, 64, 16));
+  auto c = llvm::cantFail(pool.Allocate(SlabPool::Kind::Code, 64, 16));
+  pool.Release(a);
+  pool.Release(b);
+
+  // a and b coalesced, so a larger block fits where they were.
+  auto d = llvm::cantFail(pool.Allocate(SlabPool::Kind::Code, 128, 16));
+  EXPECT_EQ(d.write, a.write);
+  EXPECT_EQ(pool.Stats().Bytes, 192);
+
+  pool.Release(c);
+  pool.Release(d);
+  EXPECT_EQ(pool.Stats().Bytes, 0);
+  EXPECT_EQ(pool.Stats().Pages, 0);
+}
+
+TEST_F(SlabMemory, LargeSectionsGetTheirOwnSlab) {
+  SlabPool pool(4096);
+
+  auto large = llvm::cantFail(pool.Allocate(SlabPool::Kind::ReadOnly,
+                                            3 << 20, 64));
+  EXPECT_EQ((uintptr_t)large.target % 64, 0);
+  EXPECT_EQ(pool.Stats().Slabs, 1);
+  EXPECT_GE(pool.Stats().Bytes, 3 << 20);
+}
+
+TEST_F(SlabMemory, RunsManySmallModules) {
+  auto jit = llvm::cantFail(AatbeJit::Create({.SlabBytes = 1 << 20}));
+  Add(*jit, 300);
+
+  for (size_t i = 0; i < 300; i++)
+    ASSERT_EQ(Call(*jit, "f" + std::to_string(i), 1000), 1000 + (int64_t)i);
+
+  // 300 objects share a handful of pages instead of several pages each.
+  auto stats = jit->getSlabPool()->Stats();
+  EXPECT_LE(stats.Slabs, 3);
+  EXPECT_LT(stats.Pages, 50);
+  EXPECT_EQ(stats.Finalizations, 300);
+}
+
+TEST_F(SlabMemory, RemovingModulesFreesMemory) {
+  auto jit = llvm::cantFail(AatbeJit::Create({.SlabBytes = 1 << 20}));
+  auto RT = jit->getMainJITDylib().createResourceTracker();
+  Add(*jit, 20, RT);
+  EXPECT_EQ(Call(*jit, "f7", 1), 8);
+
+  auto used = jit->getSlabPool()->Stats().Bytes;
+  EXPECT_GT(used, 0);
+  llvm::cantFail(RT->remove());
+  EXPECT_LT(jit->getSlabPool()->Stats().Bytes, used);
+}
+
+TEST_F(SlabMemory, WorksWithLazyAndThreads) {
+  auto jit = llvm::cantFail(AatbeJit::Create(
+      {.Mode = JitMode::Lazy, .Threads = 4, .SlabBytes = 1 << 20}));
+  Add(*jit, 50);
+
+  for (size_t i = 0; i < 50; i++)
+    ASSERT_EQ(Call(*jit, "f" + std::to_string(i), 5), 5 + (int64_t)i);
+}
+
+TEST_F(SlabMemory, NeedsRuntimeDyld) {
+  auto jit = AatbeJit::Create(
+      {.Linker = ObjectLinker::JITLink, .SlabBytes = 1 << 20});
+  EXPECT_FALSE(!!jit);
+  llvm::consumeError(jit.takeError());
+}
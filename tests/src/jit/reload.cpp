@@ -0,0 +1,177 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "base.hpp"
+
+#include <jit/reload.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <atomic>
+#include <future>
+
+using Names = std::vector<std::string>;
+
+class HotReload : public JitTest {
+protected:
+  void SetUp() override {
+    jit = llvm::cantFail(AatbeJit::Create());
+    reloader = std::make_unique<HotReloader>(*jit, "reload");
+  }
+
+  Names Update(const std::string &source) {
+    auto names = reloader->Update(source);
+    if (!names) {
+      ADD_FAILURE() << llvm::toString(names.takeError());
+      return {};
+    }
+    std::sort(names->begin(), names->end());
+    return *names;
+  }
+
+  std::unique_ptr<AatbeJit> jit;
+  std::unique_ptr<HotReloader> reloader;
+};
+
+static const char *source = R"(
+  fn step (a: int64) -> int64 = a + 1
+  fn twice (a: int64) -> int64 = step(step(a))
+  fn fact (n: int64) -> int64 = if n < 2 then 1 else n * fact(n - 1)
+)";
+
+TEST_F(HotReload, ReloadsOnlyChangedFunctions) {
+  EXPECT_EQ(Update(source), (Names{"fact", "step", "twice"}));
+  EXPECT_EQ(Call(*jit, "twice", 1), 3);
+  EXPECT_EQ(Call(*jit, "fact", 5), 120);
+
+  // twice is not compiled again, but calls the new step.
+  EXPECT_EQ(Update(R"(
+    fn step (a: int64) -> int64 = a * 10
+    fn twice (a: int64) -> int64 = step(step(a))
+    fn fact (n: int64) -> int64 = if n < 2 then 1 else n * fact(n - 1)
+  )"),
+            (Names{"step"}));
+  EXPECT_EQ(Call(*jit, "twice", 1), 100);
+  EXPECT_EQ(reloader->Functions(), 3);
+}
+
+TEST_F(HotReload, IgnoresLayoutChanges) {
+  Update(source);
+  EXPECT_EQ(Update(R"(
+    fn step (a: int64) -> int64 =
+      a + 1
+    fn twice (a: int64) -> int64 = step(step(a))
+
+    fn fact (n: int64) -> int64 =
+      if n < 2 then 1 else n * fact(n - 1)
+  )"),
+            Names{});
+}
+
+TEST_F(HotReload, AddsFunctions) {
+  Update(source);
+  EXPECT_EQ(Update(std::string(source) +
+                   "fn thrice (a: int64) -> int64 = step(twice(a))"),
+            (Names{"thrice"}));
+  EXPECT_EQ(Call(*jit, "thrice", 0), 3);
+}
+
+TEST_F(HotReload, SignatureChangesRecompileEverything) {
+  Update(source);
+  EXPECT_EQ(Update(R"(
+    fn step (a: int32) -> int32 = a + 2
+    fn twice (a: int32) -> int32 = step(step(a))
+    fn fact (n: int64) -> int64 = if n < 2 then 1 else n * fact(n - 1)
+  )"),
+            (Names{"fact", "step", "twice"}));
+  auto symbol = llvm::cantFail(jit->lookup("twice"));
+  EXPECT_EQ(((int32_t(*)(int32_t))symbol.getAddress())(1), 5);
+}
+
+TEST_F(HotReload, ErrorsKeepTheRunningVersion) {
+  Update(source);
+  auto names = reloader->Update("fn step (a: int64) -> int64 = missing(a)");
+  ASSERT_FALSE(!!names);
+  EXPECT_NE(llvm::toString(names.takeError()).find("missing"),
+            std::string::npos);
+  EXPECT_EQ(Call(*jit, "twice", 1), 3);
+
+  // The failed version is not the one compared against.
+  EXPECT_EQ(Update(source), Names{});
+}
+
+TEST_F(HotReload, RepointsWhileRunning) {
+  Update(source);
+  auto *twice = (int64_t(*)(int64_t))llvm::cantFail(jit->lookup("twice"))
+                    .getAddress();
+
+  std::atomic<bool> done = false;
+  std::atomic<int64_t> last = 0;
+  std::thread caller([&] {
+    while (!done)
+      last = twice(1);
+  });
+
+  while (last != 3)
+    std::this_thread::yield();
+  Update("fn step (a: int64) -> int64 = a + 5\n"
+         "fn twice (a: int64) -> int64 = step(step(a))\n"
+         "fn fact (n: int64) -> int64 = n");
+  while (last != 11)
+    std::this_thread::yield();
+
+  done = true;
+  caller.join();
+}
+
+TEST_F(HotReload, WatchesFiles) {
+  llvm::SmallString<128> file;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("reload", "aat", file));
+  auto path = file.str().str();
+
+  // Replaces the file at once, with a modification time that differs even
+  // on coarse clocks.
+  auto write = [&](const std::string &content) {
+    auto next = path + ".next";
+    int fd;
+    ASSERT_FALSE(llvm::sys::fs::openFileForWrite(next, fd));
+    {
+      llvm::raw_fd_ostream out(fd, false);
+      out << content;
+    }
+    llvm::sys::fs::setLastAccessAndModificationTime(
+        fd, std::chrono::system_clock::now() + std::chrono::seconds(2));
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+    ASSERT_FALSE(llvm::sys::fs::rename(next, path));
+  };
+
+  write(source);
+  Update(source);
+
+  std::promise<Names> reloaded;
+  std::atomic<bool> reported = false;
+  reloader->Watch(path, std::chrono::milliseconds(5),
+                  [&](llvm::Expected<Names> names) {
+                    auto result = names ? *names : Names{"<error>"};
+                    if (!names)
+                      llvm::consumeError(names.takeError());
+                    if (!reported.exchange(true))
+                      reloaded.set_value(result);
+                  });
+
+  write("fn step (a: int64) -> int64 = a - 1\n"
+        "fn twice (a: int64) -> int64 = step(step(a))\n"
+        "fn fact (n: int64) -> int64 = if n < 2 then 1 else n * fact(n - 1)");
+
+  auto names = reloaded.get_future();
+  ASSERT_EQ(names.wait_for(std::chrono::seconds(10)),
+            std::future_status::ready);
+  reloader->Stop();
+  EXPECT_EQ(names.get(), Names{"step"});
+  EXPECT_EQ(Call(*jit, "twice", 1), -1);
+
+  llvm::sys::fs::remove(path);
+}
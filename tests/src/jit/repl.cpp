@@ -0,0 +1,104 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "base.hpp"
+
+#include <jit/repl.hpp>
+
+class ReplTest : public JitTest {
+protected:
+  void SetUp() override { repl = llvm::cantFail(Repl::Create()); }
+
+  std::string Eval(const std::string &input) {
+    auto result = repl->Eval(input);
+    if (!result) {
+      ADD_FAILURE() << llvm::toString(result.takeError());
+      return "<error>";
+    }
+    return *result;
+  }
+
+  std::string Error(const std::string &input) {
+    auto result = repl->Eval(input);
+    if (result) {
+      ADD_FAILURE() << input << " succeeded with " << *result;
+      return "";
+    }
+    return llvm::toString(result.takeError());
+  }
+
+  std::unique_ptr<Repl> repl;
+};
+
+TEST_F(ReplTest, EvaluatesExpressions) {
+  EXPECT_EQ(Eval("1 + 2 * 3"), "7");
+  EXPECT_EQ(Eval("10 > 3"), "true");
+  EXPECT_EQ(Eval("\"hi\""), "\"hi\"");
+  EXPECT_EQ(Eval("{ val x = 4; x * x }"), "16");
+  EXPECT_EQ(Eval("   "), "");
+}
+
+TEST_F(ReplTest, CallsDefinitions) {
+  EXPECT_EQ(Eval("fn sq (a: int64) -> int64 = a * a"), "");
+  EXPECT_EQ(Eval("fn fib (n: int64) -> int64 =\n"
+                 "  if n < 2 then n else fib(n - 1) + fib(n - 2)"),
+            "");
+  EXPECT_EQ(Eval("sq(fib(10))"), "3025");
+  EXPECT_EQ(Eval("fn narrow (a: int32) -> int32 = a - 1"), "");
+  EXPECT_EQ(Eval("narrow(0)"), "-1");
+  EXPECT_EQ(repl->Functions(), 3);
+}
+
+TEST_F(ReplTest, RedefinitionReachesEarlierCallers) {
+  Eval("fn base (a: int64) -> int64 = a + 1");
+  Eval("fn twice (a: int64) -> int64 = base(base(a))");
+  EXPECT_EQ(Eval("twice(10)"), "12");
+
+  Eval("fn base (a: int64) -> int64 = a * 10");
+  EXPECT_EQ(Eval("twice(1)"), "100");
+  EXPECT_EQ(repl->Functions(), 2);
+}
+
+TEST_F(ReplTest, FailedInputsChangeNothing) {
+  Eval("fn f (a: int64) -> int64 = a + 1");
+
+  EXPECT_NE(Error("fn f (a: bool) -> bool = a").find("cannot change the type"),
+            std::string::npos);
+  EXPECT_NE(Error("fn g (a: int64) -> int64 = h(a)").find("unknown"),
+            std::string::npos);
+  EXPECT_NE(Error("nope(1)").find("unknown"), std::string::npos);
+  EXPECT_NE(Error("1 +").find("parse error"), std::string::npos);
+
+  EXPECT_EQ(Eval("f(1)"), "2");
+  EXPECT_EQ(Eval("fn g (a: int64) -> int64 = f(a) * 2"), "");
+  EXPECT_EQ(Eval("g(1)"), "4");
+}
+
+TEST_F(ReplTest, Structs) {
+  EXPECT_EQ(Eval("struct Point { x: int64; y: int64 }"), "");
+  EXPECT_NE(Error("struct Point { x: int32 }").find("already defined"),
+            std::string::npos);
+}
+
+TEST_F(ReplTest, DetectsIncompleteInput) {
+  EXPECT_TRUE(Repl::IsIncomplete("fn f (a: int64) -> int64 ="));
+  EXPECT_TRUE(Repl::IsIncomplete("{ val x = 1;"));
+  EXPECT_TRUE(Repl::IsIncomplete("f(1,"));
+  EXPECT_FALSE(Repl::IsIncomplete("f(\"(\")"));
+  EXPECT_FALSE(Repl::IsIncomplete("fn f (a: int64) -> int64 = a"));
+}
+
+TEST_F(ReplTest, ManyDefinitionsStayFast) {
+  // Each definition calls the one before, so every input resolves against
+  // the session's tables.
+  Eval("fn f0 (a: int64) -> int64 = a");
+  for (int i = 1; i < 500; i++)
+    ASSERT_EQ(Eval("fn f" + std::to_string(i) + " (a: int64) -> int64 = f" +
+                   std::to_string(i - 1) + "(a) + 1"),
+              "");
+  EXPECT_EQ(Eval("f499(1)"), "500");
+
+  Eval("fn f0 (a: int64) -> int64 = a + 1000");
+  EXPECT_EQ(Eval("f499(1)"), "1500");
+}
@@ -0,0 +1,54 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "base.hpp"
+
+class Threads : public JitTest {};
+
+// `count` functions where f<i>(a) = a + i, spread over `shards` modules.
+static std::unique_ptr<AatbeJit> Load(size_t count, unsigned shards,
+                                      JitOptions options) {
+  std::string source;
+  for (size_t i = 0; i < count; i++) {
+    auto n = std::to_string(i);
+    source += "fn f" + n + " (a: int64) -> int64 = a + " + n + "\n";
+  }
+
+  CompilationSession session("threads");
+  EXPECT_TRUE(session.AnalyzeSource(source));
+
+  auto jit = llvm::cantFail(AatbeJit::Create(options));
+  for (auto &module : session.CodegenParallel(shards))
+    llvm::cantFail(jit->addModule(std::move(module)));
+  return jit;
+}
+
+static void ExpectAll(AatbeJit &jit, size_t count) {
+  std::vector<std::string> names;
+  for (size_t i = 0; i < count; i++)
+    names.push_back("f" + std::to_string(i));
+
+  auto symbols = llvm::cantFail(jit.lookup(names));
+  ASSERT_EQ(symbols.size(), count);
+  for (auto &[name, symbol] : symbols) {
+    auto index = std::stol((*name).substr(1).str());
+    EXPECT_EQ(((int64_t(*)(int64_t))symbol.getAddress())(100), 100 + index);
+  }
+}
+
+TEST_F(Threads, MaterializesModulesConcurrently) {
+  auto jit = Load(200, 16, {.Threads = 4});
+  ExpectAll(*jit, 200);
+  EXPECT_EQ(jit->compiledModules(), 16);
+}
+
+TEST_F(Threads, Lazy) {
+  auto jit = Load(50, 4, {.Mode = JitMode::Lazy, .Threads = 4});
+  ExpectAll(*jit, 50);
+}
+
+TEST_F(Threads, Optimized) {
+  auto jit = Load(100, 8, {.Level = OptLevel::O2, .Threads = 2});
+  ExpectAll(*jit, 100);
+}
@@ -0,0 +1,80 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include "base.hpp"
+
+class Tiered : public JitTest {
+protected:
+  void Load(const std::string &source, uint64_t threshold) {
+    jit = ::Load(source,
+                 {.Mode = JitMode::Tiered, .TierUpThreshold = threshold});
+  }
+
+  FunctionTierStats Stats(const std::string &name) {
+    for (auto &stats : jit->getTierStats())
+      if (stats.Name == name)
+        return stats;
+    ADD_FAILURE() << "no stats for " << name;
+    return {};
+  }
+
+  std::unique_ptr<AatbeJit> jit{};
+};
+
+static const std::string Source = FibSource + R"(
+  fn cold (n: int64) -> int64 = n + 1
+)";
+
+TEST_F(Tiered, StartsAtBaseline) {
+  Load(Source, 1000);
+  EXPECT_EQ(Call(*jit, "entry", 10), 55);
+
+  EXPECT_EQ(Stats("fib").Tier, 0);
+  EXPECT_EQ(Stats("fib").Calls, 177);
+  EXPECT_EQ(Stats("entry").Calls, 1);
+  EXPECT_EQ(Stats("cold").Calls, 0);
+  EXPECT_EQ(jit->getRecompiles(), 0);
+}
+
+TEST_F(Tiered, RecompilesHotFunctions) {
+  Load(Source, 100);
+  auto stub = llvm::cantFail(jit->lookup("fib")).getAddress();
+
+  EXPECT_EQ(Call(*jit, "entry", 15), 610);
+  jit->waitForTierUps();
+
+  EXPECT_EQ(Stats("fib").Tier, 1);
+  EXPECT_GT(Stats("fib").RecompileMs, 0);
+  EXPECT_EQ(Stats("entry").Tier, 0);
+  EXPECT_EQ(Stats("cold").Tier, 0);
+  EXPECT_EQ(jit->getRecompiles(), 1);
+
+  // Callers keep the stub, which now leads to the optimized code, so the
+  // baseline counter stands still.
+  EXPECT_EQ(llvm::cantFail(jit->lookup("fib")).getAddress(), stub);
+  auto calls = Stats("fib").Calls;
+  EXPECT_EQ(Call(*jit, "entry", 20), 6765);
+  EXPECT_EQ(Stats("fib").Calls, calls);
+}
+
+TEST_F(Tiered, CallsStubsAcrossTiers) {
+  // `twice` is called twice as often as `sum` and tiers up first, `sum`
+  // keeps running the baseline and reaches it through the stub.
+  Load(R"(
+    fn twice (n: int64) -> int64 = n * 2
+    fn sum (n: int64) -> int64 =
+      if n == 0 then 0 else twice(n) + twice(1) + sum(n - 1)
+  )",
+       30);
+
+  EXPECT_EQ(Call(*jit, "sum", 20), 460);
+  jit->waitForTierUps();
+  EXPECT_EQ(Stats("twice").Tier, 1);
+  EXPECT_EQ(Stats("sum").Tier, 0);
+  EXPECT_EQ(Call(*jit, "sum", 20), 460);
+
+  jit->waitForTierUps();
+  EXPECT_EQ(Stats("sum").Tier, 1);
+  EXPECT_EQ(Call(*jit, "sum", 100), 10300);
+}
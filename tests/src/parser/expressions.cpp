@@ -196,3 +196,75 @@ TEST(ExpressionParser, CallMember) {
   EXPECT_EQ(callee->AsAccessor()->Accessor(), "bar");
   EXPECT_EQ(Dig(expr, Call, Args)->AsTuple()->Size(), 0);
 }
+
+TEST(ExpressionParser, Binary) {
+  auto tokens = makeTokens(R"(a + b)");
+  Parser parser(tokens);
+
+  auto expr = ParseExpression(parser);
+
+  ASSERT_TRUE(expr);
+  EXPECT_EQ(expr.Kind(), ExpressionKind::Binary);
+  EXPECT_EQ(Dig(expr, Binary, OpKind), BinaryExpression::Addition);
+  EXPECT_EQ(Dig(expr, Binary, Left)->Format(), "a");
+  EXPECT_EQ(Dig(expr, Binary, Right)->Format(), "b");
+}
+
+TEST(ExpressionParser, BinaryPrecedence) {
+  auto tokens = makeTokens(R"(n == 0 || n < a + b * 2)");
+  Parser parser(tokens);
+
+  auto expr = ParseExpression(parser);
+
+  ASSERT_TRUE(expr);
+  EXPECT_EQ(Dig(expr, Binary, OpKind), BinaryExpression::LogicalOr);
+
+  auto rhs = Dig(expr, Binary, Right)->AsBinary();
+  EXPECT_EQ(rhs->OpKind(), BinaryExpression::LessThan);
+  EXPECT_EQ(rhs->Right()->AsBinary()->OpKind(), BinaryExpression::Addition);
+  EXPECT_EQ(rhs->Right()->AsBinary()->Right()->AsBinary()->OpKind(),
+            BinaryExpression::Multiplication);
+}
+
+TEST(ExpressionParser, BinaryLeftAssociative) {
+  auto tokens = makeTokens(R"(a - b - c)");
+  Parser parser(tokens);
+
+  auto expr = ParseExpression(parser);
+
+  ASSERT_TRUE(expr);
+  EXPECT_EQ(Dig(expr, Binary, Left)->Format(), "a - b");
+  EXPECT_EQ(Dig(expr, Binary, Right)->Format(), "c");
+}
+
+TEST(ExpressionParser, BinaryCallOperands) {
+  auto tokens = makeTokens(R"(fib(n - 1) + fib(n - 2))");
+  Parser parser(tokens);
+
+  auto expr = ParseExpression(parser);
+
+  ASSERT_TRUE(expr);
+  EXPECT_EQ(Dig(expr, Binary, Left)->Kind(), ExpressionKind::Call);
+  EXPECT_EQ(Dig(expr, Binary, Right)->Kind(), ExpressionKind::Call);
+}
+
+TEST(ExpressionParser, Let) {
+  auto tokens = makeTokens(R"({ val x = 1; var y: uint8 = x })");
+  Parser parser(tokens);
+
+  auto expr = ParseExpression(parser);
+
+  ASSERT_TRUE(expr);
+  auto statements = Unwrap(expr, Block);
+  ASSERT_EQ(statements.size(), 2);
+
+  auto x = statements[0]->AsLet();
+  EXPECT_EQ(x->Name(), "x");
+  EXPECT_EQ(x->Type(), nullptr);
+  EXPECT_FALSE(x->IsMutable());
+
+  auto y = statements[1]->AsLet();
+  EXPECT_EQ(y->Name(), "y");
+  EXPECT_EQ(y->Type()->Kind(), TypeKind::UInt8);
+  EXPECT_TRUE(y->IsMutable());
+}
@@ -20,3 +20,27 @@ TEST(ModuleParser, ParseStruct) {
   EXPECT_EQ(Dig(test, Struct, Name), "Test");
   EXPECT_EQ(Dig(test, Struct, Members)->Size(), 2);
 }
+
+TEST(ModuleParser, StructAttributes) {
+  auto tokens = makeTokens(R"(@reorder struct Test { a: int8; b: int64 })");
+  Parser parser(tokens);
+
+  auto test = ParseModuleStatement(parser);
+
+  ASSERT_TRUE(test);
+  EXPECT_EQ(test.Kind(), ModuleStatementKind::Struct);
+  EXPECT_TRUE(test.Node()->AsStruct()->Reorder());
+  EXPECT_EQ(Dig(test, Struct, Members)->Size(), 2);
+}
+
+TEST(ModuleParser, FunctionAttributes) {
+  auto tokens = makeTokens(R"(@entry fn main () -> int32 = 0int32)");
+  Parser parser(tokens);
+
+  auto test = ParseModuleStatement(parser);
+
+  ASSERT_TRUE(test);
+  EXPECT_EQ(test.Kind(), ModuleStatementKind::Function);
+  EXPECT_TRUE(test.Node()->AsFunction()->HasAttribute("entry"));
+  EXPECT_FALSE(test.Node()->AsFunction()->HasAttribute("reorder"));
+}
@@ -0,0 +1,124 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include "../parser/base.hpp"
+
+#include <parser/parser.hpp>
+#include <sema/inference.hpp>
+
+using namespace aatbe::parser;
+using namespace aatbe::sema;
+namespace typesys = aatbe::typesys;
+
+static ModuleNode *parse(const char *source) {
+  Parser parser(makeTokens(source));
+  auto mod = parser.Parse();
+  EXPECT_TRUE(mod);
+  return mod.Node();
+}
+
+static ExpressionNode *body(ModuleNode *mod, size_t index) {
+  return *mod->Value()[index]->AsFunction()->Body();
+}
+
+TEST(TypeInference, LiteralFromReturnType) {
+  auto mod = parse(R"(fn main () -> int32 = { 0 })");
+  typesys::TypeSystem ts{};
+  TypeInference inference(ts);
+
+  ASSERT_TRUE(inference.InferModule(mod));
+
+  auto literal = body(mod, 0)->AsBlock()->Value()[0];
+  EXPECT_EQ(inference.TypeOf(literal),
+            ts.Create<typesys::IntType>(typesys::IntType::IntSize::Int32));
+  EXPECT_EQ(literal->AsAtom()->Value()->AsInteger()->Type()->Kind(),
+            aatbe::parser::TypeKind::Int32);
+}
+
+TEST(TypeInference, LiteralDefaultsToInt64) {
+  auto mod = parse(R"(fn main () = { 42 })");
+  typesys::TypeSystem ts{};
+  TypeInference inference(ts);
+
+  ASSERT_TRUE(inference.InferModule(mod));
+
+  auto literal = body(mod, 0)->AsBlock()->Value()[0];
+  EXPECT_EQ(inference.TypeOf(literal),
+            ts.Create<typesys::IntType>(typesys::IntType::IntSize::Int64));
+}
+
+TEST(TypeInference, Fib) {
+  auto mod = parse(R"(
+    fn fib (n: uint64) -> uint64 =
+      if n == 0 || n == 1 then n else fib(n - 1) + fib(n - 2)
+  )");
+  typesys::TypeSystem ts{};
+  TypeInference inference(ts);
+
+  ASSERT_TRUE(inference.InferModule(mod));
+
+  auto uint64 =
+      ts.Create<typesys::IntType>(typesys::IntType::IntSize::Int64, false);
+  auto sum = std::get<1>(body(mod, 0)->AsIf()->Branches()[1]);
+  auto call = sum->AsBinary()->Left()->AsCall();
+  auto arg = call->Args()->AsTuple()->Value()[0];
+
+  EXPECT_EQ(inference.TypeOf(sum), uint64);
+  EXPECT_EQ(inference.TypeOf(arg), uint64);
+  EXPECT_EQ(inference.TypeOf(arg->AsBinary()->Right().get()), uint64);
+}
+
+TEST(TypeInference, LocalBindings) {
+  auto mod = parse(R"(
+    fn take (x: uint16) -> uint16 = x
+    fn main () -> int32 = { val a = 1; val b = a; take(b); 0 }
+  )");
+  typesys::TypeSystem ts{};
+  TypeInference inference(ts);
+
+  ASSERT_TRUE(inference.InferModule(mod));
+
+  auto statements = body(mod, 1)->AsBlock()->Value();
+  auto uint16 =
+      ts.Create<typesys::IntType>(typesys::IntType::IntSize::Int16, false);
+
+  EXPECT_EQ(inference.TypeOf(statements[0]->AsLet()), uint16);
+  EXPECT_EQ(inference.TypeOf(statements[1]->AsLet()), uint16);
+  EXPECT_EQ(inference.TypeOf(statements[3]),
+            ts.Create<typesys::IntType>(typesys::IntType::IntSize::Int32));
+}
+
+TEST(TypeInference, StringArguments) {
+  auto mod = parse(R"(
+    fn printf (fmt: str, ...) -> int32
+    fn main () -> int32 = { printf("%d", 1); 0 }
+  )");
+  typesys::TypeSystem ts{};
+  TypeInference inference(ts);
+
+  EXPECT_TRUE(inference.InferModule(mod));
+}
+
+TEST(TypeInference, Mismatch) {
+  auto mod = parse(R"(
+    fn take (x: bool) -> bool = x
+    fn main () -> int32 = { take(1); 0 }
+  )");
+  typesys::TypeSystem ts{};
+  TypeInference inference(ts);
+
+  EXPECT_FALSE(inference.InferModule(mod));
+  ASSERT_EQ(inference.Errors().size(), 1);
+  EXPECT_EQ(inference.Errors()[0].function, "main");
+}
+
+TEST(TypeInference, UnknownIdentifier) {
+  auto mod = parse(R"(fn main () -> int32 = nope)");
+  typesys::TypeSystem ts{};
+  TypeInference inference(ts);
+
+  EXPECT_FALSE(inference.InferModule(mod));
+}
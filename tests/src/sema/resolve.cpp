@@ -0,0 +1,114 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include "../parser/base.hpp"
+
+#include <parser/parser.hpp>
+#include <sema/resolve.hpp>
+
+using namespace aatbe::parser;
+using namespace aatbe::sema;
+
+static ModuleNode *parse(const char *source) {
+  Parser parser(makeTokens(source));
+  auto mod = parser.Parse();
+  EXPECT_TRUE(mod);
+  return mod.Node();
+}
+
+static ExpressionNode *body(ModuleNode *mod, size_t index) {
+  return *mod->Value()[index]->AsFunction()->Body();
+}
+
+TEST(Resolver, FunctionsAndParameters) {
+  auto mod = parse(R"(
+    fn fib (n: uint64) -> uint64 =
+      if n == 0 then n else fib(n - 1)
+  )");
+  Resolver resolver;
+
+  ASSERT_TRUE(resolver.ResolveModule(mod));
+  ASSERT_EQ(resolver.Functions().size(), 1);
+
+  auto &info = resolver.Info(0);
+  auto &branches = body(mod, 0)->AsIf()->Branches();
+  auto condition = std::get<0>(branches[0])->AsBinary()->Left().get();
+  auto call = std::get<1>(branches[1])->AsCall();
+
+  EXPECT_EQ(info.Use(condition).kind, Symbol::Kind::Parameter);
+  EXPECT_EQ(info.Use(condition).index, 0);
+  EXPECT_EQ(info.Use(call->Callee()).kind, Symbol::Kind::Function);
+  EXPECT_EQ(info.Use(call->Callee()).index, 0);
+}
+
+TEST(Resolver, Locals) {
+  auto mod = parse(R"(
+    fn main (a: int32) -> int32 = { val a = a; val b = a; { val a = b; a }; b }
+  )");
+  Resolver resolver;
+
+  ASSERT_TRUE(resolver.ResolveModule(mod));
+
+  auto &info = resolver.Info(0);
+  auto statements = body(mod, 0)->AsBlock()->Value();
+  auto first = statements[0]->AsLet();
+  auto second = statements[1]->AsLet();
+  auto inner = statements[2]->AsBlock()->Value();
+
+  EXPECT_EQ(info.localCount, 3);
+  EXPECT_EQ(info.locals.lookup(first), 0);
+  EXPECT_EQ(info.locals.lookup(second), 1);
+
+  // The initializer of `val a = a` still sees the parameter.
+  EXPECT_EQ(info.Use(first->Value()).kind, Symbol::Kind::Parameter);
+  EXPECT_EQ(info.Use(second->Value()).kind, Symbol::Kind::Local);
+  EXPECT_EQ(info.Use(second->Value()).index, 0);
+  EXPECT_EQ(info.Use(inner[1]).index, 2);
+  EXPECT_EQ(info.Use(statements[3]).index, 1);
+}
+
+TEST(Resolver, UnknownIdentifier) {
+  auto mod = parse(R"(fn main () -> int32 = { val a = 1; b })");
+  Resolver resolver;
+
+  EXPECT_FALSE(resolver.ResolveModule(mod));
+  ASSERT_EQ(resolver.Errors().size(), 1);
+  EXPECT_EQ(resolver.Errors()[0].function, "main");
+}
+
+TEST(Resolver, DuplicateFunction) {
+  auto mod = parse(R"(
+    fn f () -> int32 = 0
+    fn f () -> int32 = 1
+  )");
+  Resolver resolver;
+
+  EXPECT_FALSE(resolver.ResolveModule(mod));
+  EXPECT_EQ(resolver.Functions().size(), 1);
+}
+
+TEST(Resolver, ParallelMatchesSerial) {
+  std::string source = "fn f0 (a: int64) -> int64 = a\n";
+  for (size_t i = 1; i < 200; i++)
+    source += "fn f" + std::to_string(i) +
+              " (a: int64) -> int64 = { val x = a; f" +
+              std::to_string(i - 1) + "(x) }\n";
+  auto mod = parse(source.c_str());
+
+  Resolver serial, parallel;
+  ASSERT_TRUE(serial.ResolveModule(mod));
+  ASSERT_TRUE(parallel.ResolveModule(mod, 8));
+
+  for (uint32_t i = 0; i < serial.Functions().size(); i++) {
+    auto &lhs = serial.Info(i);
+    auto &rhs = parallel.Info(i);
+    ASSERT_EQ(lhs.uses.size(), rhs.uses.size());
+    for (auto &[node, symbol] : lhs.uses) {
+      EXPECT_EQ(rhs.Use(node).kind, symbol.kind);
+      EXPECT_EQ(rhs.Use(node).index, symbol.index);
+    }
+  }
+}
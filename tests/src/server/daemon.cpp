@@ -0,0 +1,217 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <server/daemon.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+#include <cstdio>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace aatbe::server;
+
+// Everything written to the pipe `fd` until it is closed.
+static std::string Drain(int fd) {
+  std::string data;
+  char buffer[256];
+  ssize_t got;
+  while ((got = read(fd, buffer, sizeof(buffer))) > 0)
+    data.append(buffer, (size_t)got);
+  return data;
+}
+
+class DaemonTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("aatbe-daemon",
+                                                      directory));
+    llvm::SmallString<128> socket(directory);
+    llvm::sys::path::append(socket, "aatbe.sock");
+    path = socket.str().str();
+  }
+
+  void TearDown() override {
+    if (server.joinable()) {
+      daemon->Stop();
+      server.join();
+    }
+    daemon.reset();
+    llvm::sys::fs::remove_directories(directory);
+  }
+
+  void Start(Daemon::Handler handler) {
+    daemon = std::make_unique<Daemon>(path, std::move(handler));
+    ASSERT_FALSE(llvm::errorToBool(daemon->Listen()));
+    server = std::thread([this] { daemon->Serve(); });
+  }
+
+  // Sends `args` with a pipe as stdout and returns the exit status and
+  // what the handler wrote.
+  std::pair<int, std::string> Send(std::vector<std::string> args) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path.c_str());
+    auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    EXPECT_EQ(connect(fd, (sockaddr *)&address, sizeof(address)), 0);
+
+    int output[2];
+    EXPECT_EQ(pipe(output), 0);
+    Request request{std::move(args), directory.str().str(),
+                    {STDIN_FILENO, output[1], STDERR_FILENO}};
+    EXPECT_TRUE(SendRequest(fd, request));
+    close(output[1]);
+
+    auto status = -1;
+    EXPECT_TRUE(ReceiveStatus(fd, status));
+    close(fd);
+    auto written = Drain(output[0]);
+    close(output[0]);
+    return {status, written};
+  }
+
+  llvm::SmallString<128> directory;
+  std::string path;
+  std::unique_ptr<Daemon> daemon;
+  std::thread server;
+};
+
+TEST(Protocol, PassesArgumentsAndDescriptors) {
+  int sockets[2], output[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+  ASSERT_EQ(pipe(output), 0);
+
+  Request sent{{"build", "-O2", "", "x.aat"}, "/tmp", {0, output[1], 2}};
+  ASSERT_TRUE(SendRequest(sockets[0], sent));
+  close(output[1]);
+
+  Request received;
+  ASSERT_TRUE(ReceiveRequest(sockets[1], received));
+  EXPECT_EQ(received.Args, sent.Args);
+  EXPECT_EQ(received.Directory, "/tmp");
+
+  // The descriptors are new ones for the same files.
+  ASSERT_GE(received.Descriptors[1], 0);
+  EXPECT_NE(received.Descriptors[1], output[1]);
+  ASSERT_EQ(write(received.Descriptors[1], "out", 3), 3);
+  for (auto descriptor : received.Descriptors)
+    close(descriptor);
+  EXPECT_EQ(Drain(output[0]), "out");
+
+  ASSERT_TRUE(SendStatus(sockets[1], 3));
+  auto status = 0;
+  ASSERT_TRUE(ReceiveStatus(sockets[0], status));
+  EXPECT_EQ(status, 3);
+
+  close(output[0]);
+  close(sockets[0]);
+  close(sockets[1]);
+}
+
+TEST(Protocol, TrustsOnlyTheSameUser) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  EXPECT_TRUE(SameUser(fds[0]));
+  EXPECT_TRUE(SameUser(fds[1]));
+  close(fds[0]);
+  close(fds[1]);
+
+  // Not a socket, so there is no peer to trust.
+  ASSERT_EQ(pipe(fds), 0);
+  EXPECT_FALSE(SameUser(fds[0]));
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST(Protocol, RejectsMalformedRequests) {
+  int sockets[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+
+  // Says it holds one string of 100 bytes, but holds 3.
+  uint32_t payload[] = {4 + 4 + 3, 1, 100};
+  ASSERT_EQ(write(sockets[0], payload, sizeof(payload)), sizeof(payload));
+  ASSERT_EQ(write(sockets[0], "abc", 3), 3);
+
+  Request received;
+  EXPECT_FALSE(ReceiveRequest(sockets[1], received));
+
+  close(sockets[0]);
+  EXPECT_FALSE(ReceiveRequest(sockets[1], received));
+  close(sockets[1]);
+}
+
+TEST_F(DaemonTest, RunsRequestsWithTheClientsOutput) {
+  Start([](const Request &request) {
+    printf("%s in %s\n", request.Args[0].c_str(),
+           llvm::sys::path::filename(request.Directory).str().c_str());
+    char cwd[4096];
+    EXPECT_EQ(std::string(getcwd(cwd, sizeof(cwd))), request.Directory);
+    return (int)request.Args.size();
+  });
+
+  auto name = llvm::sys::path::filename(directory).str();
+  EXPECT_EQ(Send({"first"}), std::make_pair(1, "first in " + name + "\n"));
+  EXPECT_EQ(Send({"second", "x"}),
+            std::make_pair(2, "second in " + name + "\n"));
+  EXPECT_EQ(daemon->Served(), 2);
+
+  // The daemon's own directory is back once a request is done.
+  char cwd[4096];
+  EXPECT_NE(std::string(getcwd(cwd, sizeof(cwd))), directory.str().str());
+}
+
+TEST_F(DaemonTest, StopsFromAHandler) {
+  Start([this](const Request &) {
+    daemon->Stop();
+    return 0;
+  });
+  EXPECT_EQ(Send({"--stop-daemon"}).first, 0);
+  server.join();
+  EXPECT_EQ(daemon->Served(), 1);
+}
+
+TEST_F(DaemonTest, ReplacesStaleSockets) {
+  Start([](const Request &) { return 0; });
+
+  // The socket is taken while the daemon listens.
+  Daemon second(path, [](const Request &) { return 0; });
+  auto taken = second.Listen();
+  EXPECT_TRUE(!!taken);
+  llvm::consumeError(std::move(taken));
+
+  // A socket nobody listens on is left behind by a daemon that died.
+  daemon->Stop();
+  server.join();
+  auto stale = socket(AF_UNIX, SOCK_STREAM, 0);
+  daemon.reset();
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, path.c_str());
+  ASSERT_EQ(bind(stale, (sockaddr *)&address, sizeof(address)), 0);
+  close(stale);
+
+  Start([](const Request &request) { return 5; });
+  EXPECT_EQ(Send({}).first, 5);
+}
+
+TEST_F(DaemonTest, ForwardsRequests) {
+  Start([](const Request &request) {
+    return request.Args == std::vector<std::string>{"run", "x.aat"} ? 9 : 1;
+  });
+
+  std::string error;
+  EXPECT_EQ(Forward(path, {"run", "x.aat"}, error), 9);
+
+  daemon->Stop();
+  server.join();
+  daemon.reset();
+  EXPECT_EQ(Forward(path, {"run"}, error), -1);
+  EXPECT_NE(error.find(path), std::string::npos);
+}
@@ -0,0 +1,145 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <codegen/session.hpp>
+#include <timing.hpp>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <thread>
+
+using namespace aatbe;
+
+static std::string Report() {
+  std::string report;
+  llvm::raw_string_ostream os(report);
+  timing::Report(os);
+  return os.str();
+}
+
+// How often the scope `name` ran, by its line in `report`, 0 without one.
+static size_t Count(const std::string &report, const std::string &name) {
+  auto end = report.find("  " + name + "\n");
+  if (end == std::string::npos)
+    return 0;
+  auto begin = report.rfind('\n', end) + 1;
+  double ms, percent;
+  size_t count = 0;
+  sscanf(report.c_str() + begin, "%lf %lf%% %zu", &ms, &percent, &count);
+  return count;
+}
+
+// The events of the trace at `path` named `name`.
+static std::vector<llvm::json::Object> Events(const std::string &path,
+                                              llvm::StringRef name) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  EXPECT_TRUE(!!buffer);
+  auto trace = llvm::json::parse((*buffer)->getBuffer());
+  EXPECT_TRUE(!!trace) << llvm::toString(trace.takeError());
+
+  std::vector<llvm::json::Object> events;
+  for (auto &event : *trace->getAsObject()->getArray("traceEvents"))
+    if (event.getAsObject()->getString("name") == name)
+      events.push_back(*event.getAsObject());
+  return events;
+}
+
+class Timing : public ::testing::Test {
+protected:
+  void TearDown() override {
+    timing::Stop();
+    if (!path.empty())
+      llvm::sys::fs::remove(path);
+  }
+
+  std::string TracePath() {
+    llvm::SmallString<128> file;
+    EXPECT_FALSE(llvm::sys::fs::createTemporaryFile("trace", "json", file));
+    return path = file.str().str();
+  }
+
+  std::string path;
+};
+
+TEST_F(Timing, RecordsNothingUnlessStarted) {
+  timing::Start();
+  timing::Stop();
+  auto computed = false;
+  {
+    timing::Scope scope("idle", [&] {
+      computed = true;
+      return std::string("detail");
+    });
+  }
+  EXPECT_FALSE(computed);
+  EXPECT_EQ(Count(Report(), "idle"), 0u);
+}
+
+TEST_F(Timing, SumsScopesOverThreads) {
+  timing::Start();
+  {
+    timing::Scope outer("outer");
+    for (auto i = 0; i < 2; i++)
+      timing::Scope inner("inner");
+  }
+  std::thread([] { timing::Scope scope("inner"); }).join();
+  timing::Stop();
+
+  auto report = Report();
+  EXPECT_EQ(Count(report, "outer"), 1u) << report;
+  EXPECT_EQ(Count(report, "inner"), 3u) << report;
+
+  // Starting again drops what was recorded.
+  timing::Start();
+  EXPECT_EQ(Count(Report(), "outer"), 0u);
+}
+
+TEST_F(Timing, WritesAChromeTrace) {
+  timing::Start();
+  {
+    timing::Scope scope("main", [] { return std::string("on main"); });
+  }
+  std::thread([] { timing::Scope scope("worker"); }).join();
+  timing::Stop();
+
+  auto trace = TracePath();
+  ASSERT_FALSE(llvm::errorToBool(timing::WriteTrace(trace)));
+
+  auto main = Events(trace, "main");
+  ASSERT_EQ(main.size(), 1u);
+  EXPECT_EQ(*main[0].getString("ph"), "X");
+  EXPECT_EQ(*main[0].getObject("args")->getString("detail"), "on main");
+  auto worker = Events(trace, "worker");
+  ASSERT_EQ(worker.size(), 1u);
+  EXPECT_NE(main[0].getInteger("tid"), worker[0].getInteger("tid"));
+  EXPECT_GE(*worker[0].getInteger("ts"), *main[0].getInteger("ts"));
+}
+
+TEST_F(Timing, CoversTheCompiler) {
+  timing::Start();
+  codegen::CompilationSession session("timed");
+  ASSERT_TRUE(session.AnalyzeSource(R"(
+    fn fib (n: int64) -> int64 = if n < 2 then n else fib(n - 1) + fib(n - 2)
+    fn main () -> int32 = 0
+  )"));
+  session.Codegen(codegen::OptLevel::O2);
+  timing::Stop();
+
+  auto report = Report();
+  for (auto phase : {"Lex", "Parse", "Resolve", "Infer", "DeclPass",
+                     "CodegenPass", "Optimize", "InstCombinePass"})
+    EXPECT_GT(Count(report, phase), 0u) << phase << " in\n" << report;
+  EXPECT_EQ(Count(report, "Codegen function"), 2u) << report;
+
+  auto trace = TracePath();
+  ASSERT_FALSE(llvm::errorToBool(timing::WriteTrace(trace)));
+  std::vector<std::string> functions;
+  for (auto &event : Events(trace, "Codegen function"))
+    functions.push_back(event.getObject("args")->getString("detail")->str());
+  EXPECT_EQ(functions, (std::vector<std::string>{"fib", "main"}));
+}
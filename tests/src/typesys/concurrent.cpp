@@ -0,0 +1,143 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <typesys/type_system.hpp>
+
+#include <thread>
+
+using namespace aatbe::typesys;
+
+namespace {
+
+// Interns a fixed set of overlapping shapes and returns their ids in a
+// deterministic order, independent of which thread created them first.
+std::vector<TypeId> InternShapes(TypeSystem &ts, size_t depth) {
+  std::vector<TypeId> ids;
+
+  for (auto size : {IntType::IntSize::Int8, IntType::IntSize::Int16,
+                    IntType::IntSize::Int32, IntType::IntSize::Int64}) {
+    for (auto sign : {true, false}) {
+      auto id = ts.Create<IntType>(size, sign);
+      ids.push_back(id);
+
+      for (size_t i = 0; i < depth; i++) {
+        id = ts.Create<PointerType>(id);
+        ids.push_back(id);
+        ids.push_back(ts.Create<ArrayType>(id, i));
+      }
+
+      ids.push_back(ts.Create<FunctionType>(id, std::vector<TypeId>{id, id}));
+    }
+  }
+
+  return ids;
+}
+
+} // namespace
+
+TEST(ConcurrentTypeSystem, InterningAgreesAcrossThreads) {
+  constexpr size_t threads = 16;
+  constexpr size_t depth = 64;
+
+  TypeSystem ts{};
+  std::vector<std::vector<TypeId>> results(threads);
+  std::vector<std::thread> workers;
+
+  for (size_t t = 0; t < threads; t++)
+    workers.emplace_back([&, t] { results[t] = InternShapes(ts, depth); });
+  for (auto &worker : workers)
+    worker.join();
+
+  for (size_t t = 1; t < threads; t++)
+    EXPECT_EQ(results[t], results[0]);
+
+  // 8 integer types, each with `depth` pointers and arrays and 1 function.
+  EXPECT_EQ(ts.Count(), 8 * (1 + 2 * depth + 1));
+}
+
+TEST(ConcurrentTypeSystem, ResolveWhileInterning) {
+  constexpr size_t threads = 8;
+  constexpr size_t perThread = 4096;
+
+  TypeSystem ts{};
+  auto base = ts.Create<CharType>();
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> workers;
+
+  for (size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      std::vector<TypeId> mine;
+      for (size_t i = 0; i < perThread; i++) {
+        mine.push_back(ts.Create<ArrayType>(base, t * perThread + i));
+
+        auto &probe = mine[i / 2];
+        auto array = probe.Resolve<ArrayType>();
+        if (!array || array->Size() != t * perThread + i / 2)
+          failed = true;
+      }
+    });
+  }
+  for (auto &worker : workers)
+    worker.join();
+
+  EXPECT_FALSE(failed);
+  EXPECT_EQ(ts.Count(), 1 + threads * perThread);
+}
+
+TEST(ConcurrentTypeSystem, CountsOnlyConstructedTypes) {
+  constexpr size_t threads = 8;
+  constexpr size_t perThread = 4096;
+
+  TypeSystem ts{};
+  std::atomic<bool> done{false};
+  std::atomic<bool> failed{false};
+
+  std::thread reader([&] {
+    while (!done)
+      if (auto count = ts.Count())
+        if (!TypeId(&ts, count - 1).Resolve<StructType>())
+          failed = true;
+  });
+
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; t++)
+    workers.emplace_back([&] {
+      for (size_t i = 0; i < perThread; i++)
+        ts.Create<StructType>("S");
+    });
+  for (auto &worker : workers)
+    worker.join();
+  done = true;
+  reader.join();
+
+  EXPECT_FALSE(failed);
+  EXPECT_EQ(ts.Count(), threads * perThread);
+}
+
+TEST(ConcurrentTypeSystem, StructsGetDistinctIds) {
+  constexpr size_t threads = 8;
+  constexpr size_t perThread = 512;
+
+  TypeSystem ts{};
+  std::vector<std::vector<TypeId>> results(threads);
+  std::vector<std::thread> workers;
+
+  for (size_t t = 0; t < threads; t++)
+    workers.emplace_back([&, t] {
+      for (size_t i = 0; i < perThread; i++)
+        results[t].push_back(ts.Create<StructType>("S"));
+    });
+  for (auto &worker : workers)
+    worker.join();
+
+  std::vector<bool> seen(ts.Count());
+  for (auto &ids : results)
+    for (auto &id : ids) {
+      EXPECT_FALSE(seen[id.Value()]);
+      seen[id.Value()] = true;
+    }
+  EXPECT_EQ(ts.Count(), threads * perThread);
+}
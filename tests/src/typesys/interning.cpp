@@ -0,0 +1,82 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <typesys/type_system.hpp>
+
+using namespace aatbe::typesys;
+
+TEST(TypeInterning, SameIntShape) {
+  TypeSystem ts{};
+
+  auto a = ts.Create<IntType>(IntType::IntSize::Int32);
+  auto b = ts.Create<IntType>(IntType::IntSize::Int32, true);
+
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(ts.Count(), 1);
+}
+
+TEST(TypeInterning, DistinctIntShapes) {
+  TypeSystem ts{};
+
+  auto int32 = ts.Create<IntType>(IntType::IntSize::Int32);
+  auto uint32 = ts.Create<IntType>(IntType::IntSize::Int32, false);
+  auto int64 = ts.Create<IntType>(IntType::IntSize::Int64);
+
+  EXPECT_FALSE(int32 == uint32);
+  EXPECT_FALSE(int32 == int64);
+  EXPECT_EQ(ts.Count(), 3);
+}
+
+TEST(TypeInterning, Pointers) {
+  TypeSystem ts{};
+
+  auto int32 = ts.Create<IntType>(IntType::IntSize::Int32);
+  auto a = ts.Create<PointerType>(int32);
+  auto b = ts.Create<PointerType>(ts.Create<IntType>(IntType::IntSize::Int32));
+  auto c = ts.Create<PointerType>(a);
+
+  EXPECT_EQ(a, b);
+  EXPECT_FALSE(a == c);
+  EXPECT_EQ(c.Resolve<PointerType>()->Type(), a);
+  EXPECT_EQ(ts.Count(), 3);
+}
+
+TEST(TypeInterning, Arrays) {
+  TypeSystem ts{};
+
+  auto chr = ts.Create<CharType>();
+  auto a = ts.Create<ArrayType>(chr, 16);
+  auto b = ts.Create<ArrayType>(ts.Create<CharType>(), 16);
+  auto c = ts.Create<ArrayType>(chr, 32);
+
+  EXPECT_EQ(a, b);
+  EXPECT_FALSE(a == c);
+}
+
+TEST(TypeInterning, Functions) {
+  TypeSystem ts{};
+
+  auto int32 = ts.Create<IntType>(IntType::IntSize::Int32);
+  auto str = ts.Create<PointerType>(ts.Create<CharType>());
+
+  auto printf = ts.Create<FunctionType>(int32, std::vector<TypeId>{str}, true);
+  auto same = ts.Create<FunctionType>(int32, std::vector<TypeId>{str}, true);
+  auto puts = ts.Create<FunctionType>(int32, std::vector<TypeId>{str});
+
+  EXPECT_EQ(printf, same);
+  EXPECT_FALSE(printf == puts);
+  EXPECT_TRUE(printf.Resolve<FunctionType>()->Variadic());
+  EXPECT_EQ(puts.Resolve<FunctionType>()->Params().size(), 1);
+}
+
+TEST(TypeInterning, StructsAreNominal) {
+  TypeSystem ts{};
+
+  auto a = ts.Create<StructType>("Test");
+  auto b = ts.Create<StructType>("Test");
+
+  EXPECT_FALSE(a == b);
+}
@@ -0,0 +1,108 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <typesys/layout.hpp>
+
+using namespace aatbe::typesys;
+
+static llvm::DataLayout X86_64() {
+  return llvm::DataLayout(
+      "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128");
+}
+
+TEST(StructLayout, FieldsKeepDeclarationOrder) {
+  TypeSystem ts{};
+
+  auto tid = ts.Create<StructType>("Test");
+  auto ty_struct = tid.Resolve<StructType>();
+  ty_struct->AddField("c", ts.Create<CharType>());
+  ty_struct->AddField("b", ts.Create<BoolType>());
+  ty_struct->AddField("a", ts.Create<IntType>(IntType::IntSize::Int64));
+
+  ASSERT_EQ(ty_struct->Fields().size(), 3);
+  EXPECT_EQ(ty_struct->Fields()[0].first, "c");
+  EXPECT_EQ(ty_struct->Fields()[1].first, "b");
+  EXPECT_EQ(ty_struct->Fields()[2].first, "a");
+  EXPECT_EQ(ty_struct->FieldIndex("a"), 2);
+}
+
+TEST(StructLayout, Primitives) {
+  TypeSystem ts{};
+  LayoutEngine layout(ts, X86_64());
+
+  EXPECT_EQ(layout.SizeOf(ts.Create<IntType>(IntType::IntSize::Int8)), 1);
+  EXPECT_EQ(layout.SizeOf(ts.Create<IntType>(IntType::IntSize::Int16)), 2);
+  EXPECT_EQ(layout.SizeOf(ts.Create<IntType>(IntType::IntSize::Int32)), 4);
+  EXPECT_EQ(layout.SizeOf(ts.Create<IntType>(IntType::IntSize::Int64)), 8);
+  EXPECT_EQ(layout.SizeOf(ts.Create<FloatType>(FloatType::FloatSize::Float64)),
+            8);
+  EXPECT_EQ(layout.SizeOf(ts.Create<PointerType>(ts.Create<CharType>())), 8);
+  EXPECT_EQ(layout.SizeOf(ts.Create<ArrayType>(
+                ts.Create<IntType>(IntType::IntSize::Int32), 10)),
+            40);
+}
+
+TEST(StructLayout, DeclarationOrderPadding) {
+  TypeSystem ts{};
+  LayoutEngine layout(ts, X86_64());
+
+  auto tid = ts.Create<StructType>("Padded");
+  auto ty_struct = tid.Resolve<StructType>();
+  ty_struct->AddField("a", ts.Create<CharType>());
+  ty_struct->AddField("b", ts.Create<IntType>(IntType::IntSize::Int64));
+  ty_struct->AddField("c", ts.Create<CharType>());
+
+  auto &result = layout.Get(tid);
+
+  EXPECT_EQ(result.size, 24);
+  EXPECT_EQ(result.align, 8);
+  EXPECT_EQ(result.Padding(), 14);
+  EXPECT_EQ(result.Field(0).offset, 0);
+  EXPECT_EQ(result.Field(1).offset, 8);
+  EXPECT_EQ(result.Field(2).offset, 16);
+}
+
+TEST(StructLayout, ReorderMinimizesPadding) {
+  TypeSystem ts{};
+  LayoutEngine layout(ts, X86_64());
+
+  auto tid = ts.Create<StructType>("Packed", true);
+  auto ty_struct = tid.Resolve<StructType>();
+  ty_struct->AddField("a", ts.Create<CharType>());
+  ty_struct->AddField("b", ts.Create<IntType>(IntType::IntSize::Int64));
+  ty_struct->AddField("c", ts.Create<CharType>());
+  ty_struct->AddField("d", ts.Create<IntType>(IntType::IntSize::Int16));
+
+  auto &result = layout.Get(tid);
+
+  EXPECT_EQ(result.size, 16);
+  EXPECT_EQ(result.Field(1).offset, 0);
+  EXPECT_EQ(result.Field(3).offset, 8);
+  EXPECT_EQ(result.Field(0).offset, 10);
+  EXPECT_EQ(result.Field(2).offset, 11);
+}
+
+TEST(StructLayout, NestedStructsAreCached) {
+  TypeSystem ts{};
+  LayoutEngine layout(ts, X86_64());
+
+  auto inner = ts.Create<StructType>("Inner");
+  inner.Resolve<StructType>()->AddField(
+      "x", ts.Create<IntType>(IntType::IntSize::Int32));
+  inner.Resolve<StructType>()->AddField("y", ts.Create<CharType>());
+
+  auto outer = ts.Create<StructType>("Outer");
+  outer.Resolve<StructType>()->AddField("c", ts.Create<CharType>());
+  outer.Resolve<StructType>()->AddField("inner", inner);
+
+  auto &innerLayout = layout.Get(inner);
+  auto &outerLayout = layout.Get(outer);
+
+  EXPECT_EQ(innerLayout.size, 8);
+  EXPECT_EQ(outerLayout.size, 12);
+  EXPECT_EQ(outerLayout.Field(1).offset, 4);
+  EXPECT_EQ(&layout.Get(inner), &innerLayout);
+}
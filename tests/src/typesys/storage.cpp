@@ -0,0 +1,54 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <typesys/type_system.hpp>
+
+using namespace aatbe::typesys;
+
+TEST(TypeStorage, DenseIdsPerSystem) {
+  TypeSystem a{};
+  TypeSystem b{};
+
+  auto a0 = a.Create<BoolType>();
+  auto a1 = a.Create<CharType>();
+  auto b0 = b.Create<CharType>();
+
+  EXPECT_EQ(a0.Value(), 0);
+  EXPECT_EQ(a1.Value(), 1);
+  EXPECT_EQ(b0.Value(), 0);
+  EXPECT_EQ(a.Count(), 2);
+  EXPECT_EQ(b.Count(), 1);
+}
+
+TEST(TypeStorage, KindCheckedResolve) {
+  TypeSystem ts{};
+
+  auto tid = ts.Create<IntType>(IntType::IntSize::Int16);
+
+  EXPECT_EQ(ts.GetType(tid)->Kind(), TypeKind::TyInt);
+  EXPECT_NE(tid.Resolve<IntType>(), nullptr);
+  EXPECT_EQ(tid.Resolve<FloatType>(), nullptr);
+  EXPECT_EQ(tid.Resolve<StructType>(), nullptr);
+}
+
+TEST(TypeStorage, ResolveSurvivesGrowth) {
+  TypeSystem ts{};
+
+  auto tid = ts.Create<StructType>("Test");
+  auto ty_struct = tid.Resolve<StructType>();
+
+  for (size_t i = 0; i < 1024; i++)
+    ts.Create<ArrayType>(tid, i);
+
+  EXPECT_EQ(tid.Resolve<StructType>(), ty_struct);
+  EXPECT_EQ(ts.Count(), 1025);
+}
+
+TEST(TypeStorage, OutOfRange) {
+  TypeSystem ts{};
+
+  EXPECT_THROW(ts.GetType(TypeId{&ts, 3}), std::out_of_range);
+}
@@ -0,0 +1,91 @@
+//
+// Created by chronium on 19.10.2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <typesys/unify.hpp>
+
+using namespace aatbe::typesys;
+
+TEST(Unifier, VarWithConcrete) {
+  TypeSystem ts{};
+  Unifier unifier(ts);
+
+  auto var = unifier.Fresh();
+  auto int32 = ts.Create<IntType>(IntType::IntSize::Int32);
+
+  EXPECT_TRUE(unifier.Unify(var, int32));
+  EXPECT_EQ(unifier.Resolve(var), int32);
+}
+
+TEST(Unifier, ChainsOfVars) {
+  TypeSystem ts{};
+  Unifier unifier(ts);
+
+  std::vector<TypeId> vars;
+  for (size_t i = 0; i < 64; i++)
+    vars.push_back(unifier.Fresh());
+  for (size_t i = 1; i < vars.size(); i++)
+    EXPECT_TRUE(unifier.Unify(vars[i - 1], vars[i]));
+
+  auto boolean = ts.Create<BoolType>();
+  EXPECT_TRUE(unifier.Unify(vars[32], boolean));
+
+  for (auto &var : vars)
+    EXPECT_EQ(unifier.Resolve(var), boolean);
+}
+
+TEST(Unifier, ConcreteMismatch) {
+  TypeSystem ts{};
+  Unifier unifier(ts);
+
+  auto int32 = ts.Create<IntType>(IntType::IntSize::Int32);
+  auto uint32 = ts.Create<IntType>(IntType::IntSize::Int32, false);
+
+  EXPECT_FALSE(unifier.Unify(int32, uint32));
+  EXPECT_TRUE(unifier.Unify(int32, ts.Create<IntType>(IntType::IntSize::Int32)));
+}
+
+TEST(Unifier, Structural) {
+  TypeSystem ts{};
+  Unifier unifier(ts);
+
+  auto var = unifier.Fresh();
+  auto chr = ts.Create<CharType>();
+
+  EXPECT_TRUE(unifier.Unify(ts.Create<PointerType>(var),
+                            ts.Create<PointerType>(chr)));
+  EXPECT_EQ(unifier.Resolve(var), chr);
+
+  auto elem = unifier.Fresh();
+  EXPECT_FALSE(unifier.Unify(ts.Create<ArrayType>(elem, 3),
+                             ts.Create<ArrayType>(chr, 4)));
+}
+
+TEST(Unifier, IntegerLiterals) {
+  TypeSystem ts{};
+  Unifier unifier(ts);
+
+  auto literal = unifier.Fresh(Unifier::VarClass::Integer);
+  EXPECT_EQ(unifier.Resolve(literal),
+            ts.Create<IntType>(IntType::IntSize::Int64));
+
+  auto other = unifier.Fresh(Unifier::VarClass::Integer);
+  EXPECT_FALSE(unifier.Unify(other, ts.Create<BoolType>()));
+
+  auto any = unifier.Fresh();
+  auto uint8 = ts.Create<IntType>(IntType::IntSize::Int8, false);
+  EXPECT_TRUE(unifier.Unify(any, other));
+  EXPECT_FALSE(unifier.Unify(any, ts.Create<CharType>()));
+  EXPECT_TRUE(unifier.Unify(any, uint8));
+  EXPECT_EQ(unifier.Resolve(other), uint8);
+}
+
+TEST(Unifier, OccursCheck) {
+  TypeSystem ts{};
+  Unifier unifier(ts);
+
+  auto var = unifier.Fresh();
+  EXPECT_FALSE(unifier.Unify(var, ts.Create<PointerType>(var)));
+}